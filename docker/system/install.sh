@@ -31,7 +31,7 @@ function install_googletest {
 # Get some packages from apt
 #
 apt-get update
-apt-get install -y cmake liblua5.2-dev libtclap-dev libjansson-dev ragel python-dev libre2-dev libyaml-cpp-dev curl git
+apt-get install -y cmake liblua5.2-dev libtclap-dev ragel python-dev libre2-dev libyaml-cpp-dev curl git
 
 # Access the package directory
 #
@@ -51,7 +51,7 @@ dump(tree::Value const& v)
   Hjson::Value result;
   for (auto const& e : w) {
     Hjson::Value value = Common::dump(*e.second);
-    result[e.first] = value;
+    result[e.first.str()] = value;
   }
   return result;
 }
@@ -21,90 +21,98 @@
  */
 
 #include "Common.h"
-#include "Array.h"
-#include "Object.h"
-#include "Primitive.h"
+#include "Reader.h"
+#include "Writer.h"
 #include <ace/common/Log.h>
+#include <ace/tree/Builder.h>
+#include <fcntl.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-namespace ace { namespace jsonfmt { namespace Common {
+namespace {
 
-tree::Value::Ref
-build(std::string const& name, json_t* const value)
+bool
+scan(const char* data, const size_t size, ace::tree::Handler& h)
 {
-  tree::Value::Ref result = nullptr;
-  switch (json_typeof(value)) {
-    case JSON_OBJECT: {
-      result = Object::build(name, value);
-    } break;
-    case JSON_ARRAY: {
-      result = Array::build(name, value);
-    } break;
-    case JSON_STRING:
-    case JSON_INTEGER:
-    case JSON_REAL:
-    case JSON_TRUE:
-    case JSON_FALSE: {
-      result = Primitive::build(name, value);
-    } break;
-    default: {
-    } break;
+  ace::jsonfmt::Reader reader(data, size);
+  if (not reader.parse(h)) {
+    ACE_LOG(Error, "load failed: ", reader.error());
+    return false;
   }
-  return result;
+  return true;
 }
 
-tree::Value::Ref
-parseFile(std::string const& path)
+ace::tree::Value::Ref
+build(bool (*scanner)(std::string const&, ace::tree::Handler&),
+      std::string const& s)
 {
-  json_error_t error;
-  json_t* item = json_load_file(path.c_str(), JSON_REJECT_DUPLICATES, &error);
-  if (item == nullptr) {
-    ACE_LOG(Error, "load failed: ", error.text);
+  ace::tree::Builder builder(true);
+  if (not scanner(s, builder)) {
     return nullptr;
   }
-  if (not json_is_object(item)) {
-    ACE_LOG(Error, "root item is not an object");
-    return nullptr;
+  return builder.value();
+}
+
+}
+
+namespace ace { namespace jsonfmt { namespace Common {
+
+bool
+scanFile(std::string const& path, tree::Handler& h)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    ACE_LOG(Error, "load failed: unable to open ", path);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ACE_LOG(Error, "load failed: unable to read ", path);
+    close(fd);
+    return false;
+  }
+  auto len = static_cast<size_t>(st.st_size);
+  if (len == 0) {
+    close(fd);
+    return scan("", 0, h);
   }
-  auto result = build("", item);
-  json_decref(item);
+  void* addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    ACE_LOG(Error, "load failed: unable to map ", path);
+    return false;
+  }
+  madvise(addr, len, MADV_SEQUENTIAL);
+  bool result = scan(static_cast<const char*>(addr), len, h);
+  munmap(addr, len);
   return result;
 }
 
+bool
+scanString(std::string const& str, tree::Handler& h)
+{
+  return scan(str.data(), str.size(), h);
+}
+
+tree::Value::Ref
+parseFile(std::string const& path)
+{
+  return build(scanFile, path);
+}
+
 tree::Value::Ref
 parseString(std::string const& str)
 {
-  json_error_t error;
-  json_t* item = json_loads(str.c_str(), JSON_REJECT_DUPLICATES, &error);
-  if (item == nullptr) {
-    ACE_LOG(Error, "load failed: ", error.text);
-    return nullptr;
-  }
-  if (not json_is_object(item)) {
-    ACE_LOG(Error, "root item is not an object");
-    return nullptr;
-  }
-  auto result = build("", item);
-  json_decref(item);
-  return result;
+  return build(scanString, str);
 }
 
-json_t*
-dump(tree::Value const& v)
+void
+dump(tree::Value const& v, const bool compact, std::ostream& o)
 {
-  switch (v.type()) {
-    case tree::Value::Type::Boolean:
-    case tree::Value::Type::Float:
-    case tree::Value::Type::Integer:
-    case tree::Value::Type::String:
-      return Primitive::dump(v);
-    case tree::Value::Type::Array:
-      return Array::dump(v);
-    case tree::Value::Type::Object:
-      return Object::dump(v);
-    default:
-      return nullptr;
-  }
+  Writer writer(o, compact);
+  writer.write(v);
 }
 
 }}}
@@ -22,18 +22,21 @@
 
 #pragma once
 
+#include <ace/tree/Handler.h>
 #include <ace/tree/Scanner.h>
+#include <ostream>
 #include <string>
-#include <jansson.h>
 
 namespace ace { namespace jsonfmt { namespace Common {
 
-tree::Value::Ref build(std::string const& name, json_t* const value);
+bool scanFile(std::string const& path, tree::Handler& h);
+
+bool scanString(std::string const& str, tree::Handler& h);
 
 tree::Value::Ref parseFile(std::string const& path);
 
 tree::Value::Ref parseString(std::string const& str);
 
-json_t* dump(tree::Value const& v);
+void dump(tree::Value const& v, const bool compact, std::ostream& o);
 
 }}}
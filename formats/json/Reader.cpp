@@ -0,0 +1,499 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Reader.h"
+#include <ace/common/Log.h>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const size_t MAX_DEPTH = 2048;
+
+/*
+ * Length of the run of plain characters at the head of a string: printable
+ * ASCII characters other than quotes and backslashes. With SSE2, the buffer
+ * is classified sixteen bytes at a time.
+ */
+size_t
+plain(const char* p, const char* e)
+{
+  const char* s = p;
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i slash = _mm_set1_epi8('\\');
+  const __m128i space = _mm_set1_epi8(' ');
+  while (e - p >= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i m =
+      _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash));
+    /*
+     * The signed comparison catches both control and non-ASCII characters.
+     */
+    m = _mm_or_si128(m, _mm_cmpgt_epi8(space, v));
+    int mask = _mm_movemask_epi8(m);
+    if (mask != 0) {
+      return static_cast<size_t>(p - s) + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p < e) {
+    auto c = static_cast<unsigned char>(*p);
+    if (c == '"' or c == '\\' or c < 0x20 or c >= 0x80) {
+      break;
+    }
+    p += 1;
+  }
+  return static_cast<size_t>(p - s);
+}
+
+/*
+ * Length of the UTF-8 sequence at the head of a buffer, 0 if it is invalid.
+ */
+size_t
+sequence(const char* p, const char* e)
+{
+  auto c = static_cast<unsigned char>(p[0]);
+  size_t n = 0;
+  uint32_t cp = 0;
+  if (c >= 0xC2 and c <= 0xDF) {
+    n = 2;
+    cp = c & 0x1F;
+  } else if (c >= 0xE0 and c <= 0xEF) {
+    n = 3;
+    cp = c & 0x0F;
+  } else if (c >= 0xF0 and c <= 0xF4) {
+    n = 4;
+    cp = c & 0x07;
+  } else {
+    return 0;
+  }
+  if (static_cast<size_t>(e - p) < n) {
+    return 0;
+  }
+  for (size_t i = 1; i < n; i += 1) {
+    auto b = static_cast<unsigned char>(p[i]);
+    if ((b & 0xC0) != 0x80) {
+      return 0;
+    }
+    cp = (cp << 6) | (b & 0x3F);
+  }
+  if ((n == 3 and cp < 0x800) or (n == 4 and cp < 0x10000) or
+      cp > 0x10FFFF or (cp >= 0xD800 and cp <= 0xDFFF)) {
+    return 0;
+  }
+  return n;
+}
+
+void
+encode(const uint32_t cp, std::string& s)
+{
+  if (cp < 0x80) {
+    s += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    s += static_cast<char>(0xC0 | (cp >> 6));
+    s += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    s += static_cast<char>(0xE0 | (cp >> 12));
+    s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    s += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    s += static_cast<char>(0xF0 | (cp >> 18));
+    s += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    s += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+bool
+hex(const char* p, const char* e, uint32_t& r)
+{
+  if (e - p < 4) {
+    return false;
+  }
+  r = 0;
+  for (int i = 0; i < 4; i += 1) {
+    char c = p[i];
+    r <<= 4;
+    if (c >= '0' and c <= '9') {
+      r |= static_cast<uint32_t>(c - '0');
+    } else if (c >= 'a' and c <= 'f') {
+      r |= static_cast<uint32_t>(c - 'a' + 10);
+    } else if (c >= 'A' and c <= 'F') {
+      r |= static_cast<uint32_t>(c - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+digit(const char* p, const char* e)
+{
+  return p < e and *p >= '0' and *p <= '9';
+}
+
+}
+
+namespace ace { namespace jsonfmt {
+
+Reader::Reader(const char* data, const size_t size)
+  : m_begin(data)
+  , m_cur(data)
+  , m_end(data + size)
+  , m_key()
+  , m_string()
+  , m_error()
+{}
+
+bool
+Reader::parse(tree::Handler& h)
+{
+  std::vector<char> stack;
+  std::string_view key;
+  bool member = false;
+  skip();
+  if (m_cur == m_end or *m_cur != '{') {
+    return fail("root item is not an object");
+  }
+  for (;;) {
+    /*
+     * Read the key of an object member.
+     */
+    if (member) {
+      skip();
+      if (m_cur == m_end or *m_cur != '"') {
+        return fail("string or '}' expected");
+      }
+      if (not string(m_key, key)) {
+        return false;
+      }
+      skip();
+      if (m_cur == m_end or *m_cur != ':') {
+        return fail("':' expected");
+      }
+      m_cur += 1;
+      member = false;
+    }
+    /*
+     * Read a value.
+     */
+    skip();
+    if (m_cur == m_end) {
+      return fail("premature end of input");
+    }
+    char c = *m_cur;
+    if (c == '{' or c == '[') {
+      if (stack.size() == MAX_DEPTH) {
+        return fail("maximum parsing depth reached");
+      }
+      if (not(c == '{' ? h.onObjectStart(key) : h.onArrayStart(key))) {
+        return fail("value rejected");
+      }
+      m_cur += 1;
+      skip();
+      if (m_cur < m_end and *m_cur == (c == '{' ? '}' : ']')) {
+        m_cur += 1;
+        if (not h.onEnd()) {
+          return fail("value rejected");
+        }
+      } else {
+        stack.push_back(c);
+        key = std::string_view();
+        member = c == '{';
+        continue;
+      }
+    } else if (c == '"') {
+      std::string_view v;
+      if (not string(m_string, v)) {
+        return false;
+      }
+      if (not h.onString(key, v)) {
+        return fail("value rejected");
+      }
+    } else if (c == '-' or (c >= '0' and c <= '9')) {
+      if (not number(key, h)) {
+        return false;
+      }
+    } else if (not literal(key, h)) {
+      return false;
+    }
+    /*
+     * Close the containers completed by the value, or move to the next one.
+     */
+    for (;;) {
+      skip();
+      if (stack.empty()) {
+        return m_cur == m_end or fail("end of file expected");
+      }
+      if (m_cur == m_end) {
+        return fail("premature end of input");
+      }
+      bool obj = stack.back() == '{';
+      if (*m_cur == ',') {
+        m_cur += 1;
+        key = std::string_view();
+        member = obj;
+        break;
+      }
+      if (*m_cur != (obj ? '}' : ']')) {
+        return fail(obj ? "'}' expected" : "']' expected");
+      }
+      m_cur += 1;
+      stack.pop_back();
+      if (not h.onEnd()) {
+        return fail("value rejected");
+      }
+    }
+  }
+}
+
+std::string const&
+Reader::error() const
+{
+  return m_error;
+}
+
+bool
+Reader::string(std::string& s, std::string_view& r)
+{
+  const char* start = ++m_cur;
+  const char* seg = start;
+  bool copied = false;
+  for (;;) {
+    m_cur += plain(m_cur, m_end);
+    if (m_cur == m_end) {
+      return fail("premature end of input in string");
+    }
+    auto c = static_cast<unsigned char>(*m_cur);
+    if (c == '"') {
+      if (copied) {
+        s.append(seg, m_cur);
+        r = s;
+      } else {
+        r = std::string_view(start, static_cast<size_t>(m_cur - start));
+      }
+      m_cur += 1;
+      return true;
+    }
+    if (c >= 0x80) {
+      size_t n = sequence(m_cur, m_end);
+      if (n == 0) {
+        return fail("invalid UTF-8 in string");
+      }
+      m_cur += n;
+      continue;
+    }
+    if (c != '\\') {
+      return fail("control character in string");
+    }
+    if (not copied) {
+      s.clear();
+      copied = true;
+    }
+    s.append(seg, m_cur);
+    m_cur += 1;
+    if (not escape(s)) {
+      return false;
+    }
+    seg = m_cur;
+  }
+}
+
+bool
+Reader::escape(std::string& s)
+{
+  if (m_cur == m_end) {
+    return fail("premature end of input in string");
+  }
+  char c = *m_cur++;
+  switch (c) {
+    case '"':
+    case '\\':
+    case '/':
+      s += c;
+      return true;
+    case 'b':
+      s += '\b';
+      return true;
+    case 'f':
+      s += '\f';
+      return true;
+    case 'n':
+      s += '\n';
+      return true;
+    case 'r':
+      s += '\r';
+      return true;
+    case 't':
+      s += '\t';
+      return true;
+    case 'u': {
+      uint32_t cp = 0, lo = 0;
+      if (not hex(m_cur, m_end, cp)) {
+        return fail("invalid escape");
+      }
+      m_cur += 4;
+      if (cp >= 0xD800 and cp <= 0xDBFF) {
+        if (m_end - m_cur < 6 or m_cur[0] != '\\' or m_cur[1] != 'u' or
+            not hex(m_cur + 2, m_end, lo) or lo < 0xDC00 or lo > 0xDFFF) {
+          return fail("invalid Unicode surrogate pair");
+        }
+        m_cur += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+      } else if (cp >= 0xDC00 and cp <= 0xDFFF) {
+        return fail("invalid Unicode surrogate pair");
+      } else if (cp == 0) {
+        return fail("\\u0000 is not allowed");
+      }
+      encode(cp, s);
+      return true;
+    }
+    default:
+      return fail("invalid escape");
+  }
+}
+
+bool
+Reader::number(std::string_view k, tree::Handler& h)
+{
+  const char* start = m_cur;
+  bool real = false;
+  if (*m_cur == '-') {
+    m_cur += 1;
+  }
+  if (m_cur < m_end and *m_cur == '0') {
+    m_cur += 1;
+  } else if (digit(m_cur, m_end)) {
+    while (digit(m_cur, m_end)) {
+      m_cur += 1;
+    }
+  } else {
+    return fail("invalid number");
+  }
+  if (m_cur < m_end and *m_cur == '.') {
+    real = true;
+    m_cur += 1;
+    if (not digit(m_cur, m_end)) {
+      return fail("invalid number");
+    }
+    while (digit(m_cur, m_end)) {
+      m_cur += 1;
+    }
+  }
+  if (m_cur < m_end and (*m_cur == 'e' or *m_cur == 'E')) {
+    real = true;
+    m_cur += 1;
+    if (m_cur < m_end and (*m_cur == '+' or *m_cur == '-')) {
+      m_cur += 1;
+    }
+    if (not digit(m_cur, m_end)) {
+      return fail("invalid number");
+    }
+    while (digit(m_cur, m_end)) {
+      m_cur += 1;
+    }
+  }
+  if (not real) {
+    long v = 0;
+    if (std::from_chars(start, m_cur, v).ec != std::errc()) {
+      return fail("too big integer");
+    }
+    return h.onInteger(k, v) or fail("value rejected");
+  }
+  double v = 0;
+  if (std::from_chars(start, m_cur, v).ec != std::errc()) {
+    /*
+     * Underflows are rounded, only overflows are rejected.
+     */
+    v = std::strtod(std::string(start, m_cur).c_str(), nullptr);
+    if (std::isinf(v)) {
+      return fail("real number overflow");
+    }
+  }
+  return h.onFloat(k, v) or fail("value rejected");
+}
+
+bool
+Reader::literal(std::string_view k, tree::Handler& h)
+{
+  auto match = [this](std::string_view w) {
+    if (static_cast<size_t>(m_end - m_cur) >= w.size() and
+        std::string_view(m_cur, w.size()) == w) {
+      m_cur += w.size();
+      return true;
+    }
+    return false;
+  };
+  if (match("true")) {
+    return h.onBoolean(k, true) or fail("value rejected");
+  }
+  if (match("false")) {
+    return h.onBoolean(k, false) or fail("value rejected");
+  }
+  if (match("null")) {
+    ACE_LOG(Error, "skipping unsupported null value for key: ", k);
+    return true;
+  }
+  return fail("invalid token");
+}
+
+bool
+Reader::fail(std::string const& m)
+{
+  size_t line = 1;
+  const char* bol = m_begin;
+  for (const char* p = m_begin; p < m_cur; p += 1) {
+    if (*p == '\n') {
+      line += 1;
+      bol = p + 1;
+    }
+  }
+  m_error = m + " near line " + std::to_string(line) + ", column " +
+            std::to_string(m_cur - bol + 1);
+  return false;
+}
+
+void
+Reader::skip()
+{
+  while (m_cur < m_end) {
+    char c = *m_cur;
+    if (c != ' ' and c != '\n' and c != '\r' and c != '\t') {
+      break;
+    }
+    m_cur += 1;
+  }
+}
+
+}}
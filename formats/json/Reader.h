@@ -20,43 +20,44 @@
  * SOFTWARE.
  */
 
-#include "Array.h"
-#include "Common.h"
-#include <ace/common/Log.h>
-#include <ace/common/String.h>
-#include <ace/tree/Array.h> // NOLINT
+#pragma once
+
+#include <ace/tree/Handler.h>
+#include <cstddef>
 #include <string>
+#include <string_view>
 
-namespace ace { namespace jsonfmt { namespace Array {
+namespace ace { namespace jsonfmt {
 
-tree::Value::Ref
-build(std::string const& name, json_t* const ary)
-{
-  tree::Array::Ref array = tree::Array::build(name);
-  size_t index = 0;
-  json_t* value = nullptr;
-  json_array_foreach(ary, index, value)
-  {
-    tree::Value::Ref v = Common::build(std::to_string(index), value);
-    if (v == nullptr) {
-      ACE_LOG(Error, "skipping unsupported value format at index: ", index);
-    } else {
-      array->push_back(v);
-    }
-  }
-  return array;
-}
-
-json_t*
-dump(tree::Value const& v)
+/**
+ * JSON reader emitting the content of a buffer to a handler as it parses it.
+ * Keys and strings without escape sequences are passed as views on the
+ * buffer. The root of the document must be an object.
+ */
+class Reader
 {
-  tree::Array const& ary = static_cast<tree::Array const&>(v);
-  json_t* result = json_array();
-  for (auto const& e : ary) {
-    json_t* value = Common::dump(*e);
-    json_array_append_new(result, value);
-  }
-  return result;
-}
-
-}}}
+public:
+  Reader() = delete;
+  Reader(const char* data, const size_t size);
+
+  bool parse(tree::Handler& h);
+
+  std::string const& error() const;
+
+private:
+  bool string(std::string& s, std::string_view& r);
+  bool escape(std::string& s);
+  bool number(std::string_view k, tree::Handler& h);
+  bool literal(std::string_view k, tree::Handler& h);
+  bool fail(std::string const& m);
+  void skip();
+
+  const char* m_begin;
+  const char* m_cur;
+  const char* m_end;
+  std::string m_key;
+  std::string m_string;
+  std::string m_error;
+};
+
+}}
@@ -22,7 +22,6 @@
 
 #include "Scanner.h"
 #include "Common.h"
-#include "Object.h"
 #include <ace/common/Log.h>
 #include <ace/common/String.h>
 #include <ace/engine/Master.h>
@@ -43,22 +42,16 @@ Scanner::parse(std::string const& s, int argc, char** argv)
   return Common::parseString(s);
 }
 
+bool
+Scanner::scan(std::string const& fn, int argc, char** argv, tree::Handler& h)
+{
+  return Common::scanFile(fn, h);
+}
+
 void
 Scanner::dump(tree::Value const& v, const Format f, std::ostream& o) const
 {
-  char* data = nullptr;
-  json_t* result = Common::dump(v);
-  switch (f) {
-    case tree::Scanner::Format::Compact: {
-      data = json_dumps(result, JSON_COMPACT);
-    } break;
-    case tree::Scanner::Format::Default: {
-      data = json_dumps(result, JSON_INDENT(2));
-    } break;
-  }
-  json_decref(result);
-  o << data;
-  free(data);
+  Common::dump(v, f == tree::Scanner::Format::Compact, o);
 }
 
 bool
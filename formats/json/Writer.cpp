@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Writer.h"
+#include <ace/tree/Array.h>
+#include <ace/tree/Object.h>
+#include <ace/tree/Primitive.h>
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <string_view>
+
+namespace {
+
+const size_t BUFFER_SIZE = 64 * 1024;
+
+}
+
+namespace ace { namespace jsonfmt {
+
+Writer::Writer(std::ostream& o, const bool compact)
+  : m_out(o), m_compact(compact), m_buffer()
+{
+  m_buffer.reserve(BUFFER_SIZE + 256);
+}
+
+void
+Writer::write(tree::Value const& v)
+{
+  value(v, 0);
+  flush();
+}
+
+void
+Writer::value(tree::Value const& v, const int l)
+{
+  if (m_buffer.size() >= BUFFER_SIZE) {
+    flush();
+  }
+  switch (v.type()) {
+    case tree::Value::Type::Object: {
+      tree::Object const& o = static_cast<tree::Object const&>(v);
+      if (o.size() == 0) {
+        m_buffer += "{}";
+        break;
+      }
+      m_buffer += '{';
+      bool first = true;
+      for (auto const& e : o) {
+        if (not first) {
+          m_buffer += ',';
+        }
+        first = false;
+        newline(l + 1);
+        string(e.first.str());
+        m_buffer += m_compact ? ":" : ": ";
+        value(*e.second, l + 1);
+      }
+      newline(l);
+      m_buffer += '}';
+    } break;
+    case tree::Value::Type::Array: {
+      tree::Array const& a = static_cast<tree::Array const&>(v);
+      if (a.size() == 0) {
+        m_buffer += "[]";
+        break;
+      }
+      m_buffer += '[';
+      bool first = true;
+      for (auto const& e : a) {
+        if (not first) {
+          m_buffer += ',';
+        }
+        first = false;
+        newline(l + 1);
+        value(*e, l + 1);
+      }
+      newline(l);
+      m_buffer += ']';
+    } break;
+    case tree::Value::Type::Boolean: {
+      tree::Primitive const& p = static_cast<tree::Primitive const&>(v);
+      m_buffer += p.value<bool>() ? "true" : "false";
+    } break;
+    case tree::Value::Type::Integer: {
+      tree::Primitive const& p = static_cast<tree::Primitive const&>(v);
+      char buf[32];
+      auto res = std::to_chars(buf, buf + sizeof(buf), p.value<long>());
+      m_buffer.append(buf, res.ptr);
+    } break;
+    case tree::Value::Type::Float: {
+      tree::Primitive const& p = static_cast<tree::Primitive const&>(v);
+      double d = p.value<double>();
+      if (not std::isfinite(d)) {
+        m_buffer += "null";
+        break;
+      }
+      char buf[64];
+      auto res = std::to_chars(buf, buf + sizeof(buf), d);
+      m_buffer.append(buf, res.ptr);
+      /*
+       * Keep the value a real number when it is read again.
+       */
+      if (std::string_view(buf, res.ptr - buf).find_first_of(".e") ==
+          std::string_view::npos) {
+        m_buffer += ".0";
+      }
+    } break;
+    case tree::Value::Type::String: {
+      tree::Primitive const& p = static_cast<tree::Primitive const&>(v);
+      string(p.value<std::string>());
+    } break;
+    default:
+      m_buffer += "null";
+      break;
+  }
+}
+
+void
+Writer::string(std::string const& s)
+{
+  static const char* digits = "0123456789ABCDEF";
+  m_buffer += '"';
+  size_t seg = 0;
+  for (size_t i = 0; i < s.size(); i += 1) {
+    auto c = static_cast<unsigned char>(s[i]);
+    if (c >= 0x20 and c != '"' and c != '\\') {
+      continue;
+    }
+    m_buffer.append(s, seg, i - seg);
+    seg = i + 1;
+    switch (c) {
+      case '"':
+        m_buffer += "\\\"";
+        break;
+      case '\\':
+        m_buffer += "\\\\";
+        break;
+      case '\b':
+        m_buffer += "\\b";
+        break;
+      case '\f':
+        m_buffer += "\\f";
+        break;
+      case '\n':
+        m_buffer += "\\n";
+        break;
+      case '\r':
+        m_buffer += "\\r";
+        break;
+      case '\t':
+        m_buffer += "\\t";
+        break;
+      default:
+        m_buffer += "\\u00";
+        m_buffer += digits[c >> 4];
+        m_buffer += digits[c & 0xF];
+        break;
+    }
+  }
+  m_buffer.append(s, seg, std::string::npos);
+  m_buffer += '"';
+}
+
+void
+Writer::newline(const int l)
+{
+  if (not m_compact) {
+    m_buffer += '\n';
+    m_buffer.append(static_cast<size_t>(2 * l), ' ');
+  }
+}
+
+void
+Writer::flush()
+{
+  m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+  m_buffer.clear();
+}
+
+}}
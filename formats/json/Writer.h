@@ -22,14 +22,33 @@
 
 #pragma once
 
-#include <ace/tree/Scanner.h>
+#include <ace/tree/Value.h>
+#include <ostream>
 #include <string>
-#include <jansson.h>
 
-namespace ace { namespace jsonfmt { namespace Object {
+namespace ace { namespace jsonfmt {
 
-tree::Value::Ref build(std::string const& name, json_t* const value);
+/**
+ * JSON writer streaming a tree to an output stream through a fixed-size
+ * buffer.
+ */
+class Writer
+{
+public:
+  Writer() = delete;
+  Writer(std::ostream& o, const bool compact);
+
+  void write(tree::Value const& v);
+
+private:
+  void value(tree::Value const& v, const int l);
+  void string(std::string const& s);
+  void newline(const int l);
+  void flush();
 
-json_t* dump(tree::Value const& v);
+  std::ostream& m_out;
+  bool m_compact;
+  std::string m_buffer;
+};
 
-}}}
+}}
@@ -0,0 +1,453 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Pool.h"
+#include <ace/common/String.h>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const char* SANDBOX = "ace.sandbox";
+
+/*
+ * Functions and libraries exposed to the configurations. Loading code, the
+ * file system, the debug library and the package system are left out.
+ */
+
+const char* GLOBALS[] = {
+  "_VERSION", "assert", "error",    "getmetatable", "ipairs",   "next",
+  "pairs",    "pcall",  "print",    "rawequal",     "rawget",   "rawlen",
+  "rawset",   "select", "setmetatable", "tonumber", "tostring", "type",
+  "unpack",   "xpcall"
+};
+
+const char* LIBRARIES[] = { "bit32", "coroutine", "math", "string", "table" };
+
+const char* OS[] = { "clock", "date", "difftime", "getenv", "time" };
+
+/*
+ * Number of instructions between two interruptions once the instruction limit
+ * is exceeded.
+ */
+
+const int REPEAT = 64;
+
+/*
+ * The memory used by a state, its limit while a configuration runs, and
+ * whether the configuration exceeded its instruction limit.
+ */
+struct Usage
+{
+  size_t used;
+  size_t limit;
+  bool exceeded;
+};
+
+void*
+allocate(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+  Usage* u = static_cast<Usage*>(ud);
+  size_t prev = ptr == nullptr ? 0 : osize;
+  if (nsize == 0) {
+    u->used -= prev;
+    free(ptr);
+    return nullptr;
+  }
+  if (u->limit != 0 and nsize > prev and u->used + nsize - prev > u->limit) {
+    return nullptr;
+  }
+  void* res = realloc(ptr, nsize);
+  if (res != nullptr) {
+    u->used = u->used - prev + nsize;
+  }
+  return res;
+}
+
+Usage*
+usageOf(lua_State* L)
+{
+  Usage* usage = nullptr;
+  lua_getallocf(L, reinterpret_cast<void**>(&usage));
+  return usage;
+}
+
+int
+panic(lua_State* L)
+{
+  std::cerr << "-- PANIC: " << lua_tostring(L, -1) << std::endl;
+  return 0;
+}
+
+/*
+ * A configuration may catch the error raised when it exceeds its instruction
+ * limit, with pcall, xpcall or coroutine.resume. The limit is thus sticky: the
+ * state is then interrupted every few instructions, and the sandboxed versions
+ * of these functions raise the error again when they return.
+ */
+
+void
+interrupt(lua_State* L, lua_Debug* ar)
+{
+  Usage* usage = usageOf(L);
+  if (not usage->exceeded) {
+    usage->exceeded = true;
+    lua_sethook(L, interrupt, LUA_MASKCOUNT, REPEAT);
+  }
+  luaL_error(L, "instruction limit exceeded");
+}
+
+/*
+ * Return the results of the guarded function, unless the limit was exceeded.
+ * It is also the continuation of the call when the function yields, so that
+ * the check still happens once the coroutine is resumed.
+ */
+int
+finish(lua_State* L)
+{
+  if (usageOf(L)->exceeded) {
+    return luaL_error(L, "instruction limit exceeded");
+  }
+  return lua_gettop(L);
+}
+
+/*
+ * Call the function in the upvalue with the arguments.
+ */
+int
+guard(lua_State* L)
+{
+  int n = lua_gettop(L);
+  lua_pushvalue(L, lua_upvalueindex(1));
+  lua_insert(L, 1);
+  lua_callk(L, n, LUA_MULTRET, 0, finish);
+  return finish(L);
+}
+
+/*
+ * Replace a function of the table at the top of the stack by its guard.
+ */
+void
+guarded(lua_State* L, const char* n)
+{
+  lua_getfield(L, -1, n);
+  lua_pushcclosure(L, guard, 1);
+  lua_setfield(L, -2, n);
+}
+
+void
+report_errors(lua_State* L)
+{
+  const char* str = lua_tostring(L, -1);
+  std::cerr << "-- " << (str == nullptr ? "unknown error" : str) << std::endl;
+  lua_pop(L, 1);
+}
+
+size_t
+fromEnvironment(const char* name, const size_t def)
+{
+  const char* env = getenv(name);
+  if (env == nullptr or not ace::common::String::is<long>(env)) {
+    return def;
+  }
+  long value = ace::common::String::value<long>(env);
+  return value < 0 ? def : static_cast<size_t>(value);
+}
+
+/*
+ * Copy the entries of the table at the top of the stack into a new table,
+ * pushed on the stack.
+ */
+void
+copy(lua_State* L)
+{
+  lua_newtable(L);
+  lua_pushnil(L);
+  while (lua_next(L, -3) != 0) {
+    lua_pushvalue(L, -2);
+    lua_insert(L, -2);
+    lua_rawset(L, -4);
+  }
+}
+
+}
+
+namespace ace { namespace luafmt {
+
+Pool::Lease::Lease() : m_state(Pool::get().acquire()), m_reuse(true) {}
+
+Pool::Lease::~Lease()
+{
+  Pool::get().release(m_state, m_reuse);
+}
+
+lua_State*
+Pool::Lease::state() const
+{
+  return m_state;
+}
+
+/*
+ * The environment is built from the sandbox template. The libraries are
+ * copied, so that a configuration cannot alter them for the next ones.
+ */
+
+bool
+Pool::Lease::run(int argc, char** argv)
+{
+  lua_State* L = m_state;
+  lua_newtable(L);
+  lua_getfield(L, LUA_REGISTRYINDEX, SANDBOX);
+  lua_pushnil(L);
+  while (lua_next(L, -2) != 0) {
+    if (lua_istable(L, -1)) {
+      copy(L);
+      lua_remove(L, -2);
+    }
+    lua_pushvalue(L, -2);
+    lua_insert(L, -2);
+    lua_rawset(L, -5);
+  }
+  lua_pop(L, 1);
+  lua_pushvalue(L, -1);
+  lua_setfield(L, -2, "_G");
+  lua_newtable(L);
+  for (int i = 0; i < argc; i += 1) {
+    lua_pushstring(L, argv[i]);
+    lua_rawseti(L, -2, i);
+  }
+  lua_setfield(L, -2, "arg");
+  /*
+   * Install the environment as the _ENV upvalue of the chunk.
+   */
+  lua_pushvalue(L, -1);
+  if (lua_setupvalue(L, -3, 1) == nullptr) {
+    lua_pop(L, 1);
+  }
+  lua_insert(L, -2);
+  /*
+   * Run the chunk within the limits.
+   */
+  Pool& pool = Pool::get();
+  Usage* usage = usageOf(L);
+  size_t memory = pool.memoryLimit();
+  if (memory != 0) {
+    usage->limit = usage->used + memory;
+  }
+  size_t count = pool.instructionLimit();
+  if (count != 0) {
+    lua_sethook(L, interrupt, LUA_MASKCOUNT,
+                count > INT_MAX ? INT_MAX : static_cast<int>(count));
+  }
+  int res = lua_pcall(L, 0, 0, 0);
+  lua_sethook(L, nullptr, 0, 0);
+  usage->limit = 0;
+  if (res != 0) {
+    report_errors(L);
+    m_reuse = false;
+    return false;
+  }
+  if (usage->exceeded) {
+    std::cerr << "-- instruction limit exceeded" << std::endl;
+    m_reuse = false;
+    return false;
+  }
+  return true;
+}
+
+Pool::Pool()
+  : m_states()
+  , m_capacity(fromEnvironment("ACE_LUA_POOL_SIZE", 16))
+  , m_instructionLimit(0)
+  , m_memoryLimit(0)
+  , m_lock()
+{
+  pthread_mutex_init(&m_lock, nullptr);
+}
+
+Pool::~Pool()
+{
+  for (auto L : m_states) {
+    destroy(L);
+  }
+  pthread_mutex_destroy(&m_lock);
+}
+
+void
+Pool::setCapacity(const size_t n)
+{
+  pthread_mutex_lock(&m_lock);
+  m_capacity = n;
+  while (m_states.size() > m_capacity) {
+    destroy(m_states.back());
+    m_states.pop_back();
+  }
+  pthread_mutex_unlock(&m_lock);
+}
+
+void
+Pool::setInstructionLimit(const size_t n)
+{
+  m_instructionLimit = n;
+}
+
+void
+Pool::setMemoryLimit(const size_t n)
+{
+  m_memoryLimit = n;
+}
+
+size_t
+Pool::capacity() const
+{
+  return m_capacity;
+}
+
+/*
+ * The limits are read from the environment each time a configuration runs,
+ * and default to the values set on the pool.
+ */
+
+size_t
+Pool::instructionLimit() const
+{
+  return fromEnvironment("ACE_LUA_INSTRUCTION_LIMIT", m_instructionLimit);
+}
+
+size_t
+Pool::memoryLimit() const
+{
+  return fromEnvironment("ACE_LUA_MEMORY_LIMIT", m_memoryLimit);
+}
+
+Pool&
+Pool::get()
+{
+  static Pool s_pool;
+  return s_pool;
+}
+
+lua_State*
+Pool::acquire()
+{
+  lua_State* L = nullptr;
+  pthread_mutex_lock(&m_lock);
+  if (not m_states.empty()) {
+    L = m_states.back();
+    m_states.pop_back();
+  }
+  pthread_mutex_unlock(&m_lock);
+  return L != nullptr ? L : create();
+}
+
+/*
+ * A state is reset before it goes back to the pool: its stack is cleared and
+ * the garbage of the last configuration is collected. A state in which a
+ * configuration failed is closed instead.
+ */
+
+void
+Pool::release(lua_State* L, const bool reuse)
+{
+  if (L == nullptr) {
+    return;
+  }
+  lua_settop(L, 0);
+  if (reuse) {
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    pthread_mutex_lock(&m_lock);
+    if (m_states.size() < m_capacity) {
+      m_states.push_back(L);
+      L = nullptr;
+    }
+    pthread_mutex_unlock(&m_lock);
+  }
+  if (L != nullptr) {
+    destroy(L);
+  }
+}
+
+lua_State*
+Pool::create()
+{
+  Usage* usage = new Usage{ 0, 0, false };
+  lua_State* L = lua_newstate(allocate, usage);
+  if (L == nullptr) {
+    delete usage;
+    return nullptr;
+  }
+  lua_atpanic(L, panic);
+  luaL_openlibs(L);
+  /*
+   * Hide the metatable of strings, as it holds the original string library.
+   */
+  lua_pushliteral(L, "");
+  if (lua_getmetatable(L, -1) != 0) {
+    lua_pushboolean(L, 0);
+    lua_setfield(L, -2, "__metatable");
+    lua_pop(L, 1);
+  }
+  lua_pop(L, 1);
+  /*
+   * Build the sandbox template.
+   */
+  lua_newtable(L);
+  for (auto n : GLOBALS) {
+    lua_getglobal(L, n);
+    lua_setfield(L, -2, n);
+  }
+  for (auto n : LIBRARIES) {
+    lua_getglobal(L, n);
+    lua_setfield(L, -2, n);
+  }
+  lua_newtable(L);
+  lua_getglobal(L, "os");
+  if (lua_istable(L, -1)) {
+    for (auto n : OS) {
+      lua_getfield(L, -1, n);
+      lua_setfield(L, -3, n);
+    }
+  }
+  lua_pop(L, 1);
+  lua_setfield(L, -2, "os");
+  guarded(L, "pcall");
+  guarded(L, "xpcall");
+  lua_getfield(L, -1, "coroutine");
+  copy(L);
+  guarded(L, "resume");
+  lua_setfield(L, -3, "coroutine");
+  lua_pop(L, 1);
+  lua_setfield(L, LUA_REGISTRYINDEX, SANDBOX);
+  return L;
+}
+
+void
+Pool::destroy(lua_State* L)
+{
+  Usage* usage = usageOf(L);
+  lua_close(L);
+  delete usage;
+}
+
+}}
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <pthread.h>
+
+extern "C" {
+#include <lauxlib.h>
+#include <lua.h>
+#include <lualib.h>
+}
+
+namespace ace { namespace luafmt {
+
+/**
+ * @brief A pool of sandboxed LUA states shared by the scanner calls
+ *
+ * States are created on demand and kept for reuse once released, up to the
+ * pool capacity. Each configuration runs in its own environment, built from a
+ * safe subset of the standard libraries, and can be bounded in instructions
+ * and in memory. The capacity is read from the ACE_LUA_POOL_SIZE environment
+ * variable. The limits are read from the ACE_LUA_INSTRUCTION_LIMIT and
+ * ACE_LUA_MEMORY_LIMIT environment variables when a configuration runs, and
+ * default to the values set on the pool. A limit of 0 disables it.
+ */
+class Pool
+{
+public:
+  /**
+   * @brief A state borrowed from the pool for the duration of a scope
+   */
+  class Lease
+  {
+  public:
+    Lease();
+    ~Lease();
+
+    Lease(Lease const&) = delete;
+    Lease& operator=(Lease const&) = delete;
+
+    lua_State* state() const;
+
+    /**
+     * @brief Run the chunk at the top of the stack in a fresh environment
+     * @return true in case of success, false otherwise
+     *
+     * The arguments are made available in the "arg" table of the environment.
+     * In case of success, the environment is left at the top of the stack.
+     * Otherwise, the error is reported and the state is not reused.
+     */
+    bool run(int argc, char** argv);
+
+  private:
+    lua_State* m_state;
+    bool m_reuse;
+  };
+
+  ~Pool();
+
+  void setCapacity(const size_t n);
+  void setInstructionLimit(const size_t n);
+  void setMemoryLimit(const size_t n);
+
+  size_t capacity() const;
+  size_t instructionLimit() const;
+  size_t memoryLimit() const;
+
+  static Pool& get();
+
+private:
+  Pool();
+
+  lua_State* acquire();
+  void release(lua_State* L, const bool reuse);
+
+  static lua_State* create();
+  static void destroy(lua_State* L);
+
+  std::vector<lua_State*> m_states;
+  size_t m_capacity;
+  size_t m_instructionLimit;
+  size_t m_memoryLimit;
+  mutable pthread_mutex_t m_lock;
+};
+
+}}
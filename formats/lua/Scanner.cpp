@@ -23,6 +23,7 @@
 #include "Scanner.h"
 #include "Common.h"
 #include "Object.h"
+#include "Pool.h"
 #include <ace/common/Log.h>
 #include <ace/common/String.h>
 #include <ace/engine/Master.h>
@@ -41,17 +42,6 @@ report_errors(lua_State* L)
   lua_pop(L, 1);
 }
 
-static void
-build_args(lua_State* L, int argc, char** argv)
-{
-  lua_newtable(L);
-  for (int i = 0; i < argc; i += 1) {
-    lua_pushstring(L, argv[i]);
-    lua_rawseti(L, -2, i);
-  }
-  lua_setglobal(L, "arg");
-}
-
 }
 
 namespace ace { namespace luafmt {
@@ -63,30 +53,26 @@ Scanner::open(std::string const& fn, int argc, char** argv)
     ACE_LOG(Error, "invalid ARGC/ARGV arguments");
     return nullptr;
   }
-  tree::Value::Ref obj;
-  lua_State* L = luaL_newstate();
-  luaL_openlibs(L);
+  Pool::Lease lease;
+  lua_State* L = lease.state();
+  if (L == nullptr) {
+    ACE_LOG(Error, "cannot create a LUA state");
+    return nullptr;
+  }
   shift(fn, argc, argv);
-  build_args(L, argc, argv);
   if (luaL_loadfile(L, fn.c_str()) != 0) {
     report_errors(L);
-    goto error;
+    return nullptr;
   }
-  if (lua_pcall(L, 0, LUA_MULTRET, 0) != 0) {
-    report_errors(L);
-    goto error;
+  if (not lease.run(argc, argv)) {
+    return nullptr;
   }
-  lua_getglobal(L, "config");
+  lua_getfield(L, -1, "config");
   if (!lua_istable(L, -1)) {
     ACE_LOG(Error, "no \"config\" dictionary found in \"", fn, "\"");
-    goto error;
+    return nullptr;
   }
-
-  obj = Object::build("", L);
-  lua_pop(L, 1);
-
-error:
-  return obj;
+  return Object::build("", L);
 }
 
 tree::Value::Ref
@@ -96,30 +82,27 @@ Scanner::parse(std::string const& s, int argc, char** argv)
     ACE_LOG(Error, "invalid ARGC/ARGV arguments");
     return nullptr;
   }
-  tree::Value::Ref obj;
-  lua_State* L = luaL_newstate();
-  luaL_openlibs(L);
-  shift("", argc, argv);
-  build_args(L, argc, argv);
+  Pool::Lease lease;
+  lua_State* L = lease.state();
+  if (L == nullptr) {
+    ACE_LOG(Error, "cannot create a LUA state");
+    return nullptr;
+  }
+  std::string fn;
+  shift(fn, argc, argv);
   if (luaL_loadstring(L, s.c_str()) != 0) {
     report_errors(L);
-    goto error;
+    return nullptr;
   }
-  if (lua_pcall(L, 0, LUA_MULTRET, 0) != 0) {
-    report_errors(L);
-    goto error;
+  if (not lease.run(argc, argv)) {
+    return nullptr;
   }
-  lua_getglobal(L, "config");
+  lua_getfield(L, -1, "config");
   if (!lua_istable(L, -1)) {
     ACE_LOG(Error, "no \"config\" dictionary found in inline LUA");
-    goto error;
+    return nullptr;
   }
-
-  obj = Object::build("", L);
-  lua_pop(L, 1);
-
-error:
-  return obj;
+  return Object::build("", L);
 }
 
 void
@@ -33,8 +33,9 @@ build(std::string const& n, PyObject* o)
 {
   tree::Array::Ref array = tree::Array::build(n);
   tree::Value::Ref v(nullptr);
-  for (Py_ssize_t i = 0; i < PyList_Size(o); i += 1) {
-    v = build_value("", PyList_GetItem(o, i));
+  Py_ssize_t len = PyList_GET_SIZE(o);
+  for (Py_ssize_t i = 0; i < len; i += 1) {
+    v = build_value("", PyList_GET_ITEM(o, i));
     if (v.get() != nullptr) {
       array->push_back(v);
     } else {
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Interpreter.h"
+#include <cstdlib>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*
+ * The configurations share sys.argv, sys.path and sys.modules. The GIL may be
+ * handed over to another thread in the middle of a configuration, so they are
+ * also run one at a time.
+ */
+pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Modules that come with the Python installation are kept loaded across
+ * configurations. Only the others, like the helpers next to a configuration,
+ * are unloaded.
+ */
+bool
+isInstalled(PyObject* module, std::vector<std::string> const& prefixes)
+{
+  PyObject* file = PyObject_GetAttrString(module, "__file__");
+  if (file == nullptr) {
+    PyErr_Clear();
+    return true;
+  }
+  bool result = true;
+  const char* str = PyUnicode_Check(file) ? PyUnicode_AsUTF8(file) : nullptr;
+  if (str != nullptr) {
+    std::string fn(str);
+    result = false;
+    for (auto& p : prefixes) {
+      if (not p.empty() and fn.compare(0, p.length(), p) == 0) {
+        result = true;
+        break;
+      }
+    }
+  }
+  Py_DECREF(file);
+  PyErr_Clear();
+  return result;
+}
+
+std::vector<std::string>
+installPrefixes()
+{
+  std::vector<std::string> result;
+  const char* names[] = { "prefix", "base_prefix", "exec_prefix",
+                          "base_exec_prefix" };
+  for (auto n : names) {
+    PyObject* p = PySys_GetObject(n);
+    if (p != nullptr and PyUnicode_Check(p)) {
+      const char* str = PyUnicode_AsUTF8(p);
+      if (str != nullptr) {
+        result.push_back(std::string(str) + "/");
+      }
+    }
+  }
+  PyErr_Clear();
+  return result;
+}
+
+}
+
+namespace ace { namespace pyfmt {
+
+Interpreter::Lock::Lock() : m_state(PyGILState_Ensure()) {}
+
+Interpreter::Lock::~Lock()
+{
+  PyGILState_Release(m_state);
+}
+
+Interpreter::Scope::Scope(fs::Path const& dir, int argc, char** argv)
+  : m_argv(nullptr), m_path(nullptr), m_modules(nullptr)
+{
+  /*
+   * Wait for the running configuration without holding the GIL, which it may
+   * need to complete.
+   */
+  Py_BEGIN_ALLOW_THREADS;
+  pthread_mutex_lock(&s_lock);
+  Py_END_ALLOW_THREADS;
+  /*
+   * Replace sys.argv.
+   */
+  m_argv = PySys_GetObject("argv");
+  Py_XINCREF(m_argv);
+  PyObject* args = PyList_New(0);
+  for (int i = 0; i < argc; i += 1) {
+    PyObject* arg = PyUnicode_DecodeFSDefault(argv[i]);
+    if (arg != nullptr) {
+      PyList_Append(args, arg);
+      Py_DECREF(arg);
+    }
+  }
+  PySys_SetObject("argv", args);
+  Py_DECREF(args);
+  /*
+   * Prepend the directory of the configuration to sys.path.
+   */
+  std::string p = dir.toString();
+  if (p.empty()) {
+    p = ".";
+  }
+  PyObject* path = PySys_GetObject("path");
+  if (path != nullptr and PyList_Check(path)) {
+    m_path = PyUnicode_DecodeFSDefault(p.c_str());
+    if (m_path != nullptr) {
+      PyList_Insert(path, 0, m_path);
+    }
+  }
+  /*
+   * Take a snapshot of the loaded modules.
+   */
+  m_modules = PyDict_Copy(PyImport_GetModuleDict());
+  PyErr_Clear();
+}
+
+Interpreter::Scope::~Scope()
+{
+  /*
+   * Unload the modules imported by the configuration.
+   */
+  PyObject* modules = PyImport_GetModuleDict();
+  if (m_modules != nullptr) {
+    auto prefixes = installPrefixes();
+    PyObject* keys = PyDict_Keys(modules);
+    for (Py_ssize_t i = 0; keys != nullptr and i < PyList_GET_SIZE(keys);
+         i += 1) {
+      PyObject* key = PyList_GET_ITEM(keys, i);
+      if (PyDict_Contains(m_modules, key) != 0) {
+        continue;
+      }
+      PyObject* module = PyDict_GetItem(modules, key);
+      if (module != nullptr and not isInstalled(module, prefixes)) {
+        PyDict_DelItem(modules, key);
+      }
+    }
+    Py_XDECREF(keys);
+    Py_DECREF(m_modules);
+  }
+  /*
+   * Restore sys.path.
+   */
+  PyObject* path = PySys_GetObject("path");
+  if (m_path != nullptr and path != nullptr and PyList_Check(path)) {
+    Py_ssize_t idx = PySequence_Index(path, m_path);
+    if (idx >= 0) {
+      PySequence_DelItem(path, idx);
+    }
+    Py_DECREF(m_path);
+  }
+  /*
+   * Restore sys.argv.
+   */
+  if (m_argv != nullptr) {
+    PySys_SetObject("argv", m_argv);
+    Py_DECREF(m_argv);
+  }
+  PyErr_Clear();
+  pthread_mutex_unlock(&s_lock);
+}
+
+/*
+ * The interpreter is isolated: the environment is ignored except for
+ * PYTHONPATH, which is explicitly added to the search path. If the host
+ * program already runs an interpreter, that one is used and left alone.
+ */
+
+Interpreter::Interpreter() : m_ok(false)
+{
+  if (Py_IsInitialized()) {
+    m_ok = true;
+    return;
+  }
+  PyStatus status;
+  PyConfig config;
+  PyConfig_InitIsolatedConfig(&config);
+  status = PyConfig_SetBytesString(&config, &config.program_name, "ace");
+  if (PyStatus_Exception(status)) {
+    PyConfig_Clear(&config);
+    return;
+  }
+  const char* pythonpath = getenv("PYTHONPATH");
+  if (pythonpath != nullptr) {
+    status =
+      PyConfig_SetBytesString(&config, &config.pythonpath_env, pythonpath);
+    if (PyStatus_Exception(status)) {
+      PyConfig_Clear(&config);
+      return;
+    }
+  }
+  status = Py_InitializeFromConfig(&config);
+  PyConfig_Clear(&config);
+  if (PyStatus_Exception(status)) {
+    return;
+  }
+  PyEval_SaveThread();
+  m_ok = true;
+}
+
+bool
+Interpreter::ok() const
+{
+  return m_ok;
+}
+
+Interpreter&
+Interpreter::get()
+{
+  static Interpreter* s_interpreter = new Interpreter;
+  return *s_interpreter;
+}
+
+}}
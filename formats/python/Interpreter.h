@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Python.h>
+#include <ace/filesystem/Path.h>
+#include <string>
+
+namespace ace { namespace pyfmt {
+
+/**
+ * @brief The embedded Python interpreter shared by all the scanner calls
+ *
+ * The interpreter is initialized once, on first use, and never finalized: the
+ * thread that initialized it may be gone by the time the process exits, and
+ * finalizing it from another thread is not supported. Threads take turns on it
+ * through the GIL.
+ */
+class Interpreter
+{
+public:
+  /**
+   * @brief Hold the GIL for the current thread
+   */
+  class Lock
+  {
+  public:
+    Lock();
+    ~Lock();
+
+  private:
+    PyGILState_STATE m_state;
+  };
+
+  /**
+   * @brief Run a configuration in the interpreter
+   *
+   * Set sys.argv and put the directory of the configuration at the head of
+   * sys.path. Both are restored when the scope ends, and the modules the
+   * configuration imported from outside of the Python installation are
+   * unloaded. The GIL must be held. Scopes are exclusive: a scope waits for
+   * the one that runs in another thread to end, with the GIL released.
+   */
+  class Scope
+  {
+  public:
+    Scope() = delete;
+    Scope(fs::Path const& dir, int argc, char** argv);
+    ~Scope();
+
+  private:
+    PyObject* m_argv;
+    PyObject* m_path;
+    PyObject* m_modules;
+  };
+
+  bool ok() const;
+
+  static Interpreter& get();
+
+private:
+  Interpreter();
+
+  bool m_ok;
+};
+
+}}
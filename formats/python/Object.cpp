@@ -36,9 +36,15 @@ build(std::string const& n, PyObject* o)
   PyObject *key, *value;
   Py_ssize_t pos = 0;
   while (PyDict_Next(o, &pos, &key, &value)) {
-    PyObject* obj = PyUnicode_AsUTF8String(key);
-    std::string k(PyBytes_AsString(obj));
-    Py_DECREF(obj);
+    Py_ssize_t len = 0;
+    const char* str =
+      PyUnicode_Check(key) ? PyUnicode_AsUTF8AndSize(key, &len) : nullptr;
+    if (str == nullptr) {
+      PyErr_Clear();
+      ACE_LOG(Error, "skipping non-string key");
+      continue;
+    }
+    std::string k(str, static_cast<size_t>(len));
     v = build_value(k, value);
     if (v.get() != nullptr) {
       object->put(k, v);
@@ -41,7 +41,7 @@ tree::Value::Ref
 build(std::string const& n, PyObject* o)
 {
   if (PyBool_Check(o)) {
-    bool v = PyObject_IsTrue(o) == 0;
+    bool v = PyObject_IsTrue(o) == 1;
     return tree::Primitive::build(n, v);
   } else if (PyLong_Check(o)) {
     long v = PyLong_AsLong(o);
@@ -50,9 +50,13 @@ build(std::string const& n, PyObject* o)
     double v = PyFloat_AsDouble(o);
     return tree::Primitive::build(n, v);
   } else if (PyUnicode_Check(o)) {
-    PyObject* obj = PyUnicode_AsUTF8String(o);
-    std::string v(PyBytes_AsString(obj));
-    Py_DECREF(obj);
+    Py_ssize_t len = 0;
+    const char* str = PyUnicode_AsUTF8AndSize(o, &len);
+    if (str == nullptr) {
+      PyErr_Clear();
+      return tree::Value::Ref();
+    }
+    std::string v(str, static_cast<size_t>(len));
     return tree::Primitive::build(n, v);
   }
   return tree::Value::Ref();
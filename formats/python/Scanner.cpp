@@ -23,6 +23,7 @@
 #include <Python.h>
 #include "Scanner.h"
 #include "Common.h"
+#include "Interpreter.h"
 #include "Object.h"
 #include <ace/common/Log.h>
 #include <ace/common/String.h>
@@ -31,6 +32,7 @@
 #include <fstream>
 #include <iostream>
 #include <locale>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -44,58 +46,27 @@ Scanner::open(std::string const& fn, int argc, char** argv)
     return nullptr;
   }
   /*
-   * Initialize the Python configuration.
+   * Read the file.
    */
-  fs::Path path(fn);
-  if (!setUp(path, argc, argv)) {
-    ACE_LOG(Error, "error setting up Python interpreter");
+  std::ifstream ifs(fn);
+  if (ifs.fail()) {
+    ACE_LOG(Error, "cannot open \"", fn, "\"");
     return nullptr;
   }
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
   /*
    * Compute the module name.
    */
+  fs::Path path(fn);
   std::vector<std::string> fnParts;
   common::String::split(*path.rbegin(), '.', fnParts);
   fnParts.erase(--fnParts.end());
   std::string mn = common::String::join(fnParts, '.');
   /*
-   * Grab the module.
+   * Run the module.
    */
-  PyObject* pName = PyUnicode_FromString(mn.c_str());
-  PyObject* pModule = PyImport_Import(pName);
-  Py_DECREF(pName);
-  PyObject* pConfig = nullptr;
-  tree::Value::Ref obj;
-  if (pModule == nullptr) {
-    PyErr_Print();
-    goto bad_file;
-  }
-  /*
-   * Look-up the dictionary.
-   */
-  if (not PyObject_HasAttrString(pModule, "config")) {
-    ACE_LOG(Error, "no \"config\" dictionary found in \"", fn, "\"");
-    goto bad_config;
-  }
-  pConfig = PyObject_GetAttrString(pModule, "config");
-  if (not PyDict_Check(pConfig)) {
-    ACE_LOG(Error, "\"config\" is not a dictionary");
-    goto bad_type;
-  }
-  /*
-   * Build the dictionary.
-   */
-  obj = Object::build("", pConfig);
-  /*
-   * Errors.
-   */
-bad_type:
-  Py_DECREF(pConfig);
-bad_config:
-  Py_XDECREF(pModule);
-bad_file:
-  Py_Finalize();
-  return obj;
+  return run(mn, path, oss.str(), argc, argv);
 }
 
 tree::Value::Ref
@@ -105,68 +76,7 @@ Scanner::parse(std::string const& s, int argc, char** argv)
     ACE_LOG(Error, "invalid ARGC/ARGV arguments");
     return nullptr;
   }
-  /*
-   * Initialize the Python configuration.
-   */
-  fs::Path path;
-  if (!setUp(path, argc, argv)) {
-    ACE_LOG(Error, "error setting up Python interpreter");
-    return nullptr;
-  }
-  /*
-   * Create an inlined module.
-   */
-  PyObject* pModule = PyModule_New("inlined");
-  PyModule_AddStringConstant(pModule, "__file__", "");
-  PyObject* pGlobal = PyDict_New();
-  /*
-   * Merge python built-ins.
-   */
-  if (PyDict_GetItemString(pGlobal, "__builtins__") == nullptr) {
-    if (PyDict_SetItemString(pGlobal, "__builtins__", PyEval_GetBuiltins()) !=
-        0) {
-      ACE_LOG(Error, "cannot merge Python built-ins");
-      return nullptr;
-    }
-  }
-  /*
-   * Execute the string.
-   */
-  PyObject* pLocal = PyModule_GetDict(pModule);
-  PyObject* pValue = PyRun_String(s.c_str(), Py_file_input, pGlobal, pLocal);
-  PyObject* pConfig = nullptr;
-  tree::Value::Ref obj;
-  if (pValue == nullptr) {
-    PyErr_Print();
-    goto bad_data;
-  }
-  /*
-   * Look-up the dictionary.
-   */
-  Py_DECREF(pValue);
-  if (not PyObject_HasAttrString(pModule, "config")) {
-    ACE_LOG(Error, "no \"config\" dictionary found in inlined Python");
-    goto bad_config;
-  }
-  pConfig = PyObject_GetAttrString(pModule, "config");
-  if (not PyDict_Check(pConfig)) {
-    ACE_LOG(Error, "\"config\" is not a dictionary");
-    goto bad_type;
-  }
-  /*
-   * Build the dictionary.
-   */
-  obj = Object::build("", pConfig);
-  /*
-   * Errors.
-   */
-bad_type:
-  Py_DECREF(pConfig);
-bad_config:
-  Py_XDECREF(pModule);
-bad_data:
-  Py_Finalize();
-  return obj;
+  return run("inlined", fs::Path(), s, argc, argv);
 }
 
 void
@@ -224,60 +134,101 @@ Scanner::extension() const
   return "py";
 }
 
-bool
-Scanner::setUp(fs::Path const& path, int argc, char** argv) noexcept
+/*
+ * Each configuration runs in a fresh module, so nothing leaks from one
+ * configuration to the next. The interpreter itself is only initialized once.
+ */
+
+tree::Value::Ref
+Scanner::run(std::string const& mn, fs::Path const& path,
+             std::string const& src, int argc, char** argv) const
 {
+  if (not Interpreter::get().ok()) {
+    ACE_LOG(Error, "error setting up Python interpreter");
+    return nullptr;
+  }
+  std::string fn = path.toString();
+  shift(fn, argc, argv);
+  Interpreter::Lock lock;
+  Interpreter::Scope scope(path.prune(), argc, argv);
   /*
-   * Initialize the Python configuration.
+   * Create the module.
    */
-  PyStatus status;
-  PyConfig config;
-  PyConfig_InitIsolatedConfig(&config);
+  PyObject* pModule = PyModule_New(mn.c_str());
+  if (pModule == nullptr) {
+    PyErr_Print();
+    return nullptr;
+  }
+  PyObject* pGlobal = PyModule_GetDict(pModule);
+  PyObject* pFile = PyUnicode_DecodeFSDefault(fn.c_str());
+  PyDict_SetItemString(pGlobal, "__file__", pFile);
+  Py_XDECREF(pFile);
+  if (PyDict_SetItemString(pGlobal, "__builtins__", PyEval_GetBuiltins()) !=
+      0) {
+    ACE_LOG(Error, "cannot merge Python built-ins");
+    Py_DECREF(pModule);
+    return nullptr;
+  }
   /*
-   * Set the program name.
+   * Register the module for the duration of the run, as the code it defines
+   * may look it up by name. A module of the same name is put back afterwards.
    */
-  status = PyConfig_SetBytesString(&config, &config.program_name,
-                                   path.toString().c_str());
-  if (PyStatus_Exception(status)) {
-    PyConfig_Clear(&config);
-    return false;
-  }
+  PyObject* pModules = PyImport_GetModuleDict();
+  PyObject* pPrevious = PyDict_GetItemString(pModules, mn.c_str());
+  Py_XINCREF(pPrevious);
+  PyDict_SetItemString(pModules, mn.c_str(), pModule);
   /*
-   * Load the arguments.
+   * Execute the source.
    */
-  shift(path.toString(), argc, argv);
-  status = PyConfig_SetBytesArgv(&config, argc, argv);
-  if (PyStatus_Exception(status)) {
-    PyConfig_Clear(&config);
-    return false;
+  PyObject* pCode =
+    Py_CompileString(src.c_str(), fn.empty() ? "<inlined>" : fn.c_str(),
+                     Py_file_input);
+  PyObject* pValue = nullptr;
+  PyObject* pConfig = nullptr;
+  tree::Value::Ref obj;
+  if (pCode == nullptr) {
+    PyErr_Print();
+    goto bad_data;
+  }
+  pValue = PyEval_EvalCode(pCode, pGlobal, pGlobal);
+  if (pValue == nullptr) {
+    PyErr_Print();
+    goto bad_data;
   }
   /*
-   * Compute the search path.
+   * Look-up the dictionary.
    */
-  fs::Path container = path.prune();
-  std::string p = container.toString();
-  if (p.empty()) {
-    p = ".";
-  }
-  const char* pythonpath = getenv("PYTHONPATH");
-  if (pythonpath != nullptr) {
-    p += ":" + std::string(pythonpath);
+  pConfig = PyDict_GetItemString(pGlobal, "config");
+  if (pConfig == nullptr) {
+    if (fn.empty()) {
+      ACE_LOG(Error, "no \"config\" dictionary found in inlined Python");
+    } else {
+      ACE_LOG(Error, "no \"config\" dictionary found in \"", fn, "\"");
+    }
+    goto bad_data;
   }
-  status = PyConfig_SetBytesString(&config, &config.pythonpath_env, p.c_str());
-  if (PyStatus_Exception(status)) {
-    PyConfig_Clear(&config);
-    return false;
+  if (not PyDict_Check(pConfig)) {
+    ACE_LOG(Error, "\"config\" is not a dictionary");
+    goto bad_data;
   }
   /*
-   * Initialize the interpreter.
+   * Build the dictionary.
    */
-  status = Py_InitializeFromConfig(&config);
-  if (PyStatus_Exception(status)) {
-    PyConfig_Clear(&config);
-    return false;
-  }
-  PyConfig_Clear(&config);
-  return true;
+  obj = Object::build("", pConfig);
+  /*
+   * Errors.
+   */
+bad_data:
+  if (pPrevious != nullptr) {
+    PyDict_SetItemString(pModules, mn.c_str(), pPrevious);
+    Py_DECREF(pPrevious);
+  } else if (PyDict_DelItemString(pModules, mn.c_str()) != 0) {
+    PyErr_Clear();
+  }
+  Py_XDECREF(pValue);
+  Py_XDECREF(pCode);
+  Py_DECREF(pModule);
+  return obj;
 }
 
 }}
@@ -48,7 +48,8 @@ public:
   std::string extension() const;
 
 private:
-  bool setUp(fs::Path const& path, int argc, char** argv) noexcept;
+  tree::Value::Ref run(std::string const& mn, fs::Path const& path,
+                       std::string const& src, int argc, char** argv) const;
 };
 
 }}
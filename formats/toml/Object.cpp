@@ -52,7 +52,7 @@ dump(tree::Value const& v)
   tree::Object const& w = static_cast<tree::Object const&>(v);
   toml::Table table;
   for (auto const& e : w) {
-    table[e.first] = Common::dump(*e.second);
+    table[e.first.str()] = Common::dump(*e.second);
   }
   return table;
 }
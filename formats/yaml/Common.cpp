@@ -22,23 +22,66 @@
 
 #include "Common.h"
 #include "Array.h"
+#include "Events.h"
 #include "Object.h"
 #include "Primitive.h"
 #include <ace/tree/Array.h>
+#include <ace/tree/Builder.h>
 #include <ace/tree/Object.h>
 #include <ace/tree/Primitive.h>
 #include <ace/common/Log.h>
 #include <ace/common/String.h>
 #include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <string>
 
+namespace {
+
+bool
+scan(std::istream& is, ace::tree::Handler& h)
+{
+  ace::yamlfmt::Events events(h);
+  try {
+    YAML::Parser parser(is);
+    if (not parser.HandleNextDocument(events)) {
+      ACE_LOG(Warning, "Empty YAML document");
+      return false;
+    }
+  } catch (YAML::ParserException const& e) {
+    ACE_LOG(Error, "Invalid YAML document: ", e.what());
+    return false;
+  }
+  return not events.failed();
+}
+
+}
+
 namespace ace { namespace yamlfmt { namespace Common {
 
+bool
+scanFile(std::string const& path, tree::Handler& h)
+{
+  std::ifstream ifs(path);
+  if (not ifs) {
+    ACE_LOG(Error, "Cannot open YAML file: ", path);
+    return false;
+  }
+  return scan(ifs, h);
+}
+
+bool
+scanString(std::string const& str, tree::Handler& h)
+{
+  std::istringstream iss(str);
+  return scan(iss, h);
+}
+
 tree::Value::Ref
 parseFile(std::string const& path)
 {
-  auto node = YAML::LoadFile(path);
-  return build("", node);
+  tree::Builder builder;
+  return scanFile(path, builder) ? builder.value() : nullptr;
 }
 
 bool
@@ -58,8 +101,8 @@ parseFile(std::string const& path, std::list<tree::Value::Ref>& r)
 tree::Value::Ref
 parseString(std::string const& str)
 {
-  auto node = YAML::Load(str);
-  return build("", node);
+  tree::Builder builder;
+  return scanString(str, builder) ? builder.value() : nullptr;
 }
 
 bool
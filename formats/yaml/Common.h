@@ -22,12 +22,17 @@
 
 #pragma once
 
+#include <ace/tree/Handler.h>
 #include <ace/tree/Scanner.h>
 #include <string>
 #include <yaml-cpp/yaml.h>
 
 namespace ace { namespace yamlfmt { namespace Common {
 
+bool scanFile(std::string const& path, tree::Handler& h);
+
+bool scanString(std::string const& str, tree::Handler& h);
+
 tree::Value::Ref parseFile(std::string const& path);
 
 bool parseFile(std::string const& path, std::list<tree::Value::Ref>& r);
@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Events.h"
+#include "Primitive.h"
+#include <ace/common/Log.h>
+#include <string>
+#include <vector>
+
+namespace ace { namespace yamlfmt {
+
+Events::Events(tree::Handler& h)
+  : m_handler(h), m_frames(), m_anchors(), m_recordings(), m_failed(false)
+{}
+
+void
+Events::OnDocumentStart(YAML::Mark const& mark)
+{}
+
+void
+Events::OnDocumentEnd()
+{}
+
+void
+Events::OnNull(YAML::Mark const& mark, YAML::anchor_t anchor)
+{
+  record({ Event::Kind::Null, "", "" }, anchor);
+  std::string k;
+  if (next(k)) {
+    ACE_LOG(Warning, "Null type not supported");
+  }
+}
+
+void
+Events::OnAlias(YAML::Mark const& mark, YAML::anchor_t anchor)
+{
+  if (m_failed) {
+    return;
+  }
+  if (m_anchors.count(anchor) == 0) {
+    ACE_LOG(Error, "Unknown YAML anchor: ", anchor);
+    m_failed = true;
+    return;
+  }
+  /*
+   * Copy the events as the replay may record them again.
+   */
+  std::vector<Event> events = m_anchors.at(anchor);
+  for (auto const& e : events) {
+    switch (e.kind) {
+      case Event::Kind::Null:
+        OnNull(mark, YAML::NullAnchor);
+        break;
+      case Event::Kind::Scalar:
+        OnScalar(mark, e.tag, YAML::NullAnchor, e.value);
+        break;
+      case Event::Kind::SequenceStart:
+        OnSequenceStart(mark, e.tag, YAML::NullAnchor,
+                        YAML::EmitterStyle::Default);
+        break;
+      case Event::Kind::MapStart:
+        OnMapStart(mark, e.tag, YAML::NullAnchor, YAML::EmitterStyle::Default);
+        break;
+      case Event::Kind::End:
+        end();
+        break;
+    }
+  }
+}
+
+void
+Events::OnScalar(YAML::Mark const& mark, std::string const& tag,
+                 YAML::anchor_t anchor, std::string const& value)
+{
+  record({ Event::Kind::Scalar, tag, value }, anchor);
+  if (m_failed) {
+    return;
+  }
+  if (not m_frames.empty() and m_frames.back().map and m_frames.back().key) {
+    m_frames.back().name = value;
+    m_frames.back().key = false;
+    return;
+  }
+  std::string k;
+  if (next(k) and not Primitive::emit(k, tag, value, m_handler)) {
+    m_failed = true;
+  }
+}
+
+void
+Events::OnSequenceStart(YAML::Mark const& mark, std::string const& tag,
+                        YAML::anchor_t anchor, YAML::EmitterStyle::value style)
+{
+  record({ Event::Kind::SequenceStart, tag, "" }, anchor);
+  std::string k;
+  if (not next(k)) {
+    return;
+  }
+  if (not m_handler.onArrayStart(k)) {
+    m_failed = true;
+    return;
+  }
+  m_frames.push_back({ false, false, "" });
+}
+
+void
+Events::OnSequenceEnd()
+{
+  end();
+}
+
+void
+Events::OnMapStart(YAML::Mark const& mark, std::string const& tag,
+                   YAML::anchor_t anchor, YAML::EmitterStyle::value style)
+{
+  record({ Event::Kind::MapStart, tag, "" }, anchor);
+  std::string k;
+  if (not next(k)) {
+    return;
+  }
+  if (not m_handler.onObjectStart(k)) {
+    m_failed = true;
+    return;
+  }
+  m_frames.push_back({ true, true, "" });
+}
+
+void
+Events::OnMapEnd()
+{
+  end();
+}
+
+bool
+Events::failed() const
+{
+  return m_failed;
+}
+
+void
+Events::record(Event const& e, const YAML::anchor_t anchor)
+{
+  bool isStart =
+    e.kind == Event::Kind::SequenceStart or e.kind == Event::Kind::MapStart;
+  for (auto& r : m_recordings) {
+    m_anchors[r.first].push_back(e);
+    if (isStart) {
+      r.second += 1;
+    } else if (e.kind == Event::Kind::End) {
+      r.second -= 1;
+    }
+  }
+  while (not m_recordings.empty() and m_recordings.back().second == 0) {
+    m_recordings.pop_back();
+  }
+  if (anchor != YAML::NullAnchor) {
+    m_anchors[anchor] = { e };
+    if (isStart) {
+      m_recordings.push_back({ anchor, 1 });
+    }
+  }
+}
+
+bool
+Events::next(std::string& k)
+{
+  if (m_failed) {
+    return false;
+  }
+  k.clear();
+  if (m_frames.empty() or not m_frames.back().map) {
+    return true;
+  }
+  Frame& f = m_frames.back();
+  if (f.key) {
+    ACE_LOG(Error, "Unsupported non-scalar YAML key");
+    m_failed = true;
+    return false;
+  }
+  f.key = true;
+  k = f.name;
+  return true;
+}
+
+void
+Events::end()
+{
+  record({ Event::Kind::End, "", "" }, YAML::NullAnchor);
+  if (m_failed or m_frames.empty()) {
+    return;
+  }
+  m_frames.pop_back();
+  if (not m_handler.onEnd()) {
+    m_failed = true;
+  }
+}
+
+}}
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <ace/tree/Handler.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+namespace ace { namespace yamlfmt {
+
+/**
+ * Translate the events of the YAML parser into tree events. Anchored nodes
+ * are recorded as they are parsed and replayed for their aliases.
+ */
+class Events : public YAML::EventHandler
+{
+public:
+  Events() = delete;
+  explicit Events(tree::Handler& h);
+
+  void OnDocumentStart(YAML::Mark const& mark);
+  void OnDocumentEnd();
+
+  void OnNull(YAML::Mark const& mark, YAML::anchor_t anchor);
+  void OnAlias(YAML::Mark const& mark, YAML::anchor_t anchor);
+  void OnScalar(YAML::Mark const& mark, std::string const& tag,
+                YAML::anchor_t anchor, std::string const& value);
+
+  void OnSequenceStart(YAML::Mark const& mark, std::string const& tag,
+                       YAML::anchor_t anchor, YAML::EmitterStyle::value style);
+  void OnSequenceEnd();
+
+  void OnMapStart(YAML::Mark const& mark, std::string const& tag,
+                  YAML::anchor_t anchor, YAML::EmitterStyle::value style);
+  void OnMapEnd();
+
+  bool failed() const;
+
+private:
+  struct Event
+  {
+    enum class Kind
+    {
+      Null,
+      Scalar,
+      SequenceStart,
+      MapStart,
+      End
+    };
+
+    Kind kind;
+    std::string tag;
+    std::string value;
+  };
+
+  struct Frame
+  {
+    bool map;
+    bool key;
+    std::string name;
+  };
+
+  void record(Event const& e, const YAML::anchor_t anchor);
+  bool next(std::string& k);
+  void end();
+
+  tree::Handler& m_handler;
+  std::vector<Frame> m_frames;
+  std::map<YAML::anchor_t, std::vector<Event>> m_anchors;
+  std::vector<std::pair<YAML::anchor_t, size_t>> m_recordings;
+  bool m_failed;
+};
+
+}}
@@ -50,7 +50,7 @@ dump(tree::Value const& v, YAML::Emitter& e)
   tree::Object const& w = static_cast<tree::Object const&>(v);
   e << YAML::BeginMap;
   for (auto const& i : w) {
-    e << YAML::Key << i.first;
+    e << YAML::Key << i.first.str();
     e << YAML::Value;
     Common::dump(*i.second, e);
   }
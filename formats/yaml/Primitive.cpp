@@ -57,6 +57,27 @@ build(std::string const& name, YAML::Node const& r)
   }
 }
 
+bool
+emit(std::string const& name, std::string const& tag,
+     std::string const& value, tree::Handler& h)
+{
+  /*
+   * Escaped strings are emitted verbatim, like in build().
+   */
+  if (tag.length() > 0 && tag[0] == '!') {
+    return h.onString(name, value);
+  }
+  if (common::String::is<long>(value)) {
+    return h.onInteger(name, common::String::value<long>(value));
+  } else if (common::String::is<double>(value)) {
+    return h.onFloat(name, common::String::value<double>(value));
+  } else if (common::String::is<bool>(value)) {
+    return h.onBoolean(name, common::String::value<bool>(value));
+  } else {
+    return h.onString(name, value);
+  }
+}
+
 void
 dump(tree::Value const& v, YAML::Emitter& e)
 {
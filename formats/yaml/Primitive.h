@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <ace/tree/Handler.h>
 #include <ace/tree/Scanner.h>
 #include <string>
 #include <yaml-cpp/yaml.h>
@@ -30,6 +31,9 @@ namespace ace { namespace yamlfmt { namespace Primitive {
 
 tree::Value::Ref build(std::string const& name, YAML::Node const& n);
 
+bool emit(std::string const& name, std::string const& tag,
+          std::string const& value, tree::Handler& h);
+
 void dump(tree::Value const& v, YAML::Emitter& e);
 
 }}}
@@ -42,6 +42,12 @@ Scanner::parse(std::string const& s, int argc, char** argv)
   return Common::parseString(s);
 }
 
+bool
+Scanner::scan(std::string const& fn, int argc, char** argv, tree::Handler& h)
+{
+  return Common::scanFile(fn, h);
+}
+
 void
 Scanner::dump(tree::Value const& v, const Format f, std::ostream& o) const
 {
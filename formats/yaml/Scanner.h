@@ -36,6 +36,8 @@ public:
   tree::Value::Ref parse(std::string const& s, int argc, char** argv);
   void dump(tree::Value const& v, const Format f, std::ostream& o) const;
 
+  bool scan(std::string const& fn, int argc, char** argv, tree::Handler& h);
+
   bool openAll(std::string const& fn, int argc, char** argv,
                std::list<tree::Value::Ref>& values);
   bool parseAll(std::string const& s, int argc, char** argv,
@@ -65,6 +65,31 @@ public:
     All = 6
   };
 
+  /**
+   * @brief Collect the error messages of the calling thread
+   *
+   * Error messages written by the thread while a capture is in scope are
+   * appended to it, one per line and without header, whatever the log level.
+   * Captures can be nested; only the innermost one collects the messages.
+   */
+  class Capture
+  {
+  public:
+    Capture();
+    explicit Capture(Capture const& o) = delete;
+    ~Capture();
+
+    std::string str() const;
+
+  private:
+    friend class Log;
+
+    static Capture* current();
+
+    Capture* m_previous;
+    std::ostringstream m_errors;
+  };
+
 public:
   ~Log();
 
@@ -144,6 +169,12 @@ template<typename... Args>
 void
 Log::write(Level l, std::string const& f, int n, Args const&... a)
 {
+  if (__builtin_expect(l == Level::Error, 0)) {
+    Capture* k = Capture::current();
+    if (k != nullptr) {
+      (k->m_errors << ... << a) << std::endl;
+    }
+  }
   if (__builtin_expect(l <= m_level and m_level != Level::None, 0)) {
     std::ostringstream oss;
     Channel& c = channel();
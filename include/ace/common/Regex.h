@@ -22,10 +22,65 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
+
+namespace re2 {
+class RE2;
+}
 
 namespace ace { namespace common { namespace Regex {
 
+/**
+ * @brief A replacement template, where \1 to \9 stand for captured groups
+ *
+ * The template is split once into literals and group references.
+ */
+class Rewrite
+{
+public:
+  Rewrite();
+  explicit Rewrite(std::string const& p);
+
+  bool ok() const;
+  size_t captures() const;
+  std::string const& source() const;
+
+  std::string apply(std::vector<std::string> const& x) const;
+
+private:
+  std::string m_source;
+  std::vector<std::string> m_literals;
+  std::vector<size_t> m_groups;
+  size_t m_captures;
+  bool m_ok;
+};
+
+/**
+ * @brief A compiled regular expression
+ *
+ * Patterns with the same source share the same compiled expression. Compiled
+ * expressions are immutable and can be used from concurrent threads.
+ */
+class Pattern
+{
+public:
+  Pattern();
+  explicit Pattern(std::string const& r);
+
+  bool ok() const;
+  bool empty() const;
+  std::string const& source() const;
+
+  bool match(std::string const& s) const;
+  bool expand(std::string const& s, Rewrite const& p, std::string& v) const;
+
+private:
+  std::string m_source;
+  std::shared_ptr<const re2::RE2> m_regex;
+};
+
 bool check(std::string const& r);
 
 bool match(std::string const& s, std::string const& r);
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <pthread.h>
+
+namespace ace { namespace common {
+
+/**
+ * @brief Host name resolver
+ *
+ * Host names are resolved concurrently, one thread per name, and all the
+ * lookups of a call share the same deadline. Results are cached for a limited
+ * time, or until cleared. A name that is not resolved before the deadline is
+ * cached as unresolved.
+ */
+class Resolver
+{
+public:
+  ~Resolver();
+
+  static Resolver& get();
+
+  void setEnabled(const bool e);
+  bool enabled() const;
+
+  void setTimeout(const long ms);
+  long timeout() const;
+
+  void setTimeToLive(const long ms);
+  long timeToLive() const;
+
+  /**
+   * @brief Resolve a batch of host names, skipping the cached ones
+   */
+  void resolve(std::set<std::string> const& hosts);
+
+  /**
+   * @brief Check if a host name resolves to an IPv4 address
+   */
+  bool resolved(std::string const& host);
+
+  void clear();
+
+private:
+  Resolver();
+
+  struct Entry
+  {
+    bool resolved;
+    long expires;
+  };
+
+  bool lookup(std::string const& host, bool& r) const;
+
+  bool m_enabled;
+  long m_timeout;
+  long m_ttl;
+  std::map<std::string, Entry> m_cache;
+  mutable pthread_mutex_t m_lock;
+};
+
+}}
@@ -44,6 +44,14 @@ is(std::string const& s)
   return (iss.rdstate() & (std::istream::failbit | std::istream::badbit)) == 0;
 }
 
+/*
+ * The specializations below do not allocate and do not depend on the locale.
+ * They accept the same inputs as the generic versions, that use a stream.
+ */
+
+template<>
+bool is<bool>(std::string const& s);
+
 template<>
 bool is<long>(std::string const& s);
 
@@ -60,6 +68,15 @@ value(std::string const& s)
   return r;
 }
 
+template<>
+bool value<bool>(std::string const& s);
+
+template<>
+long value<long>(std::string const& s);
+
+template<>
+unsigned long value<unsigned long>(std::string const& s);
+
 template<>
 double value<double>(std::string const& s);
 
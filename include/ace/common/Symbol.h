@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace ace { namespace common {
+
+/**
+ * Interned string.
+ *
+ * Symbols are handles to the entries of a global, thread-safe symbol table.
+ * Equal strings share a single entry, so that two symbols are compared by
+ * identity and hashed for free. Entries are reference-counted and released
+ * with the last symbol that uses them. The table is split in shards that are
+ * locked independently, so that concurrent parsers rarely contend.
+ */
+class Symbol
+{
+public:
+  Symbol();
+  Symbol(std::string const& s); // NOLINT
+  Symbol(const char* s);        // NOLINT
+  Symbol(Symbol const& o);
+  Symbol(Symbol&& o) noexcept;
+  ~Symbol();
+
+  Symbol& operator=(Symbol const& o);
+  Symbol& operator=(Symbol&& o) noexcept;
+
+  std::string const& str() const { return m_entry->value; }
+  operator std::string const&() const { return m_entry->value; } // NOLINT
+
+  const char* c_str() const { return m_entry->value.c_str(); }
+  size_t size() const { return m_entry->value.size(); }
+  size_t length() const { return m_entry->value.length(); }
+  bool empty() const { return m_entry->value.empty(); }
+
+  size_t hash() const { return m_entry->hash; }
+  const void* id() const { return m_entry; }
+
+  static size_t count();
+
+private:
+  struct Entry
+  {
+    std::string value;
+    size_t hash;
+    mutable std::atomic<size_t> refs;
+  };
+
+  struct Table;
+
+  static Table& table();
+  static const Entry* blank();
+  static const Entry* intern(std::string const& s);
+  static void acquire(const Entry* e);
+  static void release(const Entry* e);
+
+  const Entry* m_entry;
+};
+
+inline bool
+operator==(Symbol const& a, Symbol const& b)
+{
+  return a.id() == b.id();
+}
+
+inline bool
+operator!=(Symbol const& a, Symbol const& b)
+{
+  return a.id() != b.id();
+}
+
+inline bool
+operator==(Symbol const& a, std::string const& b)
+{
+  return a.str() == b;
+}
+
+inline bool
+operator!=(Symbol const& a, std::string const& b)
+{
+  return a.str() != b;
+}
+
+inline bool
+operator==(std::string const& a, Symbol const& b)
+{
+  return a == b.str();
+}
+
+inline bool
+operator!=(std::string const& a, Symbol const& b)
+{
+  return a != b.str();
+}
+
+inline bool
+operator==(Symbol const& a, const char* b)
+{
+  return a.str() == b;
+}
+
+inline bool
+operator!=(Symbol const& a, const char* b)
+{
+  return a.str() != b;
+}
+
+inline bool
+operator<(Symbol const& a, Symbol const& b)
+{
+  return a.id() != b.id() and a.str() < b.str();
+}
+
+inline std::string
+operator+(Symbol const& a, std::string const& b)
+{
+  return a.str() + b;
+}
+
+inline std::string
+operator+(std::string const& a, Symbol const& b)
+{
+  return a + b.str();
+}
+
+inline std::string
+operator+(const char* a, Symbol const& b)
+{
+  return a + b.str();
+}
+
+inline std::ostream&
+operator<<(std::ostream& o, Symbol const& s)
+{
+  return o << s.str();
+}
+
+}}
+
+namespace std {
+
+template<>
+struct hash<ace::common::Symbol>
+{
+  size_t operator()(ace::common::Symbol const& s) const { return s.hash(); }
+};
+
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <ace/filesystem/Probe.h>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+
+#define CONTEXT ace::engine::Context::current()
+
+namespace ace { namespace engine {
+
+/**
+ * Validation context.
+ *
+ * A context collects the reports produced while a configuration is validated
+ * (defaulted, inherited, promoted, undefined and unexpected options) as well as
+ * the model paths being loaded, used to detect reference loops. It also holds
+ * the results of the file system probes made during the validation.
+ *
+ * Each thread has a default context. A different context can be installed for
+ * the duration of a scope with Context::Scope. Contexts are not shared between
+ * threads, which lets independent validations run concurrently.
+ */
+class Context
+{
+public:
+  enum Option
+  {
+    None = 0x00,
+    Defaulted = 0x01,
+    Inherited = 0x02,
+    Promoted = 0x04,
+    Undefined = 0x08,
+    Unexpected = 0x10,
+    Relevant = Defaulted | Inherited | Promoted,
+    All = Defaulted | Inherited | Promoted | Undefined | Unexpected
+  };
+
+  class Scope
+  {
+  public:
+    Scope() = delete;
+    explicit Scope(Context& c);
+    ~Scope();
+
+  private:
+    Context* m_previous;
+  };
+
+public:
+  Context() = default;
+  Context(Context const&) = delete;
+  Context& operator=(Context const&) = delete;
+
+  bool addModelPath(std::string const& mdp);
+  void remModelPath(std::string const& mdp);
+
+  void pushDefaulted(std::string const& p, std::string const& v);
+  void pushInherited(std::string const& p, std::string const& f,
+                     std::string const& v);
+  void pushPromoted(std::string const& p);
+  void pushUndefined(std::string const& p);
+  void pushUnexpected(std::string const& p);
+
+  /**
+   * @brief   Forget a defaulted or inherited option, and those under it
+   * @param p the path of the option
+   * @return  true if the option was defaulted or inherited
+   */
+  bool popInjected(std::string const& p);
+
+  std::set<std::string> const& unexpected() const;
+
+  fs::Probe& probe();
+
+  void summarize(std::ostream& o, int filter = Option::Relevant) const;
+  void reset();
+
+  static Context& current();
+
+private:
+  std::set<std::string> m_modelPaths;
+  std::map<std::string, std::string> m_defaulted;
+  std::map<std::string, std::pair<std::string, std::string>> m_inherited;
+  std::set<std::string> m_promoted;
+  std::set<std::string> m_undefined;
+  std::set<std::string> m_unexpected;
+  fs::Probe m_probe;
+};
+
+}}
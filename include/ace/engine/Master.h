@@ -23,6 +23,7 @@
 #pragma once
 
 #include <ace/filesystem/Directory.h>
+#include <ace/filesystem/Index.h>
 #include <ace/tree/Scanner.h>
 #include <functional>
 #include <list>
@@ -33,11 +34,18 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <pthread.h>
 
 #ifndef MASTER
 #define MASTER ace::engine::Master::getInstance()
 #endif
 
+namespace ace { namespace model {
+
+class Model;
+
+}}
+
 namespace ace { namespace engine {
 
 class Master
@@ -45,83 +53,85 @@ class Master
 public:
   typedef void* (*Builder)(tree::Value const& v);
 
-  enum Option
-  {
-    None = 0x00,
-    Defaulted = 0x01,
-    Inherited = 0x02,
-    Promoted = 0x04,
-    Undefined = 0x08,
-    Unexpected = 0x10,
-    Relevant = Defaulted | Inherited | Promoted,
-    All = Defaulted | Inherited | Promoted | Undefined | Unexpected
-  };
-
 public:
+  ~Master();
+
   void addModelDirectory(fs::Path const& p);
   bool addInlinedModel(std::string const& k, std::string const& s);
+  bool addCompiledModel(std::string const& k, tree::Value::Ref const& r);
 
   bool hasModel(std::string const& n) const;
   bool isInlinedModel(std::string const& n) const;
+  bool isCompiledModel(std::string const& n) const;
+  tree::Value::Ref compiledModelFor(std::string const& n) const;
 
   bool addModelBuilder(std::string const& k, std::string const& v, Builder b);
 
   bool hasModelBuildersFor(std::string const& k) const;
-  std::map<std::string, Builder> const& modelBuildersFor(
-    std::string const& k) const;
+  std::map<std::string, Builder> modelBuildersFor(std::string const& k) const;
 
   bool addChildForPath(std::string const& path, std::string const& ch);
-  std::set<std::string> childrenForPath(std::string const& p);
+  std::set<std::string> childrenForPath(std::string const& p) const;
 
   fs::Path modelPathFor(fs::Path const& p) const;
   std::string const& modelSourceFor(std::string const& n) const;
 
-  bool addModelPathIntoContext(std::string const& mdp);
-  void remModelPathFromContext(std::string const& mdp);
-
   std::string modelEnvPath() const;
 
+  void setLazyPlugins(const bool e);
+  bool lazyPlugins() const;
+
+  std::string modelSignatureFor(std::string const& n) const;
+
+  void cacheModel(std::string const& n, model::Model const& m);
+  bool hasCachedModel(std::string const& n) const;
+  std::shared_ptr<model::Model> cachedModelFor(std::string const& n) const;
+  void clearModelCache();
+
   bool hasScannerByName(std::string const& n) const;
   tree::Scanner& scannerByName(std::string const& n) const;
 
   bool hasScannerByExtension(std::string const& fn) const;
   tree::Scanner& scannerByExtension(std::string const& fn) const;
 
-  void pushDefaulted(std::string const& p, std::string const& v);
-  void pushInherited(std::string const& p, std::string const& f,
-                     std::string const& v);
-  void pushPromoted(std::string const& p);
-  void pushUndefined(std::string const& p);
-  void pushUnexpected(std::string const& p);
-
-  std::set<std::string> const& unexpected() const;
-
-  void summarize(std::ostream& o, int filter = Option::Relevant) const;
   void reset();
 
   static Master& getInstance();
 
 private:
+  struct CachedModel
+  {
+    std::shared_ptr<model::Model> model;
+    std::map<std::string, std::string> signatures;
+    std::map<std::string, std::set<std::string>> children;
+  };
+
   Master();
 
+  static std::shared_ptr<Master> build();
+
+  std::string modelKeyFor(std::string const& n) const;
+  bool findCachedModel(std::string const& n, CachedModel& e) const;
+  bool isCurrent(std::string const& n, CachedModel const& e) const;
+
   void loadPluginsAtPath(std::string const& path);
   void collectChildrenForPath(std::string const& p,
                               std::set<std::string>& r) const;
 
   std::string m_modelEnvPath;
   std::list<fs::Directory> m_modelDirs;
+  mutable fs::Index m_modelIndex;
   std::map<std::string, std::reference_wrapper<const std::string>>
     m_inlineModels;
+  std::map<std::string, tree::Value::Ref> m_compiledModels;
   std::map<std::string, std::map<std::string, Builder>> m_builders;
   std::map<std::string, std::set<std::string>> m_childrenForPath;
-  std::set<std::string> m_modelPathContext;
+  std::map<std::string, CachedModel> m_modelCache;
   std::map<std::string, tree::Scanner::Ref> m_scannersByName;
   std::map<std::string, tree::Scanner::Ref> m_scannersByExtension;
-  std::map<std::string, std::string> m_defaulted;
-  std::map<std::string, std::pair<std::string, std::string>> m_inherited;
-  std::set<std::string> m_promoted;
-  std::set<std::string> m_undefined;
-  std::set<std::string> m_unexpected;
+  bool m_lazyPlugins;
+  mutable pthread_mutex_t m_registryLock;
+  mutable pthread_mutex_t m_cacheLock;
 };
 
 }}
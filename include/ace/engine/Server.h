@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+
+namespace ace { namespace engine {
+
+/**
+ * Validation server.
+ *
+ * The server listens on a UNIX socket and answers validation requests for a
+ * set of models. Requests and responses are frames made of a 32-bit length in
+ * network byte order followed by that many bytes of payload. A request payload
+ * is a list of newline-separated fields:
+ *
+ *   validate\n<model>\n<configuration file>
+ *   dump\n<model>\n<configuration file>\n<format>
+ *   explain\n<model>\n<option path>
+ *
+ * A response payload starts with either "OK" or "ERROR" on its own line. For
+ * validate, the rest is the summary of the validation. For dump, it is the
+ * resolved configuration in the requested format. For explain, it is the
+ * explanation of the option path. For errors, it is a description of the
+ * error followed by the error messages of the request, if any.
+ *
+ * Configurations are validated with the name of the server as program name
+ * and the configuration file as sole argument. Models are served from the
+ * model cache of the master: a model whose file or dependencies changed is
+ * reloaded when it is next requested. Each connection is handled by its own
+ * thread; the threads are joined when the server stops.
+ */
+class Server
+{
+public:
+  static const size_t MAX_FRAME_SIZE;
+
+  Server() = delete;
+  Server(std::string const& name, std::set<std::string> const& models);
+  Server(Server const&) = delete;
+  Server& operator=(Server const&) = delete;
+  ~Server();
+
+  bool listen(std::string const& path);
+  void run();
+  void stop();
+
+  std::string serve(std::string const& request) const;
+
+  static bool readFrame(int fd, std::string& s);
+  static bool writeFrame(int fd, std::string const& s);
+
+private:
+  void handle(int fd);
+  void reap();
+
+  std::string m_name;
+  std::set<std::string> m_models;
+  std::string m_path;
+  int m_fd;
+  std::atomic<bool> m_running;
+  pthread_mutex_t m_lock;
+  std::set<int> m_clients;
+  std::map<std::thread::id, std::thread> m_workers;
+  std::vector<std::thread::id> m_done;
+};
+
+}}
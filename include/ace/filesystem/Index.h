@@ -20,44 +20,50 @@
  * SOFTWARE.
  */
 
-#include "Object.h"
-#include "Common.h"
-#include <ace/common/Log.h>
-#include <ace/common/String.h>
-#include <ace/tree/Object.h> // NOLINT
+#pragma once
+
+#include <ace/filesystem/Path.h>
 #include <string>
+#include <unordered_map>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
 
-namespace ace { namespace jsonfmt { namespace Object {
+namespace ace { namespace fs {
 
-tree::Value::Ref
-build(std::string const& name, json_t* const obj)
+/**
+ * @brief Index of directory entries
+ *
+ * The entries of a directory are read once and kept in a hash table, which is
+ * read again when the status of the directory changes. A listing read within
+ * the timestamp granularity of the last change of the directory may miss a
+ * change made in the same tick, and is read again on the next lookup. Lookups
+ * follow the same rules as Directory::has().
+ */
+class Index
 {
-  tree::Object::Ref object = tree::Object::build(name);
-  const char* key = nullptr;
-  json_t* value = nullptr;
-  json_object_foreach(obj, key, value)
+public:
+  Index();
+  Index(Index const&) = delete;
+  Index& operator=(Index const&) = delete;
+  ~Index();
+
+  bool has(fs::Path const& d, fs::Path const& p);
+
+  void clear();
+
+private:
+  struct Listing
   {
-    std::string skey(key);
-    tree::Value::Ref v = Common::build(skey, value);
-    if (v == nullptr) {
-      ACE_LOG(Error, "skipping unsupported value format for key: ", skey);
-    } else {
-      object->put(skey, v);
-    }
-  }
-  return object;
-}
-
-json_t*
-dump(tree::Value const& v)
-{
-  tree::Object const& w = static_cast<tree::Object const&>(v);
-  json_t* result = json_object();
-  for (auto const& e : w) {
-    json_t* value = Common::dump(*e.second);
-    json_object_set_new(result, e.first.c_str(), value);
-  }
-  return result;
-}
-
-}}}
+    struct stat status;
+    bool racy;
+    std::unordered_map<std::string, bool> entries;
+  };
+
+  bool find(fs::Path const& d, std::string const& n, bool& dir);
+
+  std::unordered_map<std::string, Listing> m_listings;
+  pthread_mutex_t m_lock;
+};
+
+}}
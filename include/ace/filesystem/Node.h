@@ -88,6 +88,13 @@ public:
   bool writeable() const;
   static bool writeable(fs::Path const& p, const bool follow = true);
 
+  /**
+   * @brief Get a signature of the node that changes when its content does
+   * @return the device, inode, size and modification time of the node
+   */
+  std::string signature() const;
+  static std::string signature(fs::Path const& p, const bool follow = true);
+
   Node parent() const;
 
   Node& operator=(Node const& o);
@@ -95,6 +102,7 @@ public:
 protected:
   static Type type(mode_t mode);
   static Permission permissions(mode_t mode);
+  static std::string signature(struct stat const& st);
 
   int m_fd;
   fs::Path m_path;
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <ace/filesystem/Node.h>
+#include <map>
+#include <set>
+#include <string>
+#include <pthread.h>
+
+namespace ace { namespace fs {
+
+/**
+ * @brief File system probe
+ *
+ * Paths are probed in parallel, each with a single stat() and faccessat()
+ * call. Results are kept until the probe is cleared, so that a path checked
+ * by several options is only probed once.
+ */
+class Probe
+{
+public:
+  struct Result
+  {
+    Node::Type type = Node::Type::Unknown;
+    bool readable = false;
+    bool writeable = false;
+    bool openable = false;
+    bool creatable = false;
+  };
+
+public:
+  Probe();
+  Probe(Probe const&) = delete;
+  Probe& operator=(Probe const&) = delete;
+  ~Probe();
+
+  /**
+   * @brief Probe a batch of paths, skipping the known ones
+   */
+  void probe(std::set<std::string> const& paths);
+
+  /**
+   * @brief Get the result for a path, probing it if it is not known
+   */
+  Result result(std::string const& p);
+
+  void clear();
+
+  size_t probed() const;
+  double elapsed() const;
+
+private:
+  bool lookup(std::string const& p, Result& r) const;
+
+  std::map<std::string, Result> m_results;
+  size_t m_probed;
+  double m_elapsed;
+  mutable pthread_mutex_t m_lock;
+};
+
+}}
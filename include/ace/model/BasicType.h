@@ -140,10 +140,21 @@ public:
   virtual bool resolveInstance(tree::Object const& r,
                                tree::Value const& v) const;
 
+  /**
+   * @brief Host names and file paths of an instance, checked in batch
+   */
+  struct Probes
+  {
+    std::set<std::string> hosts;
+    std::set<std::string> paths;
+  };
+
+  virtual void collectProbes(tree::Value const& v, Probes& p) const;
+
   // Coach
 
-  virtual void display(Coach::Branch const& br) const;
-  virtual bool explain(tree::Path const& p,
+  virtual void display(std::ostream& o, Coach::Branch const& br) const;
+  virtual bool explain(std::ostream& o, tree::Path const& p,
                        tree::Path::const_iterator const& i) const;
 
   // Generator
@@ -30,6 +30,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace ace { namespace model {
 
@@ -44,6 +45,15 @@ public:
 
   // Object
 
+  bool validateModel();
+
+  /**
+   * @brief  Order the types by their dependencies. Called by validateModel,
+   *         and directly for the bodies of compiled models
+   * @return false if the dependencies of the types form an invalid cycle
+   */
+  bool buildDependencyGraph();
+
   bool injectInherited(tree::Object const& r, Object const& o,
                        tree::Value& v) const;
 
@@ -54,10 +64,51 @@ public:
   bool flattenInstance(tree::Object& r, tree::Value& v);
   bool resolveInstance(tree::Object const& r, tree::Value const& v) const;
 
+  void collectProbes(tree::Value const& v, BasicType::Probes& p) const;
+
+  /**
+   * @brief   Drop the values defaulted or inherited by a previous validation
+   *          for the types in scope, except those that changed since
+   * @param v the instance
+   * @param c the paths of the changed values
+   */
+  void dropInjected(tree::Value& v, std::vector<tree::Path> const& c);
+
+  // Scope
+
+  /**
+   * @brief   Collect the types affected by changes made to an instance
+   * @param c the paths of the changed values
+   * @param r the names of the affected types
+   * @return  false if the affected types cannot be determined
+   */
+  bool collectAffected(std::vector<tree::Path> const& c,
+                       std::set<std::string>& r) const;
+
+  /**
+   * @brief   Restrict the instance methods to a set of types, or lift it
+   * @param s the names of the types
+   */
+  void setScope(std::set<std::string> const& s);
+  void clearScope();
+
   // Coach
 
-  void display(Coach::Branch const& br) const;
-  bool explain(tree::Path const& p, tree::Path::const_iterator const& i) const;
+  void display(std::ostream& o, Coach::Branch const& br) const;
+  bool explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const;
+
+private:
+  bool inScope(std::string const& n) const;
+
+  /**
+   * Types in topological order of their dependencies, and for each type with
+   * dependencies, the positions of the types its dependencies may affect.
+   */
+  std::vector<std::string> m_order;
+  std::map<std::string, std::vector<size_t>> m_affects;
+  std::set<std::string> m_scope;
+  bool m_scoped = false;
 };
 
 }}
@@ -69,12 +69,12 @@ public:
   /**
    * @brief Display object as part of a tree
    */
-  virtual void display(Branch const& br) const;
+  virtual void display(std::ostream& o, Branch const& br) const;
 
   /**
    * @brief Explain something to the user
    */
-  virtual bool explain(tree::Path const& p,
+  virtual bool explain(std::ostream& o, tree::Path const& p,
                        tree::Path::const_iterator const& i) const;
 };
 
@@ -76,6 +76,10 @@ public:
 
   virtual operator std::string() const = 0;
 
+  // Accessors
+
+  std::set<std::string> const& paths() const;
+
 protected:
   bool hasPlaceHolder(std::string const& d) const;
   std::string expandPlaceHolder(std::string const& d,
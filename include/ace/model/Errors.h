@@ -159,6 +159,8 @@
   "Attribute \"when\" entry must be either a Primitive or a String"
 #define ERR_WHEN_TYPE_MISMATCH "Attribute \"when\" entry type mismatch"
 #define ERR_NO_GLOBAL_PATH_IN_DEPS "Path in dependencies must be local"
+#define ERR_DEPS_DISABLE_CYCLE(_p)                                             \
+  "Dependency cycle with disabled options between ", _p
 
 // Constrain dependency
 
@@ -51,8 +51,25 @@ public:
   virtual void doTypeDeclaration(std::ostream& o, int l) const = 0;
   virtual void doTypeDefinition(std::ostream& o, int l) const = 0;
 
+  /**
+   * @brief Generate the build definition
+   *
+   * @param e an expression of type const ace::tree::Value*, null if absent
+   * @param o the output stream
+   * @param l the indentation level
+   */
   virtual void doBuildDefinition(std::string const& e, std::ostream& o,
                                  int l) const = 0;
+
+  /**
+   * @brief Generate the build definition
+   *
+   * @param s the name of the presence flag
+   * @param v the name of the value
+   * @param e an expression of type const ace::tree::Value*, null if absent
+   * @param o the output stream
+   * @param l the indentation level
+   */
   virtual void doBuildDefinition(std::string const& s, std::string const& v,
                                  std::string const& e, std::ostream& o,
                                  int l) const = 0;
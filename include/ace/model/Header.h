@@ -44,7 +44,8 @@ public:
   void loadModel(tree::Value const& t);
   bool checkModel(tree::Value const& t) const;
 
-  bool explain(tree::Path const& p, tree::Path::const_iterator const& i) const;
+  bool explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const;
 
   static std::string package(tree::Value const& t);
   std::string package() const;
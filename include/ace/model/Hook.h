@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include <ace/common/Regex.h>
 #include <ace/tree/Object.h>
 #include <ace/tree/Path.h>
+#include <ace/tree/Query.h>
 #include <string>
 
 namespace ace { namespace model {
@@ -40,14 +42,16 @@ public:
   bool transform(std::string const& v, std::string& r) const;
 
   tree::Path const& path() const;
+  tree::Query const& query() const;
   std::string const& pattern() const;
   std::string const& value() const;
   bool exact() const;
 
 private:
   tree::Path m_path;
-  std::string m_pattern;
-  std::string m_value;
+  tree::Query m_query;
+  common::Regex::Pattern m_pattern;
+  common::Regex::Rewrite m_value;
   bool m_exact;
 };
 
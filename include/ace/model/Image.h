@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <ace/model/Model.h>
+#include <ostream>
+#include <string>
+
+namespace ace { namespace model { namespace Image {
+
+/**
+ * @brief The file extension of model images
+ */
+extern const char Extension[];
+
+/**
+ * @brief Check if a file name is that of a model image
+ *
+ * @param fn the file name
+ *
+ * @return true if the file is a model image, false otherwise
+ */
+bool isImage(std::string const& fn);
+
+/**
+ * @brief Write the image of a loaded model
+ *
+ * The image contains the pre-parsed source of the model and of all the models
+ * it depends on. The model must be flattened and validated.
+ *
+ * @param m the model
+ * @param o the output stream
+ *
+ * @return true in case of success, false otherwise
+ */
+bool write(Model const& m, std::ostream& o);
+
+/**
+ * @brief Load a model image
+ *
+ * The image is mapped in memory and its models are registered in the master
+ * as compiled models. Compiled models are not checked nor validated again.
+ *
+ * @param fn the image file name
+ * @param n the name of the root model of the image
+ *
+ * @return true in case of success, false otherwise
+ */
+bool load(std::string const& fn, std::string& n);
+
+}}}
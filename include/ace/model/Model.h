@@ -67,10 +67,12 @@ public:
 
   // Coach
 
-  void display(Coach::Branch const& br) const;
+  void display(std::ostream& o, Coach::Branch const& br) const;
 
   bool explain(tree::Path const& path) const;
-  bool explain(tree::Path const& p, tree::Path::const_iterator const& i) const;
+  bool explain(std::ostream& o, tree::Path const& path) const;
+  bool explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const;
 
   // Code generation
 
@@ -92,11 +94,19 @@ public:
   void generateImplementation(fs::Path const& path) const;
 
   void collectModelFileDependencies(std::set<std::string>& d) const;
+  void collectPluginDependencies(std::set<std::string>& d) const;
 
   // Model checker
 
+  static tree::Value::Ref parse(std::string const& n);
+
   static bool check(const Object* o, std::string const& n);
+  static bool check(const Object* o, std::string const& n,
+                    tree::Value const& t);
+
   static Model::Ref load(Object* o, std::string const& n);
+  static Model::Ref load(Object* o, std::string const& n,
+                         tree::Value const& t);
 
   // Model loader and validator
 
@@ -104,6 +114,22 @@ public:
   tree::Value::Ref validate(std::string const& cfg, const int argc,
                             char** const argv);
 
+  /**
+   * @brief   Validate again a configuration after some of its values changed
+   * @param v the configuration, as returned by validate()
+   * @param c the paths of the changed values
+   * @return  true in case of success, false otherwise
+   *
+   * Only the options at the head of the changed paths and the options they
+   * may affect through dependencies, hooks and inheritance are validated
+   * again. Like validate(), it must be called on a freshly loaded model.
+   *
+   * The values of the affected options that were defaulted or inherited by
+   * the previous validation, as recorded in the current context, are dropped
+   * and injected again. The context must thus be the one of that validation.
+   */
+  bool revalidate(tree::Value& v, std::vector<tree::Path> const& c);
+
   // Inheritence
 
   bool isAnAncestor(Model const& m) const;
@@ -146,8 +172,17 @@ private:
     std::string m_path;
   };
 
+  class Session
+  {
+  public:
+    Session();
+    ~Session();
+  };
+
   static void* nullBuilder(tree::Value const& v);
 
+  void probeInstance(tree::Value const& v) const;
+
   std::string headerGuard(std::string const& n) const;
 
   bool checkInstance(tree::Object const& r, tree::Value const& v) const;
@@ -165,6 +200,8 @@ private:
   Section m_templates;
   Body m_body;
   std::vector<Ref> m_includes;
+  bool m_flattened;
+  bool m_validated;
 };
 
 }}
@@ -31,7 +31,7 @@
 #include "FormatChecker.h"
 #include "RequireDependency.h"
 #include "ValueGuard.h"
-#include <ace/engine/Master.h>
+#include <ace/engine/Context.h>
 #include <set>
 #include <sstream>
 #include <string>
@@ -160,7 +160,7 @@ Type<T, F>::injectDefault(tree::Object const& r, tree::Value& v) const
   std::ostringstream oss;
   oss << std::boolalpha << static_cast<std::string>(defaultAttribute());
   DEBUG("Inject default value");
-  MASTER.pushDefaulted(path(), oss.str());
+  CONTEXT.pushDefaulted(path(), oss.str());
   return true;
 }
 
@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ace { namespace tree {
+
+/**
+ * Document arena.
+ *
+ * The values built while an arena scope is active on the current thread are
+ * allocated, together with their reference counts, in a bump arena. So are the
+ * children of objects and arrays and the contents of strings. Each value holds
+ * a reference to its arena and the arena is released at once when the last of
+ * them is destroyed. Values built outside of a scope, as well as clones, are
+ * allocated on the heap. Both kinds of values can be mixed in a tree.
+ */
+class Arena
+{
+public:
+  using Ref = std::shared_ptr<Arena>;
+
+  template<typename T>
+  class Allocator
+  {
+  public:
+    using value_type = T;
+
+    Allocator() = delete;
+    explicit Allocator(Ref const& a) : m_arena(a) {}
+
+    template<typename U>
+    Allocator(Allocator<U> const& o) : m_arena(o.arena())
+    {}
+
+    T* allocate(const size_t n)
+    {
+      return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, const size_t n) {}
+
+    Ref const& arena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(Allocator<U> const& o) const
+    {
+      return m_arena == o.arena();
+    }
+
+    template<typename U>
+    bool operator!=(Allocator<U> const& o) const
+    {
+      return m_arena != o.arena();
+    }
+
+  private:
+    Ref m_arena;
+  };
+
+  /**
+   * Allocator for the storage owned by a value, such as its children. It does
+   * not hold a reference to the arena, the value that owns the storage does.
+   * Without an arena, it falls back to the heap. Memory released to an arena
+   * is only reclaimed with the arena. Copies of a container use the heap.
+   */
+  template<typename T>
+  class Storage
+  {
+  public:
+    using value_type = T;
+
+    Storage() : m_arena(nullptr) {}
+    explicit Storage(Arena* a) : m_arena(a) {}
+
+    template<typename U>
+    Storage(Storage<U> const& o) : m_arena(o.arena())
+    {}
+
+    T* allocate(const size_t n)
+    {
+      if (m_arena == nullptr) {
+        return std::allocator<T>().allocate(n);
+      }
+      return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, const size_t n)
+    {
+      if (m_arena == nullptr) {
+        std::allocator<T>().deallocate(p, n);
+      }
+    }
+
+    Storage select_on_container_copy_construction() const { return Storage(); }
+
+    Arena* arena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(Storage<U> const& o) const
+    {
+      return m_arena == o.arena();
+    }
+
+    template<typename U>
+    bool operator!=(Storage<U> const& o) const
+    {
+      return m_arena != o.arena();
+    }
+
+  private:
+    Arena* m_arena;
+  };
+
+  class Scope
+  {
+  public:
+    Scope();
+    Scope(Scope const&) = delete;
+    ~Scope();
+
+  private:
+    friend class Arena;
+
+    Ref m_arena;
+    Scope* m_previous;
+  };
+
+public:
+  Arena();
+  Arena(Arena const&) = delete;
+  Arena& operator=(Arena const&) = delete;
+
+  void* allocate(const size_t size, const size_t align);
+  size_t capacity() const;
+
+  template<typename T>
+  static std::shared_ptr<T> own(T* p, Ref const& a);
+
+  static Ref const& current();
+
+private:
+  struct Deleter
+  {
+    template<typename T>
+    void operator()(T* p) const
+    {
+      p->~T();
+    }
+  };
+
+  std::vector<std::unique_ptr<char[]>> m_chunks;
+  size_t m_capacity;
+  char* m_cursor;
+  char* m_limit;
+};
+
+/**
+ * Take the ownership of a value constructed in the memory of an arena. The
+ * value is destroyed, but not freed, when its last reference goes away.
+ */
+template<typename T>
+std::shared_ptr<T>
+Arena::own(T* p, Ref const& a)
+{
+  return std::shared_ptr<T>(p, Deleter(), Allocator<T>(a));
+}
+
+}}
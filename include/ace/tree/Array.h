@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "Arena.h"
 #include "Value.h"
 #include <cstdlib>
 #include <memory>
@@ -34,7 +35,7 @@ class Array : public Value
 {
 public:
   using Ref = std::shared_ptr<Array>;
-  using Content = std::vector<Value::Ref>;
+  using Content = std::vector<Value::Ref, Arena::Storage<Value::Ref>>;
   using const_iterator = Content::const_iterator;
 
 public:
@@ -81,7 +82,7 @@ public:
 
 private:
   Array(Array const& o);
-  explicit Array(std::string const& n);
+  Array(std::string const& n, Arena* a);
 
   bool put(Path const& p, Path::const_iterator const& i, Value::Ref const& r);
 
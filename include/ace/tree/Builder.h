@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "Handler.h"
+#include "Value.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ace { namespace tree {
+
+/**
+ * Handler that builds a tree from the events of a scanner. A unique builder
+ * rejects the objects with duplicate keys.
+ */
+class Builder : public Handler
+{
+public:
+  explicit Builder(const bool unique = false);
+
+  bool onObjectStart(std::string_view k);
+  bool onArrayStart(std::string_view k);
+  bool onEnd();
+
+  bool onBoolean(std::string_view k, const bool v);
+  bool onInteger(std::string_view k, const long v);
+  bool onFloat(std::string_view k, const double v);
+  bool onString(std::string_view k, std::string_view v);
+
+  /**
+   * @brief  The tree built, if the document was complete
+   * @return the root of the tree or nullptr
+   */
+  Value::Ref value() const;
+
+  /**
+   * @brief   Emit a tree as a sequence of events
+   * @param v the tree
+   * @param h the handler
+   * @return  true in case of success, false if the handler aborted
+   */
+  static bool emit(Value const& v, Handler& h);
+
+private:
+  bool add(Value::Ref const& r);
+  std::string name(std::string_view k) const;
+
+  bool m_unique;
+  std::vector<Value::Ref> m_stack;
+  Value::Ref m_root;
+};
+
+}}
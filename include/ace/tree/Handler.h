@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <string_view>
+
+namespace ace { namespace tree {
+
+/**
+ * Receiver of the events emitted by a scanner as it reads a document. Objects
+ * and arrays are opened by a start event and closed by an end event. Keys are
+ * empty for the root of the document and the items of arrays. The views are
+ * only valid for the duration of the call. A handler aborts the scan by
+ * returning false.
+ */
+class Handler
+{
+public:
+  virtual ~Handler() {}
+
+  virtual bool onObjectStart(std::string_view k) = 0;
+  virtual bool onArrayStart(std::string_view k) = 0;
+  virtual bool onEnd() = 0;
+
+  virtual bool onBoolean(std::string_view k, const bool v) = 0;
+  virtual bool onInteger(std::string_view k, const long v) = 0;
+  virtual bool onFloat(std::string_view k, const double v) = 0;
+  virtual bool onString(std::string_view k, std::string_view v) = 0;
+};
+
+}}
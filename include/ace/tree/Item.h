@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <ace/common/Symbol.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -74,6 +75,7 @@ public:
   Range const& range() const;
   bool root() const;
   std::string const& value() const;
+  common::Symbol const& symbol() const;
 
   bool operator==(Item const& o) const;
   bool operator!=(Item const& o) const;
@@ -84,7 +86,7 @@ private:
   Type m_type;
   bool m_rec;
   std::vector<size_t> m_indexes;
-  std::string m_value;
+  common::Symbol m_value;
   Range m_range;
 };
 
@@ -22,20 +22,68 @@
 
 #pragma once
 
+#include "Arena.h"
 #include "Value.h"
-#include <map>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace ace { namespace tree {
 
+/**
+ * Object value.
+ *
+ * The children are kept in a flat vector sorted by key, which keeps the
+ * iteration order deterministic. Keys are interned symbols that carry their
+ * hash, and lookups by path item compare them by identity. Small objects are
+ * looked up by scanning the keys. Objects larger than IndexThreshold also
+ * maintain an open-addressing index built from the hashes.
+ *
+ * Children are appended, and the index is updated in place. Lookups go through
+ * the index. Children appended out of order are merged into the sorted ones on
+ * the next iteration or ordered access. Removed
+ * children leave a hole that is skipped, and holes are compacted once they make
+ * up half of the vector. Building or erasing an object is thus linear.
+ */
 class Object : public Value
 {
 public:
   using Ref = std::shared_ptr<Object>;
-  using Content = std::map<std::string, Value::Ref>;
-  using const_iterator = Content::const_iterator;
+  using Entry = std::pair<common::Symbol, Value::Ref>;
+  using Content = std::vector<Entry, Arena::Storage<Entry>>;
+
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Entry*;
+    using reference = Entry const&;
+
+    const_iterator(Content::const_iterator const& c,
+                   Content::const_iterator const& e);
+
+    reference operator*() const { return *m_cur; }
+    pointer operator->() const { return &*m_cur; }
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    bool operator==(const_iterator const& o) const { return m_cur == o.m_cur; }
+    bool operator!=(const_iterator const& o) const { return m_cur != o.m_cur; }
+
+  private:
+    void skip();
+
+    Content::const_iterator m_cur;
+    Content::const_iterator m_end;
+  };
 
 public:
   Object() = delete;
@@ -63,6 +111,8 @@ public:
   Value& get(std::string const& k);
   Value const& get(std::string const& k) const;
 
+  const Value* find(std::string const& k) const;
+
   using Value::get;
 
   void get(Path const& p, Path::const_iterator const& i,
@@ -82,11 +132,31 @@ public:
 
 private:
   Object(Object const& o);
-  explicit Object(std::string const& n);
+  Object(std::string const& n, Arena* a);
 
   bool put(Path const& p, Path::const_iterator const& i, Value::Ref const& r);
 
-  Content m_content;
+  static constexpr size_t IndexThreshold = 16; // NOLINT
+  static constexpr size_t npos = size_t(-1);   // NOLINT
+
+  size_t locate(std::string const& k) const;
+  size_t locate(common::Symbol const& k) const;
+  size_t search(std::string const& k) const;
+  size_t search(common::Symbol const& k) const;
+  void assign(common::Symbol const& k, Value::Ref const& r);
+  void remove(std::string const& k);
+  void clear();
+  void normalize() const;
+  void compact();
+  void reindex() const;
+
+  mutable Content m_content;
+  mutable std::vector<uint32_t, Arena::Storage<uint32_t>> m_slots;
+  mutable size_t m_sorted;
+  mutable std::atomic<bool> m_ordered;
+  size_t m_holes;
+
+  friend class Query;
 };
 
 }}
@@ -40,11 +40,29 @@ public:
   using const_reverse_iterator = typename Container::const_reverse_iterator;
   using Ref = std::shared_ptr<Path>;
 
+  struct Statistics
+  {
+    size_t hits;
+    size_t misses;
+    size_t size;
+    size_t capacity;
+  };
+
   Path() = default;
 
   static Ref build(Path const& p = Path());
+
+  /**
+   * Parse a path. Parsed paths are kept in a bounded, thread-safe cache keyed
+   * by their source string. The items of the paths returned from the cache are
+   * shared and must not be modified.
+   */
   static Path parse(std::string const& s);
 
+  static Statistics cacheStatistics();
+  static void setCacheCapacity(const size_t c);
+  static void clearCache();
+
   Path& push(path::Item::Ref const& ir);
   Path sub(const_iterator const& from, const_iterator const& to) const;
 
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "Arena.h"
 #include "Value.h"
 #include <ace/common/String.h>
+#include <cstddef>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -37,6 +39,8 @@ public:
 
 public:
   Primitive() = delete;
+  Primitive& operator=(Primitive const&) = delete;
+  ~Primitive();
 
   template<typename T>
   static Ref build(T const& v);
@@ -56,49 +60,38 @@ public:
   std::string value() const;
 
 private:
-  class Content
-  {
-  public:
-    using Ref = std::unique_ptr<Content>;
-    virtual ~Content() {}
-    virtual Ref clone() const = 0;
-    virtual std::string toString() const = 0;
-  };
-
-  template<typename T>
-  class TypedContent : public Content
-  {
-  public:
-    TypedContent() = delete;
-    explicit TypedContent(T const& v) : m_value(v) {}
-
-    T value() const { return m_value; }
-
-    Ref clone() const { return Ref(new TypedContent<T>(m_value)); }
-
-    std::string toString() const { return common::String::from<T>(m_value); }
-
-    template<typename U>
-    bool is() const
-    {
-      return std::is_same<T, U>();
-    }
-
-  private:
-    T m_value;
-  };
-
   template<typename T>
   static Value::Type typeOf();
 
   template<typename T>
-  Primitive(std::string const& n, T const& v);
+  Primitive(Arena* a, std::string const& n, T const& v);
   template<size_t N>
-  Primitive(std::string const& n, const char (&v)[N]);
+  Primitive(Arena* a, std::string const& n, const char (&v)[N]);
 
   Primitive(Primitive const& p);
 
-  Content::Ref m_content;
+  void assign(Arena* a, const char* s, const size_t len);
+  void release();
+
+  /**
+   * Values are stored inline, in the union member that matches their type. The
+   * characters of strings are kept in the arena of the primitive, if any, or on
+   * the heap.
+   */
+  struct Text
+  {
+    char* data;
+    size_t size;
+    bool heap;
+  };
+
+  union
+  {
+    bool m_bool;
+    long m_long;
+    double m_double;
+    Text m_text;
+  };
 };
 
 template<typename T>
@@ -112,74 +105,72 @@ template<typename T>
 Primitive::Ref
 Primitive::build(std::string const& n, T const& v)
 {
-  return Ref(new Primitive(n, v));
+  Arena::Ref const& arena = Arena::current();
+  if (arena != nullptr) {
+    void* mem = arena->allocate(sizeof(Primitive), alignof(Primitive));
+    return Arena::own(new (mem) Primitive(arena.get(), n, v), arena);
+  }
+  return Ref(new Primitive(nullptr, n, v));
 }
 
 template<size_t N, typename T>
 Primitive::Ref
 Primitive::build(const char (&n)[N], T const& v)
 {
-  return Ref(new Primitive(std::string(n), v));
+  return build(std::string(n), v);
 }
 
 template<>
-Primitive::Primitive(std::string const& n, bool const& v);
+Primitive::Primitive(Arena* a, std::string const& n, bool const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, char const& v);
+Primitive::Primitive(Arena* a, std::string const& n, char const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, char const& v);
+Primitive::Primitive(Arena* a, std::string const& n, char const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, short const& v);
+Primitive::Primitive(Arena* a, std::string const& n, short const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned short const& v);
+Primitive::Primitive(Arena* a, std::string const& n, unsigned short const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, int const& v);
+Primitive::Primitive(Arena* a, std::string const& n, int const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned int const& v);
+Primitive::Primitive(Arena* a, std::string const& n, unsigned int const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, long const& v);
+Primitive::Primitive(Arena* a, std::string const& n, long const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned long const& v);
+Primitive::Primitive(Arena* a, std::string const& n, unsigned long const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, float const& v);
+Primitive::Primitive(Arena* a, std::string const& n, float const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, double const& v);
+Primitive::Primitive(Arena* a, std::string const& n, double const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, std::string const& v);
+Primitive::Primitive(Arena* a, std::string const& n, std::string const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, char* const& v);
+Primitive::Primitive(Arena* a, std::string const& n, char* const& v);
 
 template<>
-Primitive::Primitive(std::string const& n, const char* const& v);
+Primitive::Primitive(Arena* a, std::string const& n, const char* const& v);
 
 template<size_t N>
-Primitive::Primitive(std::string const& n, const char (&v)[N])
-  : Value(n, Type::String), m_content()
+Primitive::Primitive(Arena* a, std::string const& n, const char (&v)[N])
+  : Value(n, Type::String), m_text()
 {
-  if (N > 0) {
-    bool hasZero = false;
-    for (size_t i = 0; i < N; i += 1) {
-      if (v[i] == '\0') {
-        hasZero = true;
-        break;
-      }
-    }
-    auto* c = new TypedContent<std::string>(hasZero ? std::string(v)
-                                                    : std::string(v, N));
-    m_content = Content::Ref(c);
+  size_t len = 0;
+  while (len < N and v[len] != '\0') {
+    len += 1;
   }
+  assign(a, v, len);
 }
 
 template<>
@@ -283,7 +274,7 @@ inline bool
 Primitive::value() const
 {
   if (Primitive::typeOf<bool>() == m_type) {
-    return static_cast<TypedContent<bool> const&>(*m_content).value();
+    return m_bool;
   }
   throw std::logic_error("Bad type conversion");
 }
@@ -293,8 +284,7 @@ inline short
 Primitive::value() const
 {
   if (Primitive::typeOf<short>() == m_type) {
-    auto const& c = static_cast<TypedContent<long> const&>(*m_content);
-    return static_cast<short>(c.value());
+    return static_cast<short>(m_long);
   }
   throw std::logic_error("Bad type conversion");
 }
@@ -304,8 +294,7 @@ inline int
 Primitive::value() const
 {
   if (Primitive::typeOf<int>() == m_type) {
-    auto const& c = static_cast<TypedContent<long> const&>(*m_content);
-    return static_cast<int>(c.value());
+    return static_cast<int>(m_long);
   }
   throw std::logic_error("Bad type conversion");
 }
@@ -315,7 +304,7 @@ inline long
 Primitive::value() const
 {
   if (Primitive::typeOf<long>() == m_type) {
-    return static_cast<TypedContent<long> const&>(*m_content).value();
+    return m_long;
   }
   throw std::logic_error("Bad type conversion");
 }
@@ -325,8 +314,7 @@ inline float
 Primitive::value() const
 {
   if (Primitive::typeOf<float>() == m_type) {
-    auto const& c = static_cast<TypedContent<double> const&>(*m_content);
-    return static_cast<float>(c.value());
+    return static_cast<float>(m_double);
   }
   throw std::logic_error("Bad type conversion");
 }
@@ -336,7 +324,7 @@ inline std::string
 Primitive::value() const
 {
   if (Primitive::typeOf<std::string>() == m_type) {
-    return static_cast<TypedContent<std::string> const&>(*m_content).value();
+    return std::string(m_text.data, m_text.size);
   }
   throw std::logic_error("Bad type conversion");
 }
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "Path.h"
+#include "Value.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ace { namespace tree {
+
+/**
+ * Compiled path query.
+ *
+ * A query compiles a set of paths into an automaton whose states are the items
+ * of the paths. The automaton is run in a single depth-first pass over a tree,
+ * and the values matched by each path are streamed to a callback in document
+ * order, along with the index of the matching path. A value is reported at
+ * most once per path.
+ */
+class Query
+{
+public:
+  using Callback = std::function<void(const size_t, Value&)>;
+  using ConstCallback = std::function<void(const size_t, Value const&)>;
+
+  Query() = default;
+  explicit Query(Path const& p);
+  explicit Query(std::vector<Path> const& p);
+
+  size_t add(Path const& p);
+  size_t size() const;
+
+  void run(Value& v, Callback const& cb) const;
+  void run(Value const& v, ConstCallback const& cb) const;
+
+private:
+  static constexpr size_t npos = size_t(-1); // NOLINT
+
+  struct State
+  {
+    path::Item::Ref item;
+    size_t path;
+    size_t next;
+  };
+
+  using States = std::vector<size_t>;
+
+  void step(Value const& p, Value const& v, common::Symbol const& k,
+            const size_t idx, States const& s, States& r,
+            ConstCallback const& cb) const;
+  void visit(Value const& v, States const& s, ConstCallback const& cb) const;
+
+  std::vector<State> m_states;
+  std::vector<size_t> m_starts;
+  std::vector<bool> m_globals;
+};
+
+}}
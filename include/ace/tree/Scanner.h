@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "Handler.h"
 #include "Object.h"
 #include <list>
 #include <memory>
@@ -49,6 +50,22 @@ public:
   virtual Value::Ref parse(std::string const& s, int argc, char** argv) = 0;
   virtual void dump(Value const& v, const Format f, std::ostream& o) const = 0;
 
+  /**
+   * @brief      Scan a file, emitting its content to a handler
+   * @param fn   the file name
+   * @param argc the argument count
+   * @param argv the argument vector
+   * @param h    the handler
+   * @return     true in case of success, false otherwise
+   *
+   * The default implementation opens the file and walks the resulting tree.
+   * Formats able to read a file without building a document first override
+   * it, and implement open() on top of it using a Builder. Only YAML does so
+   * for now, which spares it the yaml-cpp document. The validation of a model
+   * still works on the tree returned by open().
+   */
+  virtual bool scan(std::string const& fn, int argc, char** argv, Handler& h);
+
   virtual bool openAll(std::string const& fn, int argc, char** argv,
                        std::list<Value::Ref>& values) = 0;
   virtual bool parseAll(std::string const& s, int argc, char** argv,
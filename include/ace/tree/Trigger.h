@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "Path.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ace { namespace tree {
+
+/**
+ * Trigger index.
+ *
+ * An index holds a set of trigger paths and finds the first one, in insertion
+ * order, that matches a given path, as Path::match() does. Triggers are stored
+ * in a trie over their leading named and wildcard items. A lookup walks the
+ * trie along the path, so that only the triggers found on the way are matched.
+ */
+class Trigger
+{
+public:
+  static constexpr size_t npos = size_t(-1); // NOLINT
+
+  Trigger();
+
+  size_t add(Path const& p);
+  size_t size() const;
+  void clear();
+
+  /**
+   * @brief Find the first trigger matching a path
+   * @return the index of the trigger, or npos
+   */
+  size_t find(Path const& p) const;
+
+  Path const& at(const size_t i) const;
+
+private:
+  struct Node
+  {
+    std::unordered_map<std::string, size_t> named;
+    size_t any;
+    std::vector<size_t> complete;
+    std::vector<size_t> partial;
+  };
+
+  void find(Path const& p, Path::const_iterator const& i, const size_t n,
+            size_t& r) const;
+
+  std::vector<Node> m_nodes;
+  std::vector<Path> m_paths;
+};
+
+}}
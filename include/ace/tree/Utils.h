@@ -73,40 +73,34 @@ apply(Value& v, C<std::string, std::allocator<std::string>> const& stms)
   return true;
 }
 
+/**
+ * The following accessors work on values that have already been looked up and
+ * are used by the generated code. A null value means that the option is absent.
+ */
+
 template<typename T>
 bool
-parsePrimitive(Object const& r, std::string const& k, T& l)
+parsePrimitive(const Value* v, T& l)
 {
-  auto path = tree::Path::parse(k);
-  if (not r.has(path)) {
-    ACE_LOG(Info, "Path \"", path.toString(), "\" not found");
-    return false;
-  }
-  tree::Value const& v = r.get(path);
-  if (not v.isPrimitive()) {
+  if (v == nullptr or not v->isPrimitive()) {
     return false;
   }
-  tree::Primitive const& w = static_cast<tree::Primitive const&>(v);
-  l = w.value<T>();
+  l = static_cast<tree::Primitive const*>(v)->value<T>();
   return true;
 }
 
 template<typename T>
 void
-parsePrimitive(Object const& r, std::string const& k, std::vector<T>& l)
+parsePrimitive(const Value* v, std::vector<T>& l)
 {
-  auto path = tree::Path::parse(k);
-  if (not r.has(path)) {
-    ACE_LOG(Info, "Path \"", path.toString(), "\" not found");
+  if (v == nullptr) {
     return;
   }
   l.clear();
-  tree::Value const& v = r.get(path);
-  if (v.isPrimitive()) {
-    tree::Primitive const& w = static_cast<tree::Primitive const&>(v);
-    l.push_back(w.value<T>());
-  } else if (v.type() == Value::Type::Array) {
-    Array const& p = static_cast<tree::Array const&>(v);
+  if (v->isPrimitive()) {
+    l.push_back(static_cast<tree::Primitive const*>(v)->value<T>());
+  } else if (v->type() == Value::Type::Array) {
+    Array const& p = static_cast<tree::Array const&>(*v);
     for (auto& e : p) {
       tree::Primitive const& w = static_cast<tree::Primitive const&>(*e);
       l.push_back(w.value<T>());
@@ -116,18 +110,70 @@ parsePrimitive(Object const& r, std::string const& k, std::vector<T>& l)
 
 template<typename T>
 bool
-parseObject(Object const& r, std::string const& k, typename T::Ref& l)
+parseObject(const Value* v, typename T::Ref& l)
+{
+  if (v == nullptr or not v->isObject()) {
+    return false;
+  }
+  l = T::build(*v);
+  return true;
+}
+
+template<typename T>
+void
+parseObject(const Value* v, std::vector<typename T::Ref>& l)
+{
+  if (v == nullptr) {
+    return;
+  }
+  l.clear();
+  if (v->type() == Value::Type::Object) {
+    l.push_back(T::build(*v));
+  } else if (v->type() == Value::Type::Array) {
+    Array const& p = static_cast<tree::Array const&>(*v);
+    for (auto& e : p) {
+      l.push_back(T::build(*e));
+    }
+  }
+}
+
+/**
+ * The following accessors look values up by path.
+ */
+
+template<typename T>
+bool
+parsePrimitive(Object const& r, std::string const& k, T& l)
 {
   auto path = tree::Path::parse(k);
   if (not r.has(path)) {
+    ACE_LOG(Info, "Path \"", path.toString(), "\" not found");
     return false;
   }
-  tree::Value const& v = r.get(path);
-  if (not v.isObject()) {
+  return parsePrimitive(&r.get(path), l);
+}
+
+template<typename T>
+void
+parsePrimitive(Object const& r, std::string const& k, std::vector<T>& l)
+{
+  auto path = tree::Path::parse(k);
+  if (not r.has(path)) {
+    ACE_LOG(Info, "Path \"", path.toString(), "\" not found");
+    return;
+  }
+  parsePrimitive(&r.get(path), l);
+}
+
+template<typename T>
+bool
+parseObject(Object const& r, std::string const& k, typename T::Ref& l)
+{
+  auto path = tree::Path::parse(k);
+  if (not r.has(path)) {
     return false;
   }
-  l = T::build(v);
-  return true;
+  return parseObject<T>(&r.get(path), l);
 }
 
 template<typename T>
@@ -139,16 +185,7 @@ parseObject(Object const& r, std::string const& k,
   if (not r.has(path)) {
     return;
   }
-  l.clear();
-  tree::Value const& v = r.get(path);
-  if (v.type() == Value::Type::Object) {
-    l.push_back(T::build(v));
-  } else if (v.type() == Value::Type::Array) {
-    Array const& p = static_cast<tree::Array const&>(v);
-    for (auto& e : p) {
-      l.push_back(T::build(*e));
-    }
-  }
+  parseObject<T>(&r.get(path), l);
 }
 
 template<typename T>
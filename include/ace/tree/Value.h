@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <ace/common/Symbol.h>
 #include <ace/tree/Path.h>
 #include <functional>
 #include <memory>
@@ -123,6 +124,7 @@ public:
 
   void setName(std::string const& n);
   std::string const& name() const;
+  common::Symbol const& symbol() const;
 
   Type type() const;
   template<typename T>
@@ -145,7 +147,7 @@ protected:
   virtual bool put(Path const& p, Path::const_iterator const& i,
                    Value::Ref const& r);
 
-  std::string m_name;
+  common::Symbol m_name;
   Type m_type;
   Value* m_parent;
 
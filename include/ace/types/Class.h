@@ -60,10 +60,13 @@ public:
   bool flattenInstance(tree::Object& r, tree::Value& v);
   bool resolveInstance(tree::Object const& r, tree::Value const& v) const;
 
+  void collectProbes(tree::Value const& v, Probes& p) const;
+
   // Coach
 
-  void display(Coach::Branch const& br) const;
-  bool explain(tree::Path const& p, tree::Path::const_iterator const& i) const;
+  void display(std::ostream& o, Coach::Branch const& br) const;
+  bool explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const;
 
   // Generator
 
@@ -64,6 +64,8 @@ public:
 
   bool validateModel();
 
+  void collectProbes(tree::Value const& v, Probes& p) const;
+
   void collectInterfaceIncludes(std::set<std::string>& i) const;
   void collectImplementationIncludes(std::set<std::string>& i) const;
 
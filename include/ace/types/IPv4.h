@@ -39,7 +39,18 @@ public:
   explicit IPv4FormatChecker(const BasicType* o);
   bool operator()(tree::Object const& r, tree::Value const& v) const;
 
-  static bool checkFormat(std::string const& s);
+  /**
+   * @brief Check an address, or a host name
+   * @param s the value to check
+   * @param p accept a CIDR prefix after the address
+   *
+   * Host names are only checked syntactically, unless host name resolution
+   * is enabled in common::Resolver.
+   */
+  static bool checkFormat(std::string const& s, const bool p = false);
+
+  static bool isAddress(std::string const& s, const bool p = false);
+  static bool isHostName(std::string const& s);
 };
 
 // IPv4 class
@@ -51,6 +62,8 @@ class IPv4
 public:
   IPv4();
 
+  void collectProbes(tree::Value const& v, Probes& p) const;
+
   void collectInterfaceIncludes(std::set<std::string>& i) const;
   void collectImplementationIncludes(std::set<std::string>& i) const;
 
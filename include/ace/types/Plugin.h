@@ -26,12 +26,15 @@
 #include <ace/model/FormatChecker.h>
 #include <ace/model/Model.h>
 #include <ace/types/Class.h>
+#include <ace/tree/Trigger.h>
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
+#include <pthread.h>
 
 namespace ace { namespace model {
 
@@ -64,8 +67,9 @@ public:
 
   // Coach
 
-  void display(Coach::Branch const& br) const;
-  bool explain(tree::Path const& p, tree::Path::const_iterator const& i) const;
+  void display(std::ostream& o, Coach::Branch const& br) const;
+  bool explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const;
 
   // Generator
 
@@ -116,10 +120,28 @@ public:
   std::map<tree::Path, Class::Ref> const& plugins() const;
 
 private:
+  struct Children
+  {
+    Children();
+    ~Children();
+
+    std::map<tree::Path, std::string> models;
+    std::map<tree::Path, Class::Ref> loaded;
+    pthread_mutex_t lock;
+  };
+
+  Class::Ref find(tree::Path const& path) const;
+  Class::Ref load(tree::Path const& trigger) const;
+  Class::Ref buildChild(std::string const& name) const;
+  void loadAll() const;
+  void index();
+
   Model::Ref m_model;
   Arity m_targetArity;
-  std::map<tree::Path, Class::Ref> m_plugins;
+  mutable std::map<tree::Path, Class::Ref> m_plugins;
   std::map<tree::Path, Class::Ref> m_instances;
+  std::shared_ptr<Children> m_children;
+  tree::Trigger m_triggers;
 };
 
 }}
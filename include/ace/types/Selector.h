@@ -74,8 +74,9 @@ public:
 
   // Coach
 
-  void display(Coach::Branch const& br) const;
-  bool explain(tree::Path const& p, tree::Path::const_iterator const& i) const;
+  void display(std::ostream& o, Coach::Branch const& br) const;
+  bool explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const;
 
   // Basic Type
 
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <ace/common/Regex.h>
 #include <ace/model/EnumeratedType.h>
 #include <ace/model/RangeAttribute.h>
 #include <functional>
@@ -50,7 +51,7 @@ public:
 
 private:
   common::Range<long> m_length;
-  std::string m_match;
+  common::Regex::Pattern m_match;
 };
 
 }}
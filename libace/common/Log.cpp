@@ -61,6 +61,32 @@ static const char levelCode[7] = {
   'A'  // All
 };
 
+// Capture class
+
+static __thread Log::Capture* s_capture = nullptr;
+
+Log::Capture::Capture() : m_previous(s_capture), m_errors()
+{
+  s_capture = this;
+}
+
+Log::Capture::~Capture()
+{
+  s_capture = m_previous;
+}
+
+std::string
+Log::Capture::str() const
+{
+  return m_errors.str();
+}
+
+Log::Capture*
+Log::Capture::current()
+{
+  return s_capture;
+}
+
 // Channel class
 
 Log::Channel::Channel()
@@ -21,105 +21,212 @@
  */
 
 #include <ace/common/Regex.h>
+#include <pthread.h>
 #include <set>
-#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <locale>
 #include <re2/re2.h>
 
 #define ESCAPE_CHAR '\\'
 
 namespace {
 
-static bool
-expansion_count(std::string const& p, int& r)
+/*
+ * Compiled expression cache, shared by all the patterns. It is flushed when
+ * full, which only happens when patterns are built from arbitrary input.
+ */
+
+static const size_t CACHE_CAPACITY = 1024;
+
+struct Cache
+{
+  Cache() : lock(), entries() { pthread_mutex_init(&lock, nullptr); }
+
+  pthread_mutex_t lock;
+  std::unordered_map<std::string, std::shared_ptr<const RE2>> entries;
+};
+
+static Cache&
+cache()
+{
+  static Cache* s_cache = new Cache;
+  return *s_cache;
+}
+
+static std::shared_ptr<const RE2>
+compile(std::string const& r)
+{
+  Cache& c = cache();
+  pthread_mutex_lock(&c.lock);
+  auto it = c.entries.find(r);
+  if (it != c.entries.end()) {
+    auto re = it->second;
+    pthread_mutex_unlock(&c.lock);
+    return re;
+  }
+  pthread_mutex_unlock(&c.lock);
+  /*
+   * Compile outside of the lock. Concurrent compilations of the same source
+   * are harmless, the first one inserted wins.
+   */
+  auto re = std::make_shared<const RE2>(r, RE2::Quiet);
+  pthread_mutex_lock(&c.lock);
+  if (c.entries.size() >= CACHE_CAPACITY) {
+    c.entries.clear();
+  }
+  auto res = c.entries.emplace(r, re).first->second;
+  pthread_mutex_unlock(&c.lock);
+  return res;
+}
+
+}
+
+namespace ace { namespace common { namespace Regex {
+
+// Rewrite
+
+Rewrite::Rewrite()
+  : m_source(), m_literals(1), m_groups(), m_captures(0), m_ok(true)
+{}
+
+Rewrite::Rewrite(std::string const& p)
+  : m_source(p), m_literals(1), m_groups(), m_captures(0), m_ok(false)
 {
   bool esc = false;
-  std::locale loc;
   std::set<size_t> occs;
   for (auto& c : p) {
     if (c == ESCAPE_CHAR) {
+      if (esc) {
+        m_literals.back().push_back(c);
+      }
       esc = not esc;
     } else if (esc) {
-      if (std::isdigit(c, loc)) {
+      if (c >= '0' and c <= '9') {
         occs.insert(c - '0');
+        m_groups.push_back(c - '0');
+        m_literals.emplace_back();
       }
       esc = false;
+    } else {
+      m_literals.back().push_back(c);
     }
   }
   if (esc) {
-    return false;
+    return;
   }
   if (not occs.empty() and occs.size() != *occs.rbegin()) {
-    return false;
+    return;
   }
-  r = occs.size();
-  return true;
+  m_captures = occs.size();
+  m_ok = true;
 }
 
-static std::string
-expand_string(std::string const& p, std::vector<std::string> const& x)
+bool
+Rewrite::ok() const
 {
-  bool esc = false;
-  std::locale loc;
-  std::ostringstream oss;
-  for (auto& c : p) {
-    if (c == ESCAPE_CHAR) {
-      if (esc) {
-        oss << c;
-      }
-      esc = not esc;
-    } else if (esc) {
-      if (std::isdigit(c, loc)) {
-        oss << x[c - '1'];
-      }
-      esc = false;
-    } else {
-      oss << c;
-    }
-  }
-  return oss.str();
+  return m_ok;
 }
 
+size_t
+Rewrite::captures() const
+{
+  return m_captures;
 }
 
-namespace ace { namespace common { namespace Regex {
+std::string const&
+Rewrite::source() const
+{
+  return m_source;
+}
+
+std::string
+Rewrite::apply(std::vector<std::string> const& x) const
+{
+  std::string r = m_literals[0];
+  for (size_t i = 0; i < m_groups.size(); i += 1) {
+    r += x[m_groups[i] - 1];
+    r += m_literals[i + 1];
+  }
+  return r;
+}
+
+// Pattern
+
+Pattern::Pattern() : m_source(), m_regex() {}
+
+Pattern::Pattern(std::string const& r) : m_source(r), m_regex(compile(r)) {}
 
 bool
-check(std::string const& r)
+Pattern::ok() const
 {
-  RE2 re(r, RE2::Quiet);
-  return re.ok();
+  return m_regex != nullptr and m_regex->ok();
 }
 
 bool
-match(std::string const& s, std::string const& r)
+Pattern::empty() const
 {
-  return RE2::FullMatch(s, r);
+  return m_source.empty();
+}
+
+std::string const&
+Pattern::source() const
+{
+  return m_source;
 }
 
 bool
-expand(std::string const& s, std::string const& r, std::string const& p,
-       std::string& v)
+Pattern::match(std::string const& s) const
+{
+  if (not ok()) {
+    return false;
+  }
+  return m_regex->Match(s, 0, s.size(), RE2::ANCHOR_BOTH, nullptr, 0);
+}
+
+bool
+Pattern::expand(std::string const& s, Rewrite const& p, std::string& v) const
 {
-  int n = 0;
-  if (not expansion_count(p, n)) {
+  if (not ok() or not p.ok()) {
     return false;
   }
-  const RE2::Arg* args[n];
-  std::vector<std::string> exps(n);
-  for (int i = 0; i < n; i += 1) {
-    args[i] = new RE2::Arg(&exps[i]);
+  int n = static_cast<int>(p.captures());
+  if (n > m_regex->NumberOfCapturingGroups()) {
+    return false;
   }
-  if (not RE2::FullMatchN(s, r, args, n)) {
+  std::vector<re2::StringPiece> subs(n + 1);
+  if (not m_regex->Match(s, 0, s.size(), RE2::ANCHOR_BOTH, subs.data(),
+                         n + 1)) {
     return false;
   }
-  for (int i = 0; i < n; i += 1) {
-    delete args[i];
+  std::vector<std::string> exps;
+  exps.reserve(n);
+  for (int i = 1; i <= n; i += 1) {
+    exps.emplace_back(subs[i].data(), subs[i].size());
   }
-  v = expand_string(p, exps);
+  v = p.apply(exps);
   return true;
 }
 
+// Helpers
+
+bool
+check(std::string const& r)
+{
+  return Pattern(r).ok();
+}
+
+bool
+match(std::string const& s, std::string const& r)
+{
+  return Pattern(r).match(s);
+}
+
+bool
+expand(std::string const& s, std::string const& r, std::string const& p,
+       std::string& v)
+{
+  return Pattern(r).expand(s, Rewrite(p), v);
+}
+
 }}}
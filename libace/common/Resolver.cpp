@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/common/Resolver.h>
+#include <ace/common/Log.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+#include <netdb.h>
+
+#ifdef __OpenBSD__
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+/*
+ * Maximum number of concurrent lookups, default deadline of a call, and
+ * default lifetime of the cached results.
+ */
+
+static const size_t MAX_LOOKUPS = 64;
+static const long DEFAULT_TIMEOUT = 1000;
+static const long DEFAULT_TTL = 60000;
+
+/*
+ * State shared by the lookups of a batch. Lookups still running past the
+ * deadline keep it alive until they complete.
+ */
+
+struct Batch
+{
+  Batch() : lock(), done(), pending(0), results()
+  {
+    pthread_mutex_init(&lock, nullptr);
+    pthread_cond_init(&done, nullptr);
+  }
+
+  ~Batch()
+  {
+    pthread_cond_destroy(&done);
+    pthread_mutex_destroy(&lock);
+  }
+
+  pthread_mutex_t lock;
+  pthread_cond_t done;
+  size_t pending;
+  std::map<std::string, bool> results;
+};
+
+struct Lookup
+{
+  std::shared_ptr<Batch> batch;
+  std::string host;
+};
+
+static bool
+resolve(std::string const& host)
+{
+  struct addrinfo hints, *result = nullptr;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  int r = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+  if (result != nullptr) {
+    freeaddrinfo(result);
+  }
+  return r == 0;
+}
+
+static void*
+run(void* arg)
+{
+  std::unique_ptr<Lookup> l(static_cast<Lookup*>(arg));
+  bool r = resolve(l->host);
+  pthread_mutex_lock(&l->batch->lock);
+  l->batch->results[l->host] = r;
+  l->batch->pending -= 1;
+  pthread_cond_signal(&l->batch->done);
+  pthread_mutex_unlock(&l->batch->lock);
+  return nullptr;
+}
+
+static struct timespec
+deadline(const long ms)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += ms / 1000;
+  ts.tv_nsec += (ms % 1000) * 1000000;
+  if (ts.tv_nsec >= 1000000000) {
+    ts.tv_sec += 1;
+    ts.tv_nsec -= 1000000000;
+  }
+  return ts;
+}
+
+static bool
+expired(struct timespec const& ts)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  return now.tv_sec > ts.tv_sec or
+         (now.tv_sec == ts.tv_sec and now.tv_nsec >= ts.tv_nsec);
+}
+
+/*
+ * Monotonic time in milliseconds, for the lifetime of the cached results.
+ */
+
+static long
+now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void
+resolveBatch(std::vector<std::string> const& hosts, struct timespec const& ts,
+             std::map<std::string, bool>& r)
+{
+  auto batch = std::make_shared<Batch>();
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  for (auto& h : hosts) {
+    pthread_t tid;
+    pthread_mutex_lock(&batch->lock);
+    batch->pending += 1;
+    pthread_mutex_unlock(&batch->lock);
+    if (pthread_create(&tid, &attr, run, new Lookup{ batch, h }) != 0) {
+      pthread_mutex_lock(&batch->lock);
+      batch->pending -= 1;
+      batch->results[h] = resolve(h);
+      pthread_mutex_unlock(&batch->lock);
+    }
+  }
+  pthread_attr_destroy(&attr);
+  pthread_mutex_lock(&batch->lock);
+  while (batch->pending > 0) {
+    if (pthread_cond_timedwait(&batch->done, &batch->lock, &ts) == ETIMEDOUT) {
+      break;
+    }
+  }
+  for (auto& h : hosts) {
+    auto it = batch->results.find(h);
+    if (it == batch->results.end()) {
+      ACE_LOG(Warning, "Resolution of \"", h, "\" timed out");
+      r[h] = false;
+    } else {
+      r[h] = it->second;
+    }
+  }
+  pthread_mutex_unlock(&batch->lock);
+}
+
+}
+
+namespace ace { namespace common {
+
+Resolver::Resolver()
+  : m_enabled(false)
+  , m_timeout(DEFAULT_TIMEOUT)
+  , m_ttl(DEFAULT_TTL)
+  , m_cache()
+  , m_lock()
+{
+  pthread_mutex_init(&m_lock, nullptr);
+}
+
+Resolver::~Resolver()
+{
+  pthread_mutex_destroy(&m_lock);
+}
+
+Resolver&
+Resolver::get()
+{
+  static Resolver s_resolver;
+  return s_resolver;
+}
+
+void
+Resolver::setEnabled(const bool e)
+{
+  m_enabled = e;
+}
+
+bool
+Resolver::enabled() const
+{
+  return m_enabled;
+}
+
+void
+Resolver::setTimeout(const long ms)
+{
+  m_timeout = ms;
+}
+
+long
+Resolver::timeout() const
+{
+  return m_timeout;
+}
+
+void
+Resolver::setTimeToLive(const long ms)
+{
+  m_ttl = ms;
+}
+
+long
+Resolver::timeToLive() const
+{
+  return m_ttl;
+}
+
+void
+Resolver::resolve(std::set<std::string> const& hosts)
+{
+  std::vector<std::string> missing;
+  for (auto& h : hosts) {
+    bool r;
+    if (not lookup(h, r)) {
+      missing.push_back(h);
+    }
+  }
+  struct timespec ts = deadline(m_timeout);
+  std::map<std::string, bool> results;
+  for (size_t i = 0; i < missing.size(); i += MAX_LOOKUPS) {
+    size_t n = std::min(MAX_LOOKUPS, missing.size() - i);
+    if (expired(ts)) {
+      for (size_t j = i; j < missing.size(); j += 1) {
+        ACE_LOG(Warning, "Resolution of \"", missing[j], "\" timed out");
+        results[missing[j]] = false;
+      }
+      break;
+    }
+    std::vector<std::string> chunk(missing.begin() + i,
+                                   missing.begin() + i + n);
+    resolveBatch(chunk, ts, results);
+  }
+  long expires = now() + m_ttl;
+  pthread_mutex_lock(&m_lock);
+  for (auto& e : results) {
+    m_cache[e.first] = { e.second, expires };
+  }
+  pthread_mutex_unlock(&m_lock);
+}
+
+bool
+Resolver::resolved(std::string const& host)
+{
+  bool r = false;
+  if (not lookup(host, r)) {
+    resolve({ host });
+    lookup(host, r);
+  }
+  return r;
+}
+
+void
+Resolver::clear()
+{
+  pthread_mutex_lock(&m_lock);
+  m_cache.clear();
+  pthread_mutex_unlock(&m_lock);
+}
+
+bool
+Resolver::lookup(std::string const& host, bool& r) const
+{
+  pthread_mutex_lock(&m_lock);
+  auto it = m_cache.find(host);
+  bool found = it != m_cache.end() and it->second.expires > now();
+  if (found) {
+    r = it->second.resolved;
+  }
+  pthread_mutex_unlock(&m_lock);
+  return found;
+}
+
+}}
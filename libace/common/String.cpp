@@ -21,12 +21,199 @@
  */
 
 #include <ace/common/String.h>
+#include <charconv>
 #include <iomanip>
 #include <functional>
 #include <limits>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+namespace {
+
+/*
+ * The parsers below follow the rules of the input streams: leading spaces are
+ * skipped, the longest valid prefix is read, and a failure yields 0, or the
+ * closest limit on overflow.
+ */
+
+bool
+digit(const char c)
+{
+  return c >= '0' and c <= '9';
+}
+
+const char*
+skipSpaces(const char* p, const char* e)
+{
+  while (p < e and (*p == ' ' or (*p >= '\t' and *p <= '\r'))) {
+    p += 1;
+  }
+  return p;
+}
+
+/*
+ * End of the integer at the head of a buffer, or nullptr.
+ */
+const char*
+scanInteger(const char* p, const char* e)
+{
+  if (p < e and (*p == '+' or *p == '-')) {
+    p += 1;
+  }
+  const char* d = p;
+  while (p < e and digit(*p)) {
+    p += 1;
+  }
+  return p == d ? nullptr : p;
+}
+
+/*
+ * End of the real number at the head of a buffer, or nullptr. A stream reads
+ * an exponent marker whenever it follows a digit, and then fails if no digits
+ * come after it.
+ */
+const char*
+scanReal(const char* p, const char* e)
+{
+  size_t n = 0;
+  if (p < e and (*p == '+' or *p == '-')) {
+    p += 1;
+  }
+  for (; p < e and digit(*p); p += 1) {
+    n += 1;
+  }
+  if (p < e and *p == '.') {
+    for (p += 1; p < e and digit(*p); p += 1) {
+      n += 1;
+    }
+  }
+  if (n == 0) {
+    return nullptr;
+  }
+  if (p < e and (*p == 'e' or *p == 'E')) {
+    p += 1;
+    if (p < e and (*p == '+' or *p == '-')) {
+      p += 1;
+    }
+    const char* d = p;
+    while (p < e and digit(*p)) {
+      p += 1;
+    }
+    if (p == d) {
+      return nullptr;
+    }
+  }
+  return p;
+}
+
+/*
+ * Whether an out-of-range real number is too large, rather than too small, by
+ * the decimal exponent of its first significant digit.
+ */
+bool
+overflows(const char* p, const char* e)
+{
+  long mag = 0, pos = 0;
+  bool found = false;
+  for (; p < e and (digit(*p) or *p == '-'); p += 1) {
+    if (digit(*p) and (found or *p != '0')) {
+      found = true;
+      mag += 1;
+    }
+  }
+  mag -= 1;
+  if (p < e and *p == '.') {
+    for (p += 1; p < e and digit(*p); p += 1) {
+      pos += 1;
+      if (not found and *p != '0') {
+        found = true;
+        mag = -pos;
+      }
+    }
+  }
+  if (p < e and (*p == 'e' or *p == 'E')) {
+    p += *(p + 1) == '+' ? 2 : 1;
+    long exp = 0;
+    if (std::from_chars(p, e, exp).ec != std::errc()) {
+      return *p != '-';
+    }
+    mag += exp;
+  }
+  return mag > 0;
+}
+
+bool
+parseBool(std::string const& s, bool& r)
+{
+  const char* e = s.data() + s.size();
+  std::string_view v(skipSpaces(s.data(), e));
+  v = v.substr(0, static_cast<size_t>(e - v.data()));
+  r = false;
+  if (v.compare(0, 4, "true") == 0) {
+    r = true;
+    return true;
+  }
+  return v.compare(0, 5, "false") == 0;
+}
+
+template<typename T>
+bool
+parseInteger(std::string const& s, T& r)
+{
+  const char* e = s.data() + s.size();
+  const char* b = skipSpaces(s.data(), e);
+  const char* end = scanInteger(b, e);
+  r = 0;
+  if (end == nullptr) {
+    return false;
+  }
+  /*
+   * Signed values keep their sign so that the lowest value does not overflow.
+   * Streams read negative unsigned values as the wrapped negation.
+   */
+  bool neg = *b == '-';
+  bool wrap = neg and not std::is_signed<T>::value;
+  b += wrap or *b == '+' ? 1 : 0;
+  if (std::from_chars(b, end, r).ec != std::errc()) {
+    bool low = neg and std::is_signed<T>::value;
+    r = low ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    return false;
+  }
+  if (wrap) {
+    r = static_cast<T>(0 - r);
+  }
+  return true;
+}
+
+bool
+parseReal(std::string const& s, double& r)
+{
+  const char* e = s.data() + s.size();
+  const char* b = skipSpaces(s.data(), e);
+  const char* end = scanReal(b, e);
+  r = 0;
+  if (end == nullptr) {
+    return false;
+  }
+  bool neg = *b == '-';
+  b += *b == '+' ? 1 : 0;
+  auto res = std::from_chars(b, end, r);
+  if (res.ec == std::errc::result_out_of_range) {
+    if (overflows(b, end)) {
+      r = std::numeric_limits<double>::max();
+      r = neg ? -r : r;
+      return false;
+    }
+    r = neg ? -0.0 : 0.0;
+    return true;
+  }
+  return res.ec == std::errc();
+}
+
+}
+
 namespace ace { namespace common { namespace String {
 
 std::ostream&
@@ -38,6 +225,14 @@ indent(std::ostream& o, int l)
   return o;
 }
 
+template<>
+bool
+is<bool>(std::string const& s)
+{
+  bool r;
+  return parseBool(s, r);
+}
+
 template<>
 bool
 is<long>(std::string const& s)
@@ -48,54 +243,67 @@ is<long>(std::string const& s)
     }
   }
   long r;
-  std::istringstream iss(s);
-  iss >> std::boolalpha >> r;
-  return (iss.rdstate() & (std::istream::failbit | std::istream::badbit)) == 0;
+  return parseInteger(s, r);
 }
 
 template<>
 bool
 is<double>(std::string const& s)
 {
+  size_t dots = 0, lower = 0, upper = 0;
   for (auto& c : s) {
     if (not isdigit(c)) {
       switch (c) {
         case '.':
-        case '-':
-        case '+':
+          dots += 1;
+          break;
         case 'e':
+          lower += 1;
+          break;
         case 'E':
+          upper += 1;
+          break;
+        case '-':
+        case '+':
           break;
         default:
           return false;
       }
     }
   }
-  if (s.find_first_of('.') == std::string::npos and
-      s.find_first_of('e') == std::string::npos and
-      s.find_first_of('E') == std::string::npos) {
-    return false;
-  }
-  if (s.find_first_of('.') != std::string::npos and
-      s.find_first_of('.') != s.find_last_of('.')) {
-    return false;
-  }
-  if (s.find_first_of('e') != std::string::npos and
-      s.find_first_of('e') != s.find_last_of('e')) {
-    return false;
-  }
-  if (s.find_first_of('E') != std::string::npos and
-      s.find_first_of('E') != s.find_last_of('E')) {
-    return false;
-  }
-  if (s.find_first_of('e') != std::string::npos and
-      s.find_first_of('E') != std::string::npos) {
+  if (dots + lower + upper == 0 or dots > 1 or lower > 1 or upper > 1 or
+      (lower > 0 and upper > 0)) {
     return false;
   }
   double r;
-  std::istringstream iss(s);
-  iss >> std::boolalpha >> r;
-  return (iss.rdstate() & (std::istream::failbit | std::istream::badbit)) == 0;
+  return parseReal(s, r);
+}
+
+template<>
+bool
+value<bool>(std::string const& s)
+{
+  bool r;
+  parseBool(s, r);
+  return r;
+}
+
+template<>
+long
+value<long>(std::string const& s)
+{
+  long r;
+  parseInteger(s, r);
+  return r;
+}
+
+template<>
+unsigned long
+value<unsigned long>(std::string const& s)
+{
+  unsigned long r;
+  parseInteger(s, r);
+  return r;
 }
 
 template<>
@@ -103,8 +311,7 @@ double
 value<double>(std::string const& s)
 {
   double r;
-  std::istringstream iss(s);
-  iss >> std::boolalpha >> r;
+  parseReal(s, r);
   return r;
 }
 
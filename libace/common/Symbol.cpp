@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/common/Symbol.h>
+#include <pthread.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ace { namespace common {
+
+/*
+ * The keys of the shards are views on the interned strings, along with their
+ * hash so that strings are hashed only once. An entry is removed from its shard
+ * before it is released.
+ */
+struct Symbol::Table
+{
+  static constexpr size_t SHARDS = 64; // NOLINT
+
+  struct Key
+  {
+    std::string_view value;
+    size_t hash;
+
+    bool operator==(Key const& o) const { return value == o.value; }
+  };
+
+  struct Hash
+  {
+    size_t operator()(Key const& k) const { return k.hash; }
+  };
+
+  struct Shard
+  {
+    Shard() : index(), lock(PTHREAD_MUTEX_INITIALIZER) {}
+
+    std::unordered_map<Key, const Entry*, Hash> index;
+    pthread_mutex_t lock;
+  };
+
+  Shard& shard(const size_t hash) { return shards[(hash >> 7) % SHARDS]; }
+
+  Shard shards[SHARDS];
+};
+
+/*
+ * The table is built on first use and never destroyed, so that the symbols held
+ * by static objects remain valid until the very end of the process.
+ */
+Symbol::Table&
+Symbol::table()
+{
+  static Table* s_table = new Table;
+  return *s_table;
+}
+
+/*
+ * The empty string is the default value of every tree value. It is shared by
+ * all the threads and is never released, so it is not reference-counted.
+ */
+const Symbol::Entry*
+Symbol::blank()
+{
+  static const Entry* s_empty =
+    new Entry{ std::string(), std::hash<std::string>()(std::string()), { 1 } };
+  return s_empty;
+}
+
+Symbol::Symbol() : m_entry(blank()) {}
+
+Symbol::Symbol(std::string const& s) : m_entry(intern(s)) {}
+
+Symbol::Symbol(const char* s) : m_entry(intern(s)) {}
+
+Symbol::Symbol(Symbol const& o) : m_entry(o.m_entry)
+{
+  acquire(m_entry);
+}
+
+Symbol::Symbol(Symbol&& o) noexcept : m_entry(o.m_entry)
+{
+  o.m_entry = blank();
+}
+
+Symbol::~Symbol()
+{
+  release(m_entry);
+}
+
+Symbol&
+Symbol::operator=(Symbol const& o)
+{
+  if (m_entry != o.m_entry) {
+    acquire(o.m_entry);
+    release(m_entry);
+    m_entry = o.m_entry;
+  }
+  return *this;
+}
+
+Symbol&
+Symbol::operator=(Symbol&& o) noexcept
+{
+  if (this != &o) {
+    release(m_entry);
+    m_entry = o.m_entry;
+    o.m_entry = blank();
+  }
+  return *this;
+}
+
+size_t
+Symbol::count()
+{
+  Table& t = table();
+  size_t result = 1;
+  for (auto& s : t.shards) {
+    pthread_mutex_lock(&s.lock);
+    result += s.index.size();
+    pthread_mutex_unlock(&s.lock);
+  }
+  return result;
+}
+
+const Symbol::Entry*
+Symbol::intern(std::string const& s)
+{
+  if (s.empty()) {
+    return blank();
+  }
+  size_t hash = std::hash<std::string>()(s);
+  Table::Shard& shard = table().shard(hash);
+  pthread_mutex_lock(&shard.lock);
+  auto it = shard.index.find(Table::Key{ s, hash });
+  const Entry* result = nullptr;
+  if (it != shard.index.end()) {
+    result = it->second;
+    result->refs.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    result = new Entry{ s, hash, { 1 } };
+    shard.index.emplace(Table::Key{ result->value, hash }, result);
+  }
+  pthread_mutex_unlock(&shard.lock);
+  return result;
+}
+
+void
+Symbol::acquire(const Entry* e)
+{
+  if (e != blank()) {
+    e->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/*
+ * The last reference of an entry is dropped under the lock of its shard, so
+ * that a concurrent intern either finds the entry alive or does not find it.
+ */
+void
+Symbol::release(const Entry* e)
+{
+  if (e == blank()) {
+    return;
+  }
+  size_t refs = e->refs.load(std::memory_order_relaxed);
+  while (refs > 1) {
+    if (e->refs.compare_exchange_weak(refs, refs - 1,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  Table::Shard& shard = table().shard(e->hash);
+  pthread_mutex_lock(&shard.lock);
+  if (e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    shard.index.erase(Table::Key{ e->value, e->hash });
+    delete e;
+  }
+  pthread_mutex_unlock(&shard.lock);
+}
+
+}}
@@ -0,0 +1,223 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/engine/Context.h>
+#include <iomanip>
+#include <string>
+
+namespace {
+
+static __thread ace::engine::Context* s_current = nullptr;
+static __thread ace::engine::Context* s_default = nullptr;
+
+/*
+ * Erase the options found under a path.
+ */
+template<typename T>
+void
+eraseUnder(T& m, std::string const& p)
+{
+  auto it = m.upper_bound(p);
+  while (it != m.end() and it->first.compare(0, p.length(), p) == 0) {
+    char c = it->first[p.length()];
+    if (c == '.' or c == '[') {
+      it = m.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}
+
+namespace ace { namespace engine {
+
+Context::Scope::Scope(Context& c) : m_previous(s_current)
+{
+  s_current = &c;
+}
+
+Context::Scope::~Scope()
+{
+  s_current = m_previous;
+}
+
+bool
+Context::addModelPath(std::string const& mdp)
+{
+  if (m_modelPaths.count(mdp) != 0) {
+    return false;
+  }
+  m_modelPaths.insert(mdp);
+  return true;
+}
+
+void
+Context::remModelPath(std::string const& mdp)
+{
+  m_modelPaths.erase(mdp);
+}
+
+void
+Context::pushDefaulted(std::string const& p, std::string const& v)
+{
+  m_defaulted[p] = v;
+}
+
+void
+Context::pushInherited(std::string const& p, std::string const& f,
+                       std::string const& v)
+{
+  m_inherited[p] = { f, v };
+}
+
+/*
+ * The options under an injected object were injected along with it.
+ */
+
+bool
+Context::popInjected(std::string const& p)
+{
+  if (m_defaulted.erase(p) + m_inherited.erase(p) == 0) {
+    return false;
+  }
+  eraseUnder(m_defaulted, p);
+  eraseUnder(m_inherited, p);
+  return true;
+}
+
+void
+Context::pushPromoted(std::string const& p)
+{
+  m_promoted.insert(p);
+}
+
+void
+Context::pushUndefined(std::string const& p)
+{
+  m_undefined.insert(p);
+}
+
+void
+Context::pushUnexpected(std::string const& p)
+{
+  m_unexpected.insert(p);
+}
+
+std::set<std::string> const&
+Context::unexpected() const
+{
+  return m_unexpected;
+}
+
+fs::Probe&
+Context::probe()
+{
+  return m_probe;
+}
+
+void
+Context::summarize(std::ostream& o, int filter) const
+{
+  if (not m_defaulted.empty() and filter & Option::Defaulted) {
+    size_t len = 0;
+    o << "[Defaulted options]" << std::endl;
+    for (auto& e : m_defaulted) {
+      if (e.first.length() > len) {
+        len = e.first.length();
+      }
+    }
+    for (auto& e : m_defaulted) {
+      o << std::setw(static_cast<int>(len) + 1) << std::left << e.first
+        << std::right;
+      o << std::setfill(' ') << "[ " << e.second << " ]" << std::endl;
+    }
+  }
+  if (not m_inherited.empty() and filter & Option::Inherited) {
+    size_t flen = 0, vlen = 0;
+    o << "[Inherited options]" << std::endl;
+    for (auto& e : m_inherited) {
+      if (e.first.length() > flen) {
+        flen = e.first.length();
+      }
+    }
+    for (auto& e : m_inherited) {
+      if (e.second.first.length() > vlen) {
+        vlen = e.second.first.length();
+      }
+    }
+    for (auto& e : m_inherited) {
+      o << std::setw(static_cast<int>(flen) + 1) << std::left << e.first
+        << std::right;
+      o << std::setfill(' ') << "< ";
+      o << std::setw(static_cast<int>(vlen) + 1) << e.second.first;
+      o << "[ " << e.second.second << " ]" << std::endl;
+    }
+  }
+  if (not m_promoted.empty() and filter & Option::Promoted) {
+    o << "[Promoted options]" << std::endl;
+    for (auto& v : m_promoted) {
+      o << std::left << v << std::right << std::endl;
+    }
+  }
+  if (not m_undefined.empty() and filter & Option::Undefined) {
+    o << "[Non-required (omitted) options]" << std::endl;
+    for (auto& v : m_undefined) {
+      o << std::left << v << std::right << std::endl;
+    }
+  }
+  if (not m_unexpected.empty() and filter & Option::Unexpected) {
+    o << "[Unexpected (ignored) options]" << std::endl;
+    for (auto& v : m_unexpected) {
+      o << std::left << v << std::right << std::endl;
+    }
+  }
+}
+
+void
+Context::reset()
+{
+  m_modelPaths.clear();
+  m_defaulted.clear();
+  m_inherited.clear();
+  m_promoted.clear();
+  m_undefined.clear();
+  m_unexpected.clear();
+  m_probe.clear();
+}
+
+Context&
+Context::current()
+{
+  if (s_current != nullptr) {
+    return *s_current;
+  }
+  /**
+   * The default context of a thread is never released, like its log channel
+   */
+  if (s_default == nullptr) {
+    s_default = new Context;
+  }
+  return *s_default;
+}
+
+}}
@@ -23,6 +23,7 @@
 #include <ace/engine/Master.h>
 #include <ace/common/Log.h>
 #include <ace/common/String.h>
+#include <ace/filesystem/Node.h>
 #include <ace/filesystem/Path.h>
 #include <ace/filesystem/Utils.h>
 #include <ace/model/Model.h>
@@ -36,6 +37,7 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <functional>
 #include <dlfcn.h>
 
 namespace {
@@ -67,16 +69,20 @@ namespace ace { namespace engine {
 Master::Master()
   : m_modelEnvPath()
   , m_modelDirs()
+  , m_modelIndex()
+  , m_inlineModels()
+  , m_compiledModels()
   , m_builders()
   , m_childrenForPath()
-  , m_modelPathContext()
+  , m_modelCache()
   , m_scannersByName()
   , m_scannersByExtension()
-  , m_defaulted()
-  , m_inherited()
-  , m_promoted()
-  , m_undefined()
+  , m_lazyPlugins(false)
+  , m_registryLock()
+  , m_cacheLock()
 {
+  pthread_mutex_init(&m_registryLock, nullptr);
+  pthread_mutex_init(&m_cacheLock, nullptr);
   addModelDirectory(fs::Directory().path());
   char* env = getenv("ACE_MODEL_PATH");
   if (env != nullptr) {
@@ -99,6 +105,12 @@ Master::Master()
   }
 }
 
+Master::~Master()
+{
+  pthread_mutex_destroy(&m_registryLock);
+  pthread_mutex_destroy(&m_cacheLock);
+}
+
 void
 Master::addModelDirectory(fs::Path const& p)
 {
@@ -134,15 +146,48 @@ Master::addInlinedModel(std::string const& k, std::string const& s)
   return true;
 }
 
+/**
+ * Compiled models come from model images. Their source is already parsed and
+ * they are trusted: they are not checked nor validated again.
+ */
+
+bool
+Master::addCompiledModel(std::string const& k, tree::Value::Ref const& r)
+{
+  if (m_compiledModels.find(k) != m_compiledModels.end()) {
+    return false;
+  }
+  if (r == nullptr or r->type() != tree::Value::Type::Object) {
+    return false;
+  }
+  m_compiledModels[k] = r;
+  auto const& root = static_cast<tree::Object const&>(*r);
+  if (not root.has("header")) {
+    return true;
+  }
+  auto const& hdr = static_cast<tree::Object const&>(root["header"]);
+  if (hdr.has("include")) {
+    for (auto& ex : static_cast<tree::Array const&>(hdr["include"])) {
+      std::string ch =
+        static_cast<tree::Primitive const&>(*ex).value<std::string>();
+      m_childrenForPath[ch].insert(k);
+    }
+  }
+  return true;
+}
+
 bool
 Master::hasModel(std::string const& n) const
 {
   if (m_inlineModels.find(n) != m_inlineModels.end()) {
     return true;
   }
+  if (m_compiledModels.find(n) != m_compiledModels.end()) {
+    return true;
+  }
   fs::Path path(n);
   for (auto& e : m_modelDirs) {
-    if (e.has(path)) {
+    if (m_modelIndex.has(e.path(), path)) {
       return true;
     }
   }
@@ -158,44 +203,89 @@ Master::isInlinedModel(std::string const& n) const
   return false;
 }
 
+bool
+Master::isCompiledModel(std::string const& n) const
+{
+  return m_compiledModels.find(n) != m_compiledModels.end();
+}
+
+tree::Value::Ref
+Master::compiledModelFor(std::string const& n) const
+{
+  auto it = m_compiledModels.find(n);
+  if (it == m_compiledModels.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+/**
+ * The builder and children registries are filled when models are loaded, which
+ * may happen while other threads validate configurations. They are guarded by
+ * the registry lock. Entries are never removed outside of reset().
+ */
+
 bool
 Master::addModelBuilder(std::string const& k, std::string const& v, Builder b)
 {
-  if (m_builders.count(k) != 0 and m_builders[k].count(v) != 0) {
-    return false;
+  bool result = false;
+  pthread_mutex_lock(&m_registryLock);
+  if (m_builders.count(k) == 0 or m_builders[k].count(v) == 0) {
+    m_builders[k][v] = b;
+    result = true;
   }
-  m_builders[k][v] = b;
-  return true;
+  pthread_mutex_unlock(&m_registryLock);
+  return result;
 }
 
 bool
 Master::hasModelBuildersFor(std::string const& k) const
 {
-  return m_builders.count(k) != 0;
+  pthread_mutex_lock(&m_registryLock);
+  bool result = m_builders.count(k) != 0;
+  pthread_mutex_unlock(&m_registryLock);
+  return result;
 }
 
-std::map<std::string, Master::Builder> const&
+/*
+ * The builders are copied under the lock, as the registry may be updated by
+ * another thread once it is released.
+ */
+
+std::map<std::string, Master::Builder>
 Master::modelBuildersFor(std::string const& k) const
 {
-  return m_builders.at(k);
+  std::map<std::string, Builder> result;
+  pthread_mutex_lock(&m_registryLock);
+  auto it = m_builders.find(k);
+  if (it != m_builders.end()) {
+    result = it->second;
+  }
+  pthread_mutex_unlock(&m_registryLock);
+  return result;
 }
 
 bool
 Master::addChildForPath(std::string const& path, std::string const& ch)
 {
-  if (m_childrenForPath.count(path) != 0 and
-      m_childrenForPath[path].count(ch) != 0) {
-    return false;
+  bool result = false;
+  pthread_mutex_lock(&m_registryLock);
+  if (m_childrenForPath.count(path) == 0 or
+      m_childrenForPath[path].count(ch) == 0) {
+    m_childrenForPath[ch].insert(path);
+    result = true;
   }
-  m_childrenForPath[ch].insert(path);
-  return true;
+  pthread_mutex_unlock(&m_registryLock);
+  return result;
 }
 
 std::set<std::string>
-Master::childrenForPath(std::string const& p)
+Master::childrenForPath(std::string const& p) const
 {
   std::set<std::string> result;
+  pthread_mutex_lock(&m_registryLock);
   collectChildrenForPath(p, result);
+  pthread_mutex_unlock(&m_registryLock);
   return result;
 }
 
@@ -203,7 +293,7 @@ fs::Path
 Master::modelPathFor(fs::Path const& p) const
 {
   for (auto& e : m_modelDirs) {
-    if (e.has(p)) {
+    if (m_modelIndex.has(e.path(), p)) {
       return e.path() / p;
     }
   }
@@ -216,22 +306,6 @@ Master::modelSourceFor(std::string const& n) const
   return m_inlineModels.at(n);
 }
 
-bool
-Master::addModelPathIntoContext(std::string const& mdp)
-{
-  if (m_modelPathContext.count(mdp) != 0) {
-    return false;
-  }
-  m_modelPathContext.insert(mdp);
-  return true;
-}
-
-void
-Master::remModelPathFromContext(std::string const& mdp)
-{
-  m_modelPathContext.erase(mdp);
-}
-
 bool
 Master::hasScannerByName(std::string const& name) const
 {
@@ -266,113 +340,29 @@ Master::scannerByExtension(std::string const& fn) const
   return *m_scannersByExtension.at(*fnParts.rbegin());
 }
 
-std::set<std::string> const&
-Master::unexpected() const
-{
-  return m_unexpected;
-}
-
-void
-Master::summarize(std::ostream& o, int filter) const
-{
-  if (not m_defaulted.empty() and filter & Option::Defaulted) {
-    size_t len = 0;
-    o << "[Defaulted options]" << std::endl;
-    for (auto& e : m_defaulted) {
-      if (e.first.length() > len) {
-        len = e.first.length();
-      }
-    }
-    for (auto& e : m_defaulted) {
-      o << std::setw(static_cast<int>(len) + 1) << std::left << e.first
-        << std::right;
-      o << std::setfill(' ') << "[ " << e.second << " ]" << std::endl;
-    }
-  }
-  if (not m_inherited.empty() and filter & Option::Inherited) {
-    size_t flen = 0, vlen = 0;
-    o << "[Inherited options]" << std::endl;
-    for (auto& e : m_inherited) {
-      if (e.first.length() > flen) {
-        flen = e.first.length();
-      }
-    }
-    for (auto& e : m_inherited) {
-      if (e.second.first.length() > vlen) {
-        vlen = e.second.first.length();
-      }
-    }
-    for (auto& e : m_inherited) {
-      o << std::setw(static_cast<int>(flen) + 1) << std::left << e.first
-        << std::right;
-      o << std::setfill(' ') << "< ";
-      o << std::setw(static_cast<int>(vlen) + 1) << e.second.first;
-      o << "[ " << e.second.second << " ]" << std::endl;
-    }
-  }
-  if (not m_promoted.empty() and filter & Option::Promoted) {
-    o << "[Promoted options]" << std::endl;
-    for (auto& v : m_promoted) {
-      o << std::left << v << std::right << std::endl;
-    }
-  }
-  if (not m_undefined.empty() and filter & Option::Undefined) {
-    o << "[Non-required (omitted) options]" << std::endl;
-    for (auto& v : m_undefined) {
-      o << std::left << v << std::right << std::endl;
-    }
-  }
-  if (not m_unexpected.empty() and filter & Option::Unexpected) {
-    o << "[Unexpected (ignored) options]" << std::endl;
-    for (auto& v : m_unexpected) {
-      o << std::left << v << std::right << std::endl;
-    }
-  }
-}
-
 void
 Master::reset()
 {
   m_modelDirs.clear();
+  m_modelIndex.clear();
   m_inlineModels.clear();
+  m_compiledModels.clear();
   m_builders.clear();
   m_childrenForPath.clear();
-  m_modelPathContext.clear();
-  m_defaulted.clear();
-  m_inherited.clear();
-  m_promoted.clear();
-  m_undefined.clear();
-  m_unexpected.clear();
+  m_lazyPlugins = false;
+  clearModelCache();
   addModelDirectory(fs::Directory().path());
 }
 
+/**
+ * The instance is built on first use. The initialization of the local static
+ * is thread-safe, so concurrent first calls get the same instance.
+ */
+
 Master&
 Master::getInstance()
 {
-  static std::shared_ptr<Master> singleton = nullptr;
-  if (singleton == nullptr) {
-    singleton = std::shared_ptr<Master>(new Master());
-    std::string paths = fs::Utils::libraryPrefix() + "/lib/";
-    char* env = getenv("ACE_SCANNER_PATH");
-    if (env != nullptr) {
-      ACE_LOG(Warning, "Environment variable ACE_SCANNER_PATH is set");
-      ACE_LOG(Warning, "ACE_SCANNER_PATH = ", env);
-      paths = std::string(env);
-    }
-    std::vector<std::string> elems;
-    common::String::split(paths, ':', elems);
-    for (auto& e : elems) {
-      if (not e.empty()) {
-        auto path = e;
-        if (*path.rbegin() != '/') {
-          path += "/";
-        }
-        if (not e.empty()) {
-          singleton->loadPluginsAtPath(path);
-        }
-      }
-    }
-  }
+  static std::shared_ptr<Master> singleton = build();
   return *singleton;
 }
 
@@ -382,35 +372,177 @@ Master::modelEnvPath() const
   return m_modelEnvPath;
 }
 
+/**
+ * In lazy mode, the children of plugin options are only registered by trigger
+ * when the plugin is loaded. Each child is loaded, flattened and validated the
+ * first time a configuration selects it. The mode must be set before models
+ * are loaded. Code generation and model linting need the eager mode.
+ */
+
 void
-Master::pushDefaulted(std::string const& p, std::string const& v)
+Master::setLazyPlugins(const bool e)
 {
-  m_defaulted[p] = v;
+  m_lazyPlugins = e;
 }
 
-void
-Master::pushInherited(std::string const& p, std::string const& f,
-                      std::string const& v)
+bool
+Master::lazyPlugins() const
 {
-  m_inherited[p] = { f, v };
+  return m_lazyPlugins;
 }
 
-void
-Master::pushPromoted(std::string const& p)
+std::string
+Master::modelSignatureFor(std::string const& n) const
 {
-  m_promoted.insert(p);
+  if (isInlinedModel(n)) {
+    return "inline:" + std::to_string(std::hash<std::string>()(
+                         m_inlineModels.at(n).get()));
+  }
+  if (isCompiledModel(n)) {
+    return "compiled";
+  }
+  fs::Path path = modelPathFor(n);
+  if (path.empty()) {
+    return std::string();
+  }
+  return fs::Node::signature(path);
 }
 
+/**
+ * The cache holds a private clone of the model. The entry is tagged with the
+ * signature of the model and of all its dependencies, as well as with the
+ * children of the plugin models it references. A lookup only succeeds if all
+ * of these are still current.
+ */
+
 void
-Master::pushUndefined(std::string const& p)
+Master::cacheModel(std::string const& n, model::Model const& m)
 {
-  m_undefined.insert(p);
+  std::string key = modelKeyFor(n);
+  if (key.empty()) {
+    return;
+  }
+  CachedModel entry;
+  std::set<std::string> deps = { n };
+  m.collectModelFileDependencies(deps);
+  for (auto& d : deps) {
+    std::string sig = modelSignatureFor(d);
+    if (sig.empty()) {
+      ACE_LOG(Debug, "Model \"", n, "\" not cached, \"", d, "\" not found");
+      return;
+    }
+    entry.signatures[d] = sig;
+  }
+  std::set<std::string> plugins;
+  m.collectPluginDependencies(plugins);
+  for (auto& p : plugins) {
+    entry.children[p] = childrenForPath(p);
+  }
+  entry.model = m.clone();
+  entry.model->setParent(nullptr);
+  ACE_LOG(Debug, "Cache model \"", n, "\" @ ", key);
+  pthread_mutex_lock(&m_cacheLock);
+  m_modelCache[key] = entry;
+  pthread_mutex_unlock(&m_cacheLock);
+}
+
+bool
+Master::hasCachedModel(std::string const& n) const
+{
+  CachedModel entry;
+  return findCachedModel(n, entry) and isCurrent(n, entry);
+}
+
+std::shared_ptr<model::Model>
+Master::cachedModelFor(std::string const& n) const
+{
+  CachedModel entry;
+  if (not findCachedModel(n, entry) or not isCurrent(n, entry)) {
+    return nullptr;
+  }
+  return entry.model->clone();
 }
 
 void
-Master::pushUnexpected(std::string const& p)
+Master::clearModelCache()
+{
+  pthread_mutex_lock(&m_cacheLock);
+  m_modelCache.clear();
+  pthread_mutex_unlock(&m_cacheLock);
+}
+
+bool
+Master::findCachedModel(std::string const& n, CachedModel& e) const
+{
+  std::string key = modelKeyFor(n);
+  pthread_mutex_lock(&m_cacheLock);
+  auto it = m_modelCache.find(key);
+  bool result = it != m_modelCache.end();
+  if (result) {
+    e = it->second;
+  }
+  pthread_mutex_unlock(&m_cacheLock);
+  return result;
+}
+
+bool
+Master::isCurrent(std::string const& n, CachedModel const& e) const
+{
+  for (auto& sig : e.signatures) {
+    if (modelSignatureFor(sig.first) != sig.second) {
+      ACE_LOG(Debug, "Cached model \"", n, "\" is stale, \"", sig.first,
+              "\" changed");
+      return false;
+    }
+  }
+  for (auto& ch : e.children) {
+    if (childrenForPath(ch.first) != ch.second) {
+      ACE_LOG(Debug, "Cached model \"", n, "\" is stale, \"", ch.first,
+              "\" has new children");
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string
+Master::modelKeyFor(std::string const& n) const
 {
-  m_unexpected.insert(p);
+  if (isInlinedModel(n) or isCompiledModel(n)) {
+    return n;
+  }
+  fs::Path path = modelPathFor(n);
+  if (path.empty()) {
+    return std::string();
+  }
+  return path.toString();
+}
+
+std::shared_ptr<Master>
+Master::build()
+{
+  auto master = std::shared_ptr<Master>(new Master());
+  std::string paths = fs::Utils::libraryPrefix() + "/lib/";
+  char* env = getenv("ACE_SCANNER_PATH");
+  if (env != nullptr) {
+    ACE_LOG(Warning, "Environment variable ACE_SCANNER_PATH is set");
+    ACE_LOG(Warning, "ACE_SCANNER_PATH = ", env);
+    paths = std::string(env);
+  }
+  std::vector<std::string> elems;
+  common::String::split(paths, ':', elems);
+  for (auto& e : elems) {
+    if (not e.empty()) {
+      auto path = e;
+      if (*path.rbegin() != '/') {
+        path += "/";
+      }
+      if (not e.empty()) {
+        master->loadPluginsAtPath(path);
+      }
+    }
+  }
+  return master;
 }
 
 void
@@ -0,0 +1,352 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/common/Log.h>
+#include <ace/common/String.h>
+#include <ace/engine/Context.h>
+#include <ace/engine/Master.h>
+#include <ace/engine/Server.h>
+#include <ace/model/Model.h>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+bool
+readAll(int fd, char* b, size_t len)
+{
+  while (len > 0) {
+    ssize_t res = read(fd, b, len);
+    if (res < 0 and errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      return false;
+    }
+    b += res;
+    len -= static_cast<size_t>(res);
+  }
+  return true;
+}
+
+bool
+writeAll(int fd, const char* b, size_t len)
+{
+  while (len > 0) {
+    ssize_t res = write(fd, b, len);
+    if (res < 0 and errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      return false;
+    }
+    b += res;
+    len -= static_cast<size_t>(res);
+  }
+  return true;
+}
+
+std::string
+error(std::string const& msg, std::string const& diag = "")
+{
+  return "ERROR\n" + msg + (diag.empty() ? "" : "\n" + diag);
+}
+
+std::string
+validate(ace::model::Model& mdl, ace::engine::Context const& context,
+         ace::common::Log::Capture const& capture, std::string const& prg,
+         std::vector<std::string> const& args)
+{
+  std::string const& cfgName = args[2];
+  if (not MASTER.hasScannerByExtension(cfgName)) {
+    return error("Unsupported configuration file format: " + cfgName);
+  }
+  char* argv[] = { const_cast<char*>(prg.c_str()),
+                   const_cast<char*>(cfgName.c_str()) };
+  ace::tree::Value::Ref svr = mdl.validate(cfgName, 2, argv);
+  if (svr == nullptr) {
+    return error("Invalid configuration file: " + cfgName, capture.str());
+  }
+  std::ostringstream oss;
+  oss << "OK" << std::endl;
+  if (args[0] == "validate") {
+    context.summarize(oss, ace::engine::Context::Option::All);
+    return oss.str();
+  }
+  if (args.size() < 4 or not MASTER.hasScannerByName(args[3])) {
+    return error("Unsupported dump format");
+  }
+  MASTER.scannerByName(args[3]).dump(*svr, ace::tree::Scanner::Format::Default,
+                                     oss);
+  return oss.str();
+}
+
+std::string
+explain(ace::model::Model const& mdl, ace::common::Log::Capture const& capture,
+        std::string const& p)
+{
+  std::ostringstream oss;
+  oss << "OK" << std::endl;
+  ace::tree::Path path = ace::tree::Path::parse(p);
+  if (not mdl.explain(oss, path)) {
+    return error("Invalid model path: " + p, capture.str());
+  }
+  return oss.str();
+}
+
+}
+
+namespace ace { namespace engine {
+
+const size_t Server::MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+Server::Server(std::string const& name, std::set<std::string> const& models)
+  : m_name(name)
+  , m_models(models)
+  , m_path()
+  , m_fd(-1)
+  , m_running(false)
+  , m_lock(PTHREAD_MUTEX_INITIALIZER)
+  , m_clients()
+  , m_workers()
+  , m_done()
+{}
+
+Server::~Server()
+{
+  stop();
+  reap();
+  if (m_fd >= 0) {
+    close(m_fd);
+    unlink(m_path.c_str());
+  }
+}
+
+/**
+ * A file left at the socket path is only removed if it is a socket, from a
+ * previous instance of the server. Any other file is left untouched.
+ */
+
+bool
+Server::listen(std::string const& path)
+{
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.length() >= sizeof(addr.sun_path)) {
+    ACE_LOG(Error, "Socket path \"", path, "\" is too long");
+    return false;
+  }
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  struct stat st;
+  if (lstat(path.c_str(), &st) == 0) {
+    if (not S_ISSOCK(st.st_mode)) {
+      ACE_LOG(Error, "\"", path, "\" exists and is not a socket");
+      return false;
+    }
+    unlink(path.c_str());
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    ACE_LOG(Error, "Cannot create socket: ", strerror(errno));
+    return false;
+  }
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 or
+      ::listen(fd, SOMAXCONN) != 0) {
+    ACE_LOG(Error, "Cannot listen on \"", path, "\": ", strerror(errno));
+    close(fd);
+    return false;
+  }
+  m_path = path;
+  m_fd = fd;
+  m_running = true;
+  return true;
+}
+
+/**
+ * Accept connections until the server is stopped. Upon exit, the connections
+ * still open are shut down and their threads are joined.
+ */
+
+void
+Server::run()
+{
+  while (m_running) {
+    int cfd = accept(m_fd, nullptr, nullptr);
+    if (cfd < 0) {
+      if (m_running and errno != EINTR) {
+        ACE_LOG(Error, "Cannot accept connection: ", strerror(errno));
+      }
+      continue;
+    }
+    reap();
+    pthread_mutex_lock(&m_lock);
+    if (not m_running) {
+      pthread_mutex_unlock(&m_lock);
+      close(cfd);
+      break;
+    }
+    m_clients.insert(cfd);
+    std::thread worker(&Server::handle, this, cfd);
+    m_workers[worker.get_id()] = std::move(worker);
+    pthread_mutex_unlock(&m_lock);
+  }
+  pthread_mutex_lock(&m_lock);
+  for (auto fd : m_clients) {
+    shutdown(fd, SHUT_RDWR);
+  }
+  std::map<std::thread::id, std::thread> workers;
+  workers.swap(m_workers);
+  m_done.clear();
+  pthread_mutex_unlock(&m_lock);
+  for (auto& w : workers) {
+    w.second.join();
+  }
+}
+
+/**
+ * Only async-signal-safe operations are used so that the server can be stopped
+ * from a signal handler.
+ */
+
+void
+Server::stop()
+{
+  m_running = false;
+  if (m_fd >= 0) {
+    shutdown(m_fd, SHUT_RDWR);
+  }
+}
+
+/**
+ * Each request is served within its own context, so that the requests served
+ * concurrently do not share their state, and the errors logged while loading
+ * the model or validating the configuration are returned to the client.
+ */
+
+std::string
+Server::serve(std::string const& request) const
+try {
+  std::vector<std::string> args;
+  common::String::split(request, '\n', args);
+  if (args.size() < 3) {
+    return error("Invalid request");
+  }
+  if (m_models.count(args[1]) == 0) {
+    return error("Unknown model: " + args[1]);
+  }
+  Context context;
+  Context::Scope scope(context);
+  common::Log::Capture capture;
+  model::Model::Ref mdl = model::Model::load(args[1]);
+  if (mdl == nullptr) {
+    return error("Invalid model: " + args[1], capture.str());
+  }
+  if (args[0] == "validate" or args[0] == "dump") {
+    return validate(*mdl, context, capture, m_name, args);
+  }
+  if (args[0] == "explain") {
+    return explain(*mdl, capture, args[2]);
+  }
+  return error("Unknown command: " + args[0]);
+} catch (std::exception const& e) {
+  return error(e.what());
+}
+
+bool
+Server::readFrame(int fd, std::string& s)
+{
+  uint32_t len = 0;
+  if (not readAll(fd, reinterpret_cast<char*>(&len), sizeof(len))) {
+    return false;
+  }
+  len = ntohl(len);
+  if (len > MAX_FRAME_SIZE) {
+    ACE_LOG(Error, "Frame of ", len, " bytes is too large");
+    return false;
+  }
+  s.resize(len);
+  return readAll(fd, &s[0], len);
+}
+
+bool
+Server::writeFrame(int fd, std::string const& s)
+{
+  uint32_t len = htonl(static_cast<uint32_t>(s.length()));
+  return writeAll(fd, reinterpret_cast<const char*>(&len), sizeof(len)) and
+         writeAll(fd, s.data(), s.length());
+}
+
+void
+Server::handle(int fd)
+{
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGINT);
+  sigaddset(&set, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &set, nullptr);
+  std::string request;
+  while (m_running and readFrame(fd, request)) {
+    if (not writeFrame(fd, serve(request))) {
+      break;
+    }
+  }
+  pthread_mutex_lock(&m_lock);
+  m_clients.erase(fd);
+  close(fd);
+  m_done.push_back(std::this_thread::get_id());
+  pthread_mutex_unlock(&m_lock);
+}
+
+/**
+ * Join the threads of the connections that are closed.
+ */
+
+void
+Server::reap()
+{
+  std::vector<std::thread> done;
+  pthread_mutex_lock(&m_lock);
+  for (auto const& id : m_done) {
+    auto it = m_workers.find(id);
+    if (it != m_workers.end()) {
+      done.push_back(std::move(it->second));
+      m_workers.erase(it);
+    }
+  }
+  m_done.clear();
+  pthread_mutex_unlock(&m_lock);
+  for (auto& t : done) {
+    t.join();
+  }
+}
+
+}}
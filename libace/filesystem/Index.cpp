@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/filesystem/Index.h>
+#include <algorithm>
+#include <string>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace {
+
+struct timespec
+mtimeOf(struct stat const& st)
+{
+#if defined(__linux__)
+  return st.st_mtim;
+#else
+  return st.st_mtimespec;
+#endif
+}
+
+struct timespec
+ctimeOf(struct stat const& st)
+{
+#if defined(__linux__)
+  return st.st_ctim;
+#else
+  return st.st_ctimespec;
+#endif
+}
+
+bool
+same(struct timespec const& a, struct timespec const& b)
+{
+  return a.tv_sec == b.tv_sec and a.tv_nsec == b.tv_nsec;
+}
+
+bool
+same(struct stat const& a, struct stat const& b)
+{
+  return a.st_dev == b.st_dev and a.st_ino == b.st_ino and
+         a.st_size == b.st_size and same(mtimeOf(a), mtimeOf(b)) and
+         same(ctimeOf(a), ctimeOf(b));
+}
+
+/*
+ * Timestamps may be as coarse as a second. A listing is racy when it is read
+ * in the same second as, or the second after, the last change of the
+ * directory.
+ */
+bool
+racy(struct stat const& st)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  time_t last = std::max(mtimeOf(st).tv_sec, ctimeOf(st).tv_sec);
+  return now.tv_sec <= last + 1;
+}
+
+}
+
+namespace ace { namespace fs {
+
+Index::Index() : m_listings(), m_lock()
+{
+  pthread_mutex_init(&m_lock, nullptr);
+}
+
+Index::~Index()
+{
+  pthread_mutex_destroy(&m_lock);
+}
+
+bool
+Index::has(fs::Path const& d, fs::Path const& p)
+{
+  if (p.empty() or p.isAbsolute()) {
+    return false;
+  }
+  fs::Path cur(d);
+  for (auto i = p.begin(); i != p.end(); i = p.down(i)) {
+    if (i->empty()) {
+      return true;
+    }
+    bool dir = false;
+    if (not find(cur, *i, dir)) {
+      return false;
+    }
+    if (p.down(i) == p.end()) {
+      return not dir;
+    }
+    cur = cur / fs::Path(*i, true);
+  }
+  return false;
+}
+
+void
+Index::clear()
+{
+  pthread_mutex_lock(&m_lock);
+  m_listings.clear();
+  pthread_mutex_unlock(&m_lock);
+}
+
+bool
+Index::find(fs::Path const& d, std::string const& n, bool& dir)
+{
+  std::string key = d.toString();
+  struct stat st;
+  if (stat(key.c_str(), &st) != 0 or not S_ISDIR(st.st_mode)) {
+    return false;
+  }
+  pthread_mutex_lock(&m_lock);
+  auto it = m_listings.find(key);
+  if (it == m_listings.end() or it->second.racy or
+      not same(it->second.status, st)) {
+    DIR* dp = opendir(key.c_str());
+    if (dp == nullptr) {
+      pthread_mutex_unlock(&m_lock);
+      return false;
+    }
+    Listing& l = m_listings[key];
+    l.status = st;
+    l.racy = racy(st);
+    l.entries.clear();
+    struct dirent* ep;
+    while ((ep = readdir(dp)) != nullptr) {
+      bool isDir = ep->d_type == DT_DIR;
+      if (ep->d_type == DT_UNKNOWN) {
+        struct stat est;
+        isDir = fstatat(dirfd(dp), ep->d_name, &est, 0) == 0 and
+                S_ISDIR(est.st_mode);
+      }
+      l.entries[ep->d_name] = isDir;
+    }
+    closedir(dp);
+    it = m_listings.find(key);
+  }
+  auto e = it->second.entries.find(n);
+  bool found = e != it->second.entries.end();
+  if (found) {
+    dir = e->second;
+  }
+  pthread_mutex_unlock(&m_lock);
+  return found;
+}
+
+}}
@@ -22,6 +22,7 @@
 
 #include <ace/filesystem/Node.h>
 #include <map>
+#include <sstream>
 #include <string>
 #include <pwd.h>
 #include <unistd.h>
@@ -276,6 +277,35 @@ Node::writeable(fs::Path const& p, const bool follow)
   return false;
 }
 
+std::string
+Node::signature() const
+{
+  if (m_fd == -1) {
+    return std::string();
+  }
+  struct stat st;
+  if (fstat(m_fd, &st) != 0) {
+    return std::string();
+  }
+  return signature(st);
+}
+
+std::string
+Node::signature(fs::Path const& p, const bool follow)
+{
+  struct stat st;
+  if (follow) {
+    if (stat(p.toString().c_str(), &st) != 0) {
+      return std::string();
+    }
+  } else {
+    if (lstat(p.toString().c_str(), &st) != 0) {
+      return std::string();
+    }
+  }
+  return signature(st);
+}
+
 Node
 Node::parent() const
 {
@@ -305,6 +335,19 @@ Node::permissions(mode_t mode)
   return static_cast<Permission>(mode & ~S_IFMT);
 }
 
+std::string
+Node::signature(struct stat const& st)
+{
+  std::ostringstream oss;
+  oss << st.st_dev << ":" << st.st_ino << ":" << st.st_size << ":";
+#if defined(__linux__)
+  oss << st.st_mtim.tv_sec << "." << st.st_mtim.tv_nsec;
+#else
+  oss << st.st_mtimespec.tv_sec << "." << st.st_mtimespec.tv_nsec;
+#endif
+  return oss.str();
+}
+
 std::ostream&
 operator<<(std::ostream& o, Node::Type const& t)
 {
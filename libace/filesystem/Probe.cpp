@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/filesystem/Probe.h>
+#include <ace/filesystem/Utils.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+using ace::fs::Node;
+using ace::fs::Probe;
+
+/*
+ * Maximum number of probing threads. Probes mostly wait on the file system,
+ * so more threads than cores are useful on network file systems.
+ */
+
+static const size_t MAX_WORKERS = 16;
+
+struct Work
+{
+  std::vector<std::string> const& paths;
+  std::vector<Probe::Result>& results;
+  std::atomic<size_t> next;
+};
+
+/*
+ * Same rules as Node::readable() and Node::writeable(), from a single stat.
+ */
+static bool
+allowed(struct stat const& st, const mode_t o, const mode_t g, const mode_t u)
+{
+  if (st.st_mode & o) {
+    return true;
+  }
+  if (st.st_uid == getuid() and st.st_mode & u) {
+    return true;
+  }
+  return st.st_gid == getgid() and st.st_mode & g;
+}
+
+static Probe::Result
+probe(std::string const& p)
+{
+  Probe::Result r;
+  struct stat st;
+  if (stat(p.c_str(), &st) != 0) {
+    r.creatable = ace::fs::Utils::canSelfCreate(ace::fs::Path(p));
+    return r;
+  }
+  r.type = static_cast<Node::Type>(st.st_mode & S_IFMT);
+  r.readable = allowed(st, S_IROTH, S_IRGRP, S_IRUSR);
+  r.writeable = allowed(st, S_IWOTH, S_IWGRP, S_IWUSR);
+  r.openable = faccessat(AT_FDCWD, p.c_str(), R_OK, AT_EACCESS) == 0;
+  return r;
+}
+
+static void*
+run(void* arg)
+{
+  Work& w = *static_cast<Work*>(arg);
+  for (size_t i = w.next++; i < w.paths.size(); i = w.next++) {
+    w.results[i] = probe(w.paths[i]);
+  }
+  return nullptr;
+}
+
+}
+
+namespace ace { namespace fs {
+
+Probe::Probe() : m_results(), m_probed(0), m_elapsed(0.0), m_lock()
+{
+  pthread_mutex_init(&m_lock, nullptr);
+}
+
+Probe::~Probe()
+{
+  pthread_mutex_destroy(&m_lock);
+}
+
+void
+Probe::probe(std::set<std::string> const& paths)
+{
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::string> missing;
+  for (auto& p : paths) {
+    Result r;
+    if (not lookup(p, r)) {
+      missing.push_back(p);
+    }
+  }
+  if (missing.empty()) {
+    return;
+  }
+  std::vector<Result> results(missing.size());
+  Work work{ missing, results, { 0 } };
+  std::vector<pthread_t> workers;
+  size_t count = std::min(MAX_WORKERS, missing.size());
+  for (size_t i = 1; i < count; i += 1) {
+    pthread_t tid;
+    if (pthread_create(&tid, nullptr, run, &work) == 0) {
+      workers.push_back(tid);
+    }
+  }
+  run(&work);
+  for (auto& tid : workers) {
+    pthread_join(tid, nullptr);
+  }
+  std::chrono::duration<double, std::milli> delta =
+    std::chrono::steady_clock::now() - start;
+  pthread_mutex_lock(&m_lock);
+  for (size_t i = 0; i < missing.size(); i += 1) {
+    m_results[missing[i]] = results[i];
+  }
+  m_probed += missing.size();
+  m_elapsed += delta.count();
+  pthread_mutex_unlock(&m_lock);
+}
+
+Probe::Result
+Probe::result(std::string const& p)
+{
+  Result r;
+  if (not lookup(p, r)) {
+    probe(std::set<std::string>{ p });
+    lookup(p, r);
+  }
+  return r;
+}
+
+void
+Probe::clear()
+{
+  pthread_mutex_lock(&m_lock);
+  m_results.clear();
+  m_probed = 0;
+  m_elapsed = 0.0;
+  pthread_mutex_unlock(&m_lock);
+}
+
+size_t
+Probe::probed() const
+{
+  pthread_mutex_lock(&m_lock);
+  size_t n = m_probed;
+  pthread_mutex_unlock(&m_lock);
+  return n;
+}
+
+double
+Probe::elapsed() const
+{
+  pthread_mutex_lock(&m_lock);
+  double d = m_elapsed;
+  pthread_mutex_unlock(&m_lock);
+  return d;
+}
+
+bool
+Probe::lookup(std::string const& p, Result& r) const
+{
+  pthread_mutex_lock(&m_lock);
+  auto it = m_results.find(p);
+  bool found = it != m_results.end();
+  if (found) {
+    r = it->second;
+  }
+  pthread_mutex_unlock(&m_lock);
+  return found;
+}
+
+}}
@@ -66,16 +66,14 @@ Arity::parse(std::string const& s, Arity& arity)
     return false;
   }
   if (not parts[0].empty()) {
-    ssize_t tmp = 0;
-    std::istringstream(parts[0]) >> tmp;
+    long tmp = common::String::value<long>(parts[0]);
     if (tmp < 0) {
       return false;
     }
     min = tmp;
   }
   if (not parts[1].empty()) {
-    ssize_t tmp = 0;
-    std::istringstream(parts[1]) >> tmp;
+    long tmp = common::String::value<long>(parts[1]);
     if (tmp < 0) {
       return false;
     }
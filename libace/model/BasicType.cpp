@@ -24,7 +24,7 @@
 #include <ace/model/Dependency.h>
 #include <ace/model/Errors.h>
 #include <ace/model/Model.h>
-#include <ace/engine/Master.h>
+#include <ace/engine/Context.h>
 #include <ace/tree/Checker.h>
 #include <iomanip>
 #include <iostream>
@@ -140,27 +140,27 @@ BasicType::validateModel()
 }
 
 void
-BasicType::display(Coach::Branch const& br) const
+BasicType::display(std::ostream& o, Coach::Branch const& br) const
 {
-  br.print(std::cout) << arity() << " " << m_name << " ";
-  std::cout << "(" << toString(m_kind) << ")";
-  std::cout << std::endl;
+  br.print(o) << arity() << " " << m_name << " ";
+  o << "(" << toString(m_kind) << ")";
+  o << std::endl;
 }
 
 bool
-BasicType::explain(tree::Path const& p,
+BasicType::explain(std::ostream& o, tree::Path const& p,
                    tree::Path::const_iterator const& i) const
 {
-  Coach::explain(p, i);
+  Coach::explain(o, p, i);
   if (i != p.end()) {
     return false;
   }
-  std::cout << std::left;
+  o << std::left;
   for (auto& a : m_attributes) {
-    std::cout << std::setw(13) << a->name() << ": ";
-    a->print(std::cout, 15);
+    o << std::setw(13) << a->name() << ": ";
+    a->print(o, 15);
   }
-  std::cout << std::right;
+  o << std::right;
   return true;
 }
 
@@ -223,7 +223,7 @@ BasicType::doBuildDefinition(std::string const& s, std::string const& v,
   if (optional() and not multiple()) {
     o << s << " = ";
   }
-  o << "ace::tree::utils::parsePrimitive<" << typeName() << ">(r, " << e << ", "
+  o << "ace::tree::utils::parsePrimitive<" << typeName() << ">(" << e << ", "
     << v << ");";
   o << std::endl;
 }
@@ -364,7 +364,7 @@ BasicType::promoteArity(tree::Path const& p,
                         tree::Path::const_iterator const& i)
 {
   if (i == p.end() and arity().promote()) {
-    MASTER.pushPromoted(path());
+    CONTEXT.pushPromoted(path());
   }
 }
 
@@ -543,6 +543,10 @@ BasicType::resolveInstance(tree::Object const& r, tree::Value const& v) const
   return m_attributes.resolveInstance(r, v);
 }
 
+void
+BasicType::collectProbes(tree::Value const& v, Probes& p) const
+{}
+
 void
 BasicType::collectModelFileDependencies(std::set<std::string>& d) const
 {}
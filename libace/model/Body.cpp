@@ -21,21 +21,179 @@
  */
 
 #include <ace/model/Body.h>
+#include <ace/model/DisableDependency.h>
 #include <ace/model/Errors.h>
-#include <ace/engine/Master.h>
+#include <ace/engine/Context.h>
 #include <ace/tree/Object.h>
 #include <ace/types/Class.h>
+#include <ace/types/Plugin.h>
+#include <ace/types/Selector.h>
+#include <algorithm>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <map>
+#include <queue>
 #include <set>
 #include <string>
 #include <vector>
 
+namespace {
+
+using namespace ace::model;
+
+/*
+ * Name of the type targeted by a dependency path, if it is statically known.
+ * Recursive, wildcard and expanded path heads may target any type.
+ */
+bool
+targetOf(std::string const& d, std::string& r)
+{
+  if (d.compare(0, 2, "@.") != 0) {
+    return false;
+  }
+  size_t end = d.find_first_of(".[", 2);
+  r = d.substr(2, end == std::string::npos ? end : end - 2);
+  return not r.empty() and r.find_first_of("*%") == std::string::npos;
+}
+
+/*
+ * Name of the option at the head of an absolute path, if it is named.
+ */
+bool
+headOf(ace::tree::Path const& p, std::string& r)
+{
+  using ace::tree::path::Item;
+  auto i = p.begin();
+  if (i == p.end() or (*i)->type() != Item::Type::Global) {
+    return false;
+  }
+  if (++i == p.end() or (*i)->type() != Item::Type::Named or
+      (*i)->recursive()) {
+    return false;
+  }
+  r = (*i)->value();
+  return true;
+}
+
+/*
+ * Options read by a type outside of its own value: the heads of its hooks and
+ * the options its nested types may inherit. Plugin triggers and non-local
+ * nested dependencies may read any option.
+ */
+void
+collectReads(BasicType const& bt, const bool nested,
+             std::set<std::string>& heads, bool& any)
+{
+  if (bt.hasHook()) {
+    std::string h;
+    if (headOf(bt.hook().path(), h)) {
+      heads.insert(h);
+    } else {
+      any = true;
+    }
+  }
+  if (nested and bt.mayInherit()) {
+    heads.insert(bt.name());
+  }
+  if (nested and bt.hasDependencies()) {
+    for (auto& d : bt.dependencies()) {
+      for (auto& p : d->paths()) {
+        if (p.compare(0, 2, "@.") != 0) {
+          any = true;
+        }
+      }
+    }
+  }
+  switch (bt.kind()) {
+    case BasicType::Kind::Class: {
+      Class const& type = dynamic_cast<Class const&>(bt);
+      for (auto& e : type.modelAttribute().model().body()) {
+        collectReads(*e.second, true, heads, any);
+      }
+    } break;
+    case BasicType::Kind::Selector: {
+      Selector const& type = dynamic_cast<Selector const&>(bt);
+      collectReads(type.templateType(), nested, heads, any);
+    } break;
+    case BasicType::Kind::Plugin:
+      any = true;
+      break;
+    default:
+      break;
+  }
+}
+
+/*
+ * Tarjan's strongly connected components.
+ */
+struct Components
+{
+  using Graph = std::vector<std::set<size_t>>;
+
+  explicit Components(Graph const& g)
+    : graph(g)
+    , index(g.size(), -1)
+    , low(g.size(), 0)
+    , stack()
+    , onStack(g.size(), false)
+    , component(g.size(), 0)
+    , count(0)
+    , next(0)
+  {
+    for (size_t v = 0; v < graph.size(); v += 1) {
+      if (index[v] < 0) {
+        connect(v);
+      }
+    }
+  }
+
+  void connect(const size_t v)
+  {
+    index[v] = low[v] = next++;
+    stack.push_back(v);
+    onStack[v] = true;
+    for (auto w : graph[v]) {
+      if (index[w] < 0) {
+        connect(w);
+        low[v] = std::min(low[v], low[w]);
+      } else if (onStack[w]) {
+        low[v] = std::min(low[v], index[w]);
+      }
+    }
+    if (low[v] == index[v]) {
+      size_t w;
+      do {
+        w = stack.back();
+        stack.pop_back();
+        onStack[w] = false;
+        component[w] = count;
+      } while (w != v);
+      count += 1;
+    }
+  }
+
+  Graph const& graph;
+  std::vector<int> index;
+  std::vector<int> low;
+  std::vector<size_t> stack;
+  std::vector<bool> onStack;
+  std::vector<size_t> component;
+  size_t count;
+  int next;
+};
+
+}
+
 namespace ace { namespace model {
 
-Body::Body(Body const& o) : Section(o), Instance(o), Coach(o)
+Body::Body(Body const& o)
+  : Section(o)
+  , Instance(o)
+  , Coach(o)
+  , m_order(o.m_order)
+  , m_affects(o.m_affects)
 {
   for (auto& t : o.m_types) {
     m_types[t.first] = BasicType::Ref(t.second->clone(t.first));
@@ -57,7 +215,7 @@ Body::injectInherited(tree::Object const& r, Object const& o,
         tree::Primitive const& p = static_cast<tree::Primitive const&>(w);
         val = p.value();
       }
-      MASTER.pushInherited(t.path(), h.path(), val);
+      CONTEXT.pushInherited(t.path(), h.path(), val);
       tree::Object& obj = static_cast<tree::Object&>(v);
       obj.put(t.name(), r.at(t.name()));
       return true;
@@ -66,6 +224,15 @@ Body::injectInherited(tree::Object const& r, Object const& o,
   return m_parent->injectInherited(r, o, v);
 }
 
+bool
+Body::validateModel()
+{
+  if (not Section::validateModel()) {
+    return false;
+  }
+  return buildDependencyGraph();
+}
+
 bool
 Body::checkInstance(tree::Object const& r, tree::Value const& v) const
 {
@@ -76,7 +243,7 @@ Body::checkInstance(tree::Object const& r, tree::Value const& v) const
   int score = 0;
   tree::Object const& obj = static_cast<tree::Object const&>(v);
   for (auto& e : obj) {
-    if (m_types.find(e.first) != m_types.end()) {
+    if (m_types.find(e.first) != m_types.end() and inScope(e.first)) {
       if (not m_types.at(e.first)->checkInstance(r, *e.second)) {
         ERROR(ERR_FAILED_CHECKING_INSTANCE(e.first));
         score += 1;
@@ -84,7 +251,7 @@ Body::checkInstance(tree::Object const& r, tree::Value const& v) const
     }
   }
   for (auto& e : obj) {
-    if (m_types.find(e.first) != m_types.end()) {
+    if (m_types.find(e.first) != m_types.end() and inScope(e.first)) {
       BasicType const& bt = *m_types.at(e.first);
       if (bt.hasDependencies()) {
         for (auto& d : bt.dependencies()) {
@@ -107,67 +274,65 @@ Body::expandInstance(tree::Object& r, tree::Value& v)
 
   for (auto& e : m_types) {
     if (e.second->isObject() and not e.second->optional() and
-        not obj.has(e.first)) {
+        not obj.has(e.first) and inScope(e.first)) {
       r.put(e.first, tree::Object::build(e.first));
-      MASTER.pushDefaulted(e.first, "{ }");
-    }
-  }
-
-  // 2. Inject optional values
-  // 3. Expand all instances
-  // 4. Expand dependencies on all instances
-  // 5. Repeat until no more values are generated
-
-  size_t iteration = 1;
-  bool keepLooping = false;
-  std::map<std::string, bool> injected, depended;
-
-  do {
-    DEBUG("Iteration ", iteration++, " of dependency stabilisation loop");
-    keepLooping = false;
-    for (auto& e : m_types) {
-      if (not injected[e.first] and not obj.has(e.first)) {
-        if (not e.second->disabled() and not e.second->optional()) {
-          if (e.second->mayInherit() and
-              m_parent->injectInherited(r, *e.second, v)) {
-            DEBUG("Injected inherited for ", e.second->path());
-            keepLooping = true;
-          } else {
-            keepLooping = e.second->injectDefault(r, v);
-          }
-          injected[e.first] = true;
-        } else {
-          DEBUG("Skipping value injection of disabled type ", e.second->path());
-        }
-      }
+      CONTEXT.pushDefaulted(e.second->path(), "{ }");
     }
-    for (auto& e : obj) {
-      if (m_types.find(e.first) != m_types.end()) {
-        BasicType& bt = *m_types.at(e.first);
-        if (not bt.disabled()) {
-          bt.expandInstance(r, *e.second);
+  }
+
+  // 2. Walk the types in the topological order of their dependencies:
+  //    inject a value if required, expand its dependencies, then expand it
+  // 3. Queue again the types already walked that may have been affected by
+  //    the dependencies of a later type, in a cycle or through a wildcard
+
+  std::set<size_t> worklist;
+  for (size_t i = 0; i < m_order.size(); i += 1) {
+    if (inScope(m_order[i])) {
+      worklist.insert(i);
+    }
+  }
+  std::set<std::string> injected, depended;
+  while (not worklist.empty()) {
+    size_t idx = *worklist.begin();
+    worklist.erase(worklist.begin());
+    std::string const& name = m_order[idx];
+    BasicType& bt = *m_types.at(name);
+    if (not obj.has(name) and injected.count(name) == 0) {
+      if (not bt.disabled() and not bt.optional()) {
+        if (bt.mayInherit() and m_parent->injectInherited(r, bt, v)) {
+          DEBUG("Injected inherited for ", bt.path());
         } else {
-          DEBUG("Skipping expandInstance of disabled type ", bt.path());
+          bt.injectDefault(r, v);
         }
+        injected.insert(name);
+      } else {
+        DEBUG("Skipping value injection of disabled type ", bt.path());
       }
     }
-    for (auto& e : obj) {
-      if (not depended[e.first] and m_types.find(e.first) != m_types.end()) {
-        BasicType& bt = *m_types.at(e.first);
-        if (bt.hasDependencies()) {
-          if (not bt.disabled()) {
-            for (auto& d : bt.dependencies()) {
-              d->expandInstance(r, *e.second);
-            }
-            keepLooping = true;
-            depended[e.first] = true;
-          } else {
-            DEBUG("Skipping dependencies of disabled type ", bt.path());
+    if (not obj.has(name)) {
+      continue;
+    }
+    if (bt.disabled()) {
+      DEBUG("Skipping expandInstance of disabled type ", bt.path());
+      continue;
+    }
+    if (bt.hasDependencies() and depended.count(name) == 0) {
+      for (auto& d : bt.dependencies()) {
+        d->expandInstance(r, obj.get(name));
+      }
+      depended.insert(name);
+      auto aff = m_affects.find(name);
+      if (aff != m_affects.end()) {
+        for (auto pos : aff->second) {
+          if (pos < idx and inScope(m_order[pos])) {
+            DEBUG("Dependencies of ", name, " affect ", m_order[pos]);
+            worklist.insert(pos);
           }
         }
       }
     }
-  } while (keepLooping);
+    bt.expandInstance(r, obj.get(name));
+  }
 }
 
 bool
@@ -178,7 +343,7 @@ Body::flattenInstance(tree::Object& r, tree::Value& v)
    * Flatten the enclosed types and dependencies
    */
   for (auto& e : m_types) {
-    if (r.has(e.first)) {
+    if (r.has(e.first) and inScope(e.first)) {
       tree::Value& nv = r.get(e.first);
       if (not e.second->flattenInstance(r, nv)) {
         ERROR(ERR_FAILED_FLATTENING_INSTANCE(e.first));
@@ -187,7 +352,7 @@ Body::flattenInstance(tree::Object& r, tree::Value& v)
     }
   }
   for (auto& e : m_types) {
-    if (r.has(e.first)) {
+    if (r.has(e.first) and inScope(e.first)) {
       tree::Value& nv = r.get(e.first);
       BasicType const& bt = *e.second;
       if (bt.hasDependencies()) {
@@ -205,7 +370,8 @@ Body::flattenInstance(tree::Object& r, tree::Value& v)
   std::vector<std::string> disabledIds;
   tree::Object& obj = static_cast<tree::Object&>(v);
   for (auto& e : obj) {
-    if (m_types.count(e.first) != 0 and m_types.at(e.first)->disabled()) {
+    if (m_types.count(e.first) != 0 and m_types.at(e.first)->disabled() and
+        inScope(e.first)) {
       WARNING(ERR_USING_DISABLED_TYPE(e.first));
       disabledIds.push_back(e.first);
     }
@@ -219,6 +385,20 @@ Body::flattenInstance(tree::Object& r, tree::Value& v)
   return score == 0;
 }
 
+void
+Body::collectProbes(tree::Value const& v, BasicType::Probes& p) const
+{
+  if (v.type() != tree::Value::Type::Object) {
+    return;
+  }
+  tree::Object const& obj = static_cast<tree::Object const&>(v);
+  for (auto& e : obj) {
+    if (m_types.find(e.first) != m_types.end() and inScope(e.first)) {
+      m_types.at(e.first)->collectProbes(*e.second, p);
+    }
+  }
+}
+
 bool
 Body::resolveInstance(tree::Object const& r, tree::Value const& v) const
 {
@@ -228,20 +408,20 @@ Body::resolveInstance(tree::Object const& r, tree::Value const& v) const
   // 1. Check if the declared options are all expected
 
   for (auto& e : obj) {
-    if (m_types.count(e.first) == 0) {
+    if (m_types.count(e.first) == 0 and inScope(e.first)) {
       tree::Path ePath = m_parent->path();
       ePath.push(
         tree::path::Item::build(tree::path::Item::Type::Named, e.first));
-      MASTER.pushUnexpected(ePath);
+      CONTEXT.pushUnexpected(ePath);
     }
   }
 
   // 2. Check if all the required options are present
 
   for (auto& e : m_types) {
-    if (not obj.has(e.first)) {
+    if (not obj.has(e.first) and inScope(e.first)) {
       if (e.second->optional()) {
-        MASTER.pushUndefined(e.second->path());
+        CONTEXT.pushUndefined(e.second->path());
       } else if (not e.second->disabled()) {
         ERROR(ERR_MISSING_REQUIRED(e.first));
         score += 1;
@@ -252,7 +432,7 @@ Body::resolveInstance(tree::Object const& r, tree::Value const& v) const
   // 3. Call resolve instance on the dependencies
 
   for (auto& e : obj) {
-    if (m_types.count(e.first) != 0) {
+    if (m_types.count(e.first) != 0 and inScope(e.first)) {
       BasicType const& bt = *m_types.at(e.first);
       if (not bt.disabled() and bt.hasDependencies()) {
         for (auto& d : bt.dependencies()) {
@@ -267,7 +447,7 @@ Body::resolveInstance(tree::Object const& r, tree::Value const& v) const
   // 4. Call resolve instance on all types
 
   for (auto& e : obj) {
-    if (m_types.count(e.first) != 0) {
+    if (m_types.count(e.first) != 0 and inScope(e.first)) {
       BasicType const& bt = *m_types.at(e.first);
       if (not bt.disabled() and not bt.resolveInstance(r, *e.second)) {
         ERROR(ERR_FAILED_RESOLVING_INSTANCE(e.first));
@@ -279,8 +459,102 @@ Body::resolveInstance(tree::Object const& r, tree::Value const& v) const
   return score == 0;
 }
 
+bool
+Body::collectAffected(std::vector<tree::Path> const& c,
+                      std::set<std::string>& r) const
+{
+  if (m_order.size() != m_types.size()) {
+    return false;
+  }
+  std::queue<std::string> work;
+  for (auto& p : c) {
+    std::string h;
+    if (not headOf(p, h)) {
+      return false;
+    }
+    if (r.insert(h).second) {
+      work.push(h);
+    }
+  }
+  /**
+   * Link the types through their dependencies both ways, as the state of a
+   * type depends on the dependencies targeting it, and from the options read
+   * by a type to that type
+   */
+  std::map<std::string, std::set<std::string>> links;
+  for (auto& e : m_affects) {
+    for (auto pos : e.second) {
+      links[e.first].insert(m_order[pos]);
+      links[m_order[pos]].insert(e.first);
+    }
+  }
+  for (auto& e : m_types) {
+    std::set<std::string> heads;
+    bool any = false;
+    collectReads(*e.second, false, heads, any);
+    if (any and not c.empty() and r.insert(e.first).second) {
+      work.push(e.first);
+    }
+    for (auto& h : heads) {
+      links[h].insert(e.first);
+    }
+  }
+  /**
+   * Walk the links from the changed options
+   */
+  while (not work.empty()) {
+    std::string n = work.front();
+    work.pop();
+    if (links.count(n) == 0) {
+      continue;
+    }
+    for (auto& m : links.at(n)) {
+      if (r.insert(m).second) {
+        work.push(m);
+      }
+    }
+  }
+  return true;
+}
+
 void
-Body::display(Coach::Branch const& br) const
+Body::dropInjected(tree::Value& v, std::vector<tree::Path> const& c)
+{
+  tree::Object& obj = static_cast<tree::Object&>(v);
+  std::set<std::string> changed;
+  for (auto& p : c) {
+    std::string h;
+    if (headOf(p, h)) {
+      changed.insert(h);
+    }
+  }
+  for (auto& e : m_types) {
+    if (not inScope(e.first) or not CONTEXT.popInjected(e.second->path())) {
+      continue;
+    }
+    if (changed.count(e.first) == 0 and obj.has(e.first)) {
+      DEBUG("Drop injected value of ", e.second->path());
+      obj.erase(e.first);
+    }
+  }
+}
+
+void
+Body::setScope(std::set<std::string> const& s)
+{
+  m_scope = s;
+  m_scoped = true;
+}
+
+void
+Body::clearScope()
+{
+  m_scope.clear();
+  m_scoped = false;
+}
+
+void
+Body::display(std::ostream& o, Coach::Branch const& br) const
 {
   size_t count = 0;
   for (auto& e : m_types) {
@@ -288,24 +562,25 @@ Body::display(Coach::Branch const& br) const
     count += 1;
     here = br.push(count == m_types.size() ? Coach::Branch::Corner
                                            : Coach::Branch::Tee);
-    e.second->display(here);
+    e.second->display(o, here);
   }
 }
 
 bool
-Body::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
+Body::explain(std::ostream& o, tree::Path const& p,
+              tree::Path::const_iterator const& i) const
 {
   if (i != p.end()) {
     switch ((*i)->type()) {
       case tree::path::Item::Type::Named: {
         if (m_types.find((*i)->value()) != m_types.end()) {
-          return m_types.at((*i)->value())->explain(p, p.down(i));
+          return m_types.at((*i)->value())->explain(o, p, p.down(i));
         }
       } break;
       case tree::path::Item::Type::Any: {
         if (p.down(i) != p.end()) {
           for (auto& t : m_types) {
-            t.second->explain(p, p.down(i));
+            t.second->explain(o, p, p.down(i));
           }
         } else {
           size_t maxlen = 0;
@@ -321,15 +596,15 @@ Body::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
               case BasicType::Kind::Class:
               case BasicType::Kind::Plugin:
               case BasicType::Kind::Selector:
-                std::cout << " > ";
+                o << " > ";
                 break;
               default:
-                std::cout << " * ";
+                o << " * ";
                 break;
             }
-            std::cout << std::left << std::setw(static_cast<int>(maxlen) + 2)
-                      << t.first << " : ";
-            std::cout << std::left << bt << std::endl;
+            o << std::left << std::setw(static_cast<int>(maxlen) + 2)
+              << t.first << " : ";
+            o << std::left << bt << std::endl;
           }
         }
       }
@@ -341,4 +616,126 @@ Body::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
   return false;
 }
 
+bool
+Body::inScope(std::string const& n) const
+{
+  return not m_scoped or m_scope.count(n) != 0;
+}
+
+bool
+Body::buildDependencyGraph()
+{
+  m_order.clear();
+  m_affects.clear();
+  /**
+   * Build the graph of the types
+   */
+  std::vector<std::string> names;
+  std::map<std::string, size_t> ids;
+  for (auto& e : m_types) {
+    ids[e.first] = names.size();
+    names.push_back(e.first);
+  }
+  Components::Graph graph(names.size());
+  std::set<std::pair<size_t, size_t>> disabling;
+  std::set<size_t> dynamic;
+  for (auto& e : m_types) {
+    BasicType const& bt = *e.second;
+    if (not bt.hasDependencies()) {
+      continue;
+    }
+    size_t src = ids[e.first];
+    for (auto& d : bt.dependencies()) {
+      bool dis = dynamic_cast<const DisableDependency*>(d.get()) != nullptr;
+      for (auto& p : d->paths()) {
+        std::string tgt;
+        if (not targetOf(p, tgt)) {
+          dynamic.insert(src);
+        } else if (ids.count(tgt) != 0) {
+          graph[src].insert(ids[tgt]);
+          if (dis) {
+            disabling.insert({ src, ids[tgt] });
+          }
+        }
+      }
+    }
+  }
+  /**
+   * Reject the cycles that disable types, as their outcome would depend on
+   * the order of the walk
+   */
+  Components scc(graph);
+  std::vector<size_t> sizes(scc.count, 0);
+  for (size_t v = 0; v < names.size(); v += 1) {
+    sizes[scc.component[v]] += 1;
+  }
+  for (auto& e : disabling) {
+    size_t c = scc.component[e.first];
+    if (sizes[c] > 1 and c == scc.component[e.second]) {
+      std::string members;
+      for (size_t v = 0; v < names.size(); v += 1) {
+        if (scc.component[v] == c) {
+          members += members.empty() ? names[v] : ", " + names[v];
+        }
+      }
+      ERROR(ERR_DEPS_DISABLE_CYCLE(members));
+      return false;
+    }
+  }
+  /**
+   * Order the types topologically, by name among independent types
+   */
+  std::vector<std::set<size_t>> succs(scc.count);
+  std::vector<size_t> preds(scc.count, 0);
+  for (size_t v = 0; v < names.size(); v += 1) {
+    for (auto w : graph[v]) {
+      size_t a = scc.component[v], b = scc.component[w];
+      if (a != b and succs[a].insert(b).second) {
+        preds[b] += 1;
+      }
+    }
+  }
+  std::vector<std::vector<size_t>> members(scc.count);
+  for (size_t v = 0; v < names.size(); v += 1) {
+    members[scc.component[v]].push_back(v);
+  }
+  using Item = std::pair<size_t, size_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> ready;
+  for (size_t c = 0; c < scc.count; c += 1) {
+    if (preds[c] == 0) {
+      ready.push({ members[c].front(), c });
+    }
+  }
+  std::vector<size_t> position(names.size(), 0);
+  while (not ready.empty()) {
+    size_t c = ready.top().second;
+    ready.pop();
+    for (auto v : members[c]) {
+      position[v] = m_order.size();
+      m_order.push_back(names[v]);
+    }
+    for (auto n : succs[c]) {
+      if (--preds[n] == 0) {
+        ready.push({ members[n].front(), n });
+      }
+    }
+  }
+  /**
+   * Record the types affected by the dependencies of each type
+   */
+  for (size_t v = 0; v < names.size(); v += 1) {
+    if (dynamic.count(v) != 0) {
+      for (size_t i = 0; i < names.size(); i += 1) {
+        m_affects[names[v]].push_back(i);
+      }
+    } else {
+      for (auto w : graph[v]) {
+        m_affects[names[v]].push_back(position[w]);
+      }
+    }
+  }
+  DEBUG("Dependency order: ", m_order.size(), " types");
+  return true;
+}
+
 }}
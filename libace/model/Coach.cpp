@@ -101,14 +101,15 @@ Coach::Branch::front() const
 }
 
 void
-Coach::display(Branch const& br) const
+Coach::display(std::ostream& o, Branch const& br) const
 {}
 
 bool
-Coach::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
+Coach::explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const
 {
   if (i == p.end()) {
-    std::cout << "[" << p << "]" << std::endl;
+    o << "[" << p << "]" << std::endl;
   }
   return true;
 }
@@ -164,6 +164,12 @@ Dependency::merge(Dependency const& o)
   }
 }
 
+std::set<std::string> const&
+Dependency::paths() const
+{
+  return m_deps;
+}
+
 bool
 Dependency::hasPlaceHolder(std::string const& d) const
 {
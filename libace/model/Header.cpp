@@ -178,25 +178,26 @@ Header::loadModel(tree::Value const& t)
 }
 
 bool
-Header::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
+Header::explain(std::ostream& o, tree::Path const& p,
+                tree::Path::const_iterator const& i) const
 {
   if (i != p.end()) {
     return false;
   }
   if (m_include.size() != 0) {
-    std::cout << " * Include : ";
+    o << " * Include : ";
     for (auto& e : m_include) {
-      std::cout << e;
+      o << e;
       if (e != *m_include.rbegin()) {
-        std::cout << std::endl << "           | ";
+        o << std::endl << "           | ";
       }
     }
-    std::cout << std::endl;
+    o << std::endl;
   }
   if (m_hasAuthor) {
-    std::cout << " * Author  : " << m_author << std::endl;
+    o << " * Author  : " << m_author << std::endl;
   }
-  std::cout << " * Summary : " << m_doc << std::endl;
+  o << " * Summary : " << m_doc << std::endl;
   return true;
 }
 
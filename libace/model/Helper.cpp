@@ -22,6 +22,7 @@
 
 #include <ace/model/Helper.h>
 #include <ace/model/Model.h>
+#include <ace/engine/Context.h>
 #include <ace/engine/Master.h>
 #include <ace/tree/Utils.h>
 #include <fstream>
@@ -50,19 +51,12 @@ validate(std::string const& mp, std::string const& ver, const bool strict,
     ACE_LOG(Error, "Model \"" + mp + "\" is not inline");
     return false;
   }
-  if (not Model::check(nullptr, mp)) {
-    ACE_LOG(Error, "Check model \"" + mp + "\" failed");
-    return false;
-  }
-  mdl = Model::load(nullptr, mp);
-  if (not mdl->flattenModel()) {
-    ACE_LOG(Error, "Flatten model \"" + mp + "\" failed");
-    return false;
-  }
-  if (not mdl->validateModel()) {
-    ACE_LOG(Error, "Validate model \"" + mp + "\" failed");
+  mdl = Model::load(mp);
+  if (mdl == nullptr) {
     return false;
   }
+  engine::Context context;
+  engine::Context::Scope scope(context);
   if (not mdl->checkInstance(*svr)) {
     ACE_LOG(Error, "Check instance failed");
     return false;
@@ -76,8 +70,8 @@ validate(std::string const& mp, std::string const& ver, const bool strict,
     ACE_LOG(Error, "Resolve instance failed");
     return false;
   }
-  if (strict and not MASTER.unexpected().empty()) {
-    for (auto const& v : MASTER.unexpected()) {
+  if (strict and not context.unexpected().empty()) {
+    for (auto const& v : context.unexpected()) {
       ACE_LOG(Error, "Unexpected value: ", v);
     }
     return false;
@@ -98,20 +92,11 @@ printAsTree(std::string const& mp, std::string const& ver)
     ACE_LOG(Error, "Cannot find model \"" + mp + "\"");
     return false;
   }
-  if (not Model::check(nullptr, mp)) {
-    ACE_LOG(Error, "Check model \"" + mp + "\" failed");
-    return false;
-  }
-  mdl = Model::load(nullptr, mp);
-  if (not mdl->flattenModel()) {
-    ACE_LOG(Error, "Flatten model \"" + mp + "\" failed");
+  mdl = Model::load(mp);
+  if (mdl == nullptr) {
     return false;
   }
-  if (not mdl->validateModel()) {
-    ACE_LOG(Error, "Validate model \"" + mp + "\" failed");
-    return false;
-  }
-  mdl->display(model::Coach::Branch::Root);
+  mdl->display(std::cout, model::Coach::Branch::Root);
   return true;
 }
 
@@ -128,17 +113,8 @@ explain(std::string const& mp, std::string const& ver, std::string const& cp)
     ACE_LOG(Error, "Cannot find model \"" + mp + "\"");
     return false;
   }
-  if (not Model::check(nullptr, mp)) {
-    ACE_LOG(Error, "check model \"" + mp + "\" failed");
-    return false;
-  }
-  mdl = Model::load(nullptr, mp);
-  if (not mdl->flattenModel()) {
-    ACE_LOG(Error, "Flatten model \"" + mp + "\" failed");
-    return false;
-  }
-  if (not mdl->validateModel()) {
-    ACE_LOG(Error, "Validate model \"" + mp + "\" failed");
+  mdl = Model::load(mp);
+  if (mdl == nullptr) {
     return false;
   }
   tree::Path path = tree::Path::parse(cp);
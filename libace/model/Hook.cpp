@@ -23,7 +23,6 @@
 #include <ace/model/Hook.h>
 #include <ace/model/Errors.h>
 #include <ace/common/Log.h>
-#include <ace/common/Regex.h>
 #include <ace/common/String.h>
 #include <ace/tree/Checker.h>
 #include <ace/tree/Primitive.h>
@@ -64,8 +63,9 @@ Hook::load(tree::Object const& r)
   auto const& f = static_cast<tree::Primitive const&>(r.get("from"));
   auto const& t = static_cast<tree::Primitive const&>(r.get("to"));
   m_path = tree::Path::parse(p.value<std::string>());
-  m_pattern = f.value<std::string>();
-  m_value = t.value<std::string>();
+  m_query = tree::Query(m_path);
+  m_pattern = common::Regex::Pattern(f.value<std::string>());
+  m_value = common::Regex::Rewrite(t.value<std::string>());
   /*
    * Check if the exact mode is defined.
    */
@@ -78,13 +78,13 @@ Hook::load(tree::Object const& r)
 bool
 Hook::match(std::string const& s) const
 {
-  return common::Regex::match(s, m_pattern);
+  return m_pattern.match(s);
 }
 
 bool
 Hook::transform(std::string const& v, std::string& r) const
 {
-  return common::Regex::expand(v, m_pattern, m_value, r);
+  return m_pattern.expand(v, m_value, r);
 }
 
 tree::Path const&
@@ -93,16 +93,22 @@ Hook::path() const
   return m_path;
 }
 
+tree::Query const&
+Hook::query() const
+{
+  return m_query;
+}
+
 std::string const&
 Hook::pattern() const
 {
-  return m_pattern;
+  return m_pattern.source();
 }
 
 std::string const&
 Hook::value() const
 {
-  return m_value;
+  return m_value.source();
 }
 
 bool
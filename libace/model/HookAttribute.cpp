@@ -23,6 +23,9 @@
 #include <ace/model/Errors.h>
 #include <ace/model/HookAttribute.h>
 #include <ace/model/Model.h>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace ace { namespace model {
 
@@ -87,7 +90,11 @@ HookAttribute::resolveInstance(tree::Object const& r,
                                tree::Value const& v) const
 {
   tree::Path const& p = hook().path();
-  if (not r.has(p)) {
+  std::vector<const tree::Value*> hooked;
+  hook().query().run(r, [&](const size_t k, tree::Value const& val) {
+    hooked.push_back(&val);
+  });
+  if (hooked.empty() and not r.has(p)) {
     ERROR(ERR_NO_HOOKED_VALUE_IN_INSTANCE(hook().path()));
     return false;
   }
@@ -103,8 +110,8 @@ HookAttribute::resolveInstance(tree::Object const& r,
       mv.insert(p.value());
     }
   });
-  r.get(p, [&](tree::Value const& val) {
-    val.each([&](tree::Value const& w) {
+  for (auto val : hooked) {
+    val->each([&](tree::Value const& w) {
       if (w.type() == tree::Value::Type::Object) {
         tree::Object const& o = static_cast<tree::Object const&>(w);
         for (auto& e : o) {
@@ -115,7 +122,7 @@ HookAttribute::resolveInstance(tree::Object const& r,
         hv.insert(p.value());
       }
     });
-  });
+  }
   std::set<std::string> txv;
   for (auto& e : hv) {
     if (not hook().match(e)) {
@@ -0,0 +1,280 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/model/Image.h>
+#include <ace/engine/Master.h>
+#include <ace/tree/Arena.h>
+#include <ace/tree/Array.h>
+#include <ace/tree/Object.h>
+#include <ace/tree/Primitive.h>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The image layout is the following (native byte order):
+ *
+ *   u32 magic | u32 format | str version | str root | u32 count | entry*
+ *
+ * where an entry is a model name followed by its encoded source tree:
+ *
+ *   entry := str name | value
+ *   value := u8 type | str name | payload
+ *   str   := u32 length | bytes
+ *
+ * Booleans are encoded as u8, integers as i64, floats as f64. Arrays and
+ * objects are encoded as a u32 element count followed by their elements.
+ */
+
+namespace {
+
+using namespace ace;
+
+const uint32_t MAGIC = 0x41434549;
+const uint32_t FORMAT = 1;
+
+template<typename T>
+void
+writeRaw(std::ostream& o, T const& v)
+{
+  o.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+void
+writeString(std::ostream& o, std::string const& s)
+{
+  writeRaw<uint32_t>(o, static_cast<uint32_t>(s.length()));
+  o.write(s.data(), static_cast<std::streamsize>(s.length()));
+}
+
+void
+writeValue(std::ostream& o, tree::Value const& v)
+{
+  writeRaw<uint8_t>(o, static_cast<uint8_t>(v.type()));
+  writeString(o, v.name());
+  switch (v.type()) {
+    case tree::Value::Type::Boolean: {
+      auto const& p = static_cast<tree::Primitive const&>(v);
+      writeRaw<uint8_t>(o, p.value<bool>() ? 1 : 0);
+    } break;
+    case tree::Value::Type::Integer: {
+      auto const& p = static_cast<tree::Primitive const&>(v);
+      writeRaw<int64_t>(o, p.value<long>());
+    } break;
+    case tree::Value::Type::Float: {
+      auto const& p = static_cast<tree::Primitive const&>(v);
+      writeRaw<double>(o, p.value<double>());
+    } break;
+    case tree::Value::Type::String: {
+      auto const& p = static_cast<tree::Primitive const&>(v);
+      writeString(o, p.value<std::string>());
+    } break;
+    case tree::Value::Type::Array: {
+      auto const& a = static_cast<tree::Array const&>(v);
+      writeRaw<uint32_t>(o, static_cast<uint32_t>(a.size()));
+      for (auto& e : a) {
+        writeValue(o, *e);
+      }
+    } break;
+    case tree::Value::Type::Object: {
+      auto const& b = static_cast<tree::Object const&>(v);
+      writeRaw<uint32_t>(o, static_cast<uint32_t>(b.size()));
+      for (auto& e : b) {
+        writeValue(o, *e.second);
+      }
+    } break;
+    default:
+      break;
+  }
+}
+
+class Reader
+{
+public:
+  Reader(const char* b, const size_t l) : m_cur(b), m_end(b + l) {}
+
+  template<typename T>
+  T read()
+  {
+    T v;
+    require(sizeof(T));
+    memcpy(&v, m_cur, sizeof(T));
+    m_cur += sizeof(T);
+    return v;
+  }
+
+  std::string readString()
+  {
+    auto len = read<uint32_t>();
+    require(len);
+    std::string s(m_cur, len);
+    m_cur += len;
+    return s;
+  }
+
+  tree::Value::Ref readValue()
+  {
+    auto type = static_cast<tree::Value::Type>(read<uint8_t>());
+    std::string name = readString();
+    switch (type) {
+      case tree::Value::Type::Boolean:
+        return tree::Primitive::build(name, read<uint8_t>() != 0);
+      case tree::Value::Type::Integer:
+        return tree::Primitive::build(name, static_cast<long>(read<int64_t>()));
+      case tree::Value::Type::Float:
+        return tree::Primitive::build(name, read<double>());
+      case tree::Value::Type::String:
+        return tree::Primitive::build(name, readString());
+      case tree::Value::Type::Array: {
+        auto array = tree::Array::build(name);
+        auto count = read<uint32_t>();
+        for (uint32_t i = 0; i < count; i += 1) {
+          array->push_back(readValue());
+        }
+        return array;
+      }
+      case tree::Value::Type::Object: {
+        auto object = tree::Object::build(name);
+        auto count = read<uint32_t>();
+        for (uint32_t i = 0; i < count; i += 1) {
+          object->put(readValue());
+        }
+        return object;
+      }
+      default:
+        break;
+    }
+    throw std::invalid_argument("Invalid value type in model image");
+  }
+
+private:
+  void require(const size_t n)
+  {
+    if (static_cast<size_t>(m_end - m_cur) < n) {
+      throw std::invalid_argument("Truncated model image");
+    }
+  }
+
+  const char* m_cur;
+  const char* m_end;
+};
+
+}
+
+namespace ace { namespace model { namespace Image {
+
+const char Extension[] = "aci";
+
+bool
+isImage(std::string const& fn)
+{
+  std::string ext = std::string(".") + Extension;
+  return fn.length() > ext.length() and
+         fn.compare(fn.length() - ext.length(), ext.length(), ext) == 0;
+}
+
+bool
+write(Model const& m, std::ostream& o)
+{
+  std::set<std::string> deps = { m.filePath() };
+  m.collectModelFileDependencies(deps);
+  std::vector<std::pair<std::string, tree::Value::Ref>> entries;
+  for (auto& d : deps) {
+    tree::Value::Ref root = Model::parse(d);
+    if (root == nullptr) {
+      ACE_LOG(Error, "Cannot read the source of model \"", d, "\"");
+      return false;
+    }
+    entries.push_back({ d, root });
+  }
+  writeRaw<uint32_t>(o, MAGIC);
+  writeRaw<uint32_t>(o, FORMAT);
+  writeString(o, ACE_VERSION);
+  writeString(o, m.filePath());
+  writeRaw<uint32_t>(o, static_cast<uint32_t>(entries.size()));
+  for (auto& e : entries) {
+    ACE_LOG(Debug, "Write model \"", e.first, "\" into image");
+    writeString(o, e.first);
+    writeValue(o, *e.second);
+  }
+  return not o.fail();
+}
+
+bool
+load(std::string const& fn, std::string& n)
+{
+  int fd = open(fn.c_str(), O_RDONLY);
+  if (fd == -1) {
+    ACE_LOG(Error, "Cannot open model image \"", fn, "\"");
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 or st.st_size == 0) {
+    ACE_LOG(Error, "Cannot read model image \"", fn, "\"");
+    close(fd);
+    return false;
+  }
+  auto len = static_cast<size_t>(st.st_size);
+  void* addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    ACE_LOG(Error, "Cannot map model image \"", fn, "\"");
+    return false;
+  }
+  bool result = true;
+  try {
+    tree::Arena::Scope scope;
+    Reader reader(static_cast<const char*>(addr), len);
+    if (reader.read<uint32_t>() != MAGIC or
+        reader.read<uint32_t>() != FORMAT) {
+      throw std::invalid_argument("Invalid model image format");
+    }
+    std::string ver = reader.readString();
+    if (ver != ACE_VERSION) {
+      throw std::invalid_argument("Model image version \"" + ver +
+                                  "\" and ACE version \"" + ACE_VERSION +
+                                  "\" mismatch");
+    }
+    n = reader.readString();
+    auto count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < count; i += 1) {
+      std::string name = reader.readString();
+      tree::Value::Ref root = reader.readValue();
+      ACE_LOG(Debug, "Register compiled model \"", name, "\"");
+      MASTER.addCompiledModel(name, root);
+    }
+  } catch (std::invalid_argument const& e) {
+    ACE_LOG(Error, "Cannot load model image \"", fn, "\": ", e.what());
+    result = false;
+  }
+  munmap(addr, len);
+  return result;
+}
+
+}}}
@@ -22,7 +22,10 @@
 
 #include <ace/model/Model.h>
 #include <ace/model/Errors.h>
+#include <ace/common/Resolver.h>
+#include <ace/engine/Context.h>
 #include <ace/engine/Master.h>
+#include <ace/tree/Arena.h>
 #include <ace/tree/Checker.h>
 #include <ace/types/Class.h>
 #include <ace/types/Plugin.h>
@@ -31,6 +34,7 @@
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -40,6 +44,11 @@ namespace {
 
 using namespace ace::model;
 
+using SessionTrees = std::map<std::string, ace::tree::Value::Ref>;
+
+static __thread size_t s_sessionDepth = 0;
+static __thread SessionTrees* s_sessionTrees = nullptr;
+
 void
 expandModelDependencies(std::set<std::string>& decls, BasicType const& bt)
 {
@@ -58,6 +67,25 @@ expandModelDependencies(std::set<std::string>& decls, BasicType const& bt)
   }
 }
 
+void
+expandPluginDependencies(std::set<std::string>& deps, BasicType const& bt)
+{
+  if (bt.kind() == BasicType::Kind::Class) {
+    Class const& type = dynamic_cast<Class const&>(bt);
+    type.modelAttribute().model().collectPluginDependencies(deps);
+  } else if (bt.kind() == BasicType::Kind::Selector) {
+    Selector const& type = dynamic_cast<Selector const&>(bt);
+    expandPluginDependencies(deps, type.templateType());
+  } else if (bt.kind() == BasicType::Kind::Plugin) {
+    Plugin const& type = dynamic_cast<Plugin const&>(bt);
+    deps.insert(type.modelAttribute().head());
+    type.model().collectPluginDependencies(deps);
+    for (auto& e : type.plugins()) {
+      expandPluginDependencies(deps, *e.second);
+    }
+  }
+}
+
 }
 
 namespace ace { namespace model {
@@ -71,14 +99,40 @@ namespace ace { namespace model {
 
 Model::Context::Context(std::string const& path) : m_path(path)
 {
-  if (not MASTER.addModelPathIntoContext(m_path)) {
+  if (not CONTEXT.addModelPath(m_path)) {
     throw std::runtime_error("Duplicate path in context: " + m_path);
   }
 }
 
 Model::Context::~Context()
 {
-  MASTER.remModelPathFromContext(m_path);
+  CONTEXT.remModelPath(m_path);
+}
+
+/**
+ * Session class.
+ *
+ * The role of this class is to keep the parsed model sources around for the
+ * duration of a top-level load, so that the check and load phases of a model
+ * and of all the models it references work on the same tree. Its design is
+ * RAII and sessions can be nested. Sessions are local to the calling thread.
+ */
+
+Model::Session::Session()
+{
+  if (s_sessionDepth == 0) {
+    s_sessionTrees = new SessionTrees;
+  }
+  s_sessionDepth += 1;
+}
+
+Model::Session::~Session()
+{
+  s_sessionDepth -= 1;
+  if (s_sessionDepth == 0) {
+    delete s_sessionTrees;
+    s_sessionTrees = nullptr;
+  }
 }
 
 /**
@@ -86,7 +140,14 @@ Model::Context::~Context()
  */
 
 Model::Model(std::string const& fn)
-  : m_ext(), m_source(), m_header(), m_templates(), m_body(), m_includes()
+  : m_ext()
+  , m_source()
+  , m_header()
+  , m_templates()
+  , m_body()
+  , m_includes()
+  , m_flattened(false)
+  , m_validated(false)
 {
   std::vector<std::string> elems;
   common::String::split(fn, '.', elems);
@@ -110,6 +171,8 @@ Model::Model(Model const& o)
   , m_templates(o.m_templates)
   , m_body(o.m_body)
   , m_includes(o.m_includes)
+  , m_flattened(o.m_flattened)
+  , m_validated(o.m_validated)
 {
   m_header.setParent(this);
   m_templates.setParent(this);
@@ -189,6 +252,9 @@ Model::loadModel(tree::Value const& t)
 bool
 Model::flattenModel()
 try {
+  if (m_flattened) {
+    return true;
+  }
   Context context(filePath());
   if (not m_body.flattenModel()) {
     return false;
@@ -197,12 +263,13 @@ try {
   DEBUG("Merge ", m_header.include().size(), " included models");
   for (auto& fp : m_header.include()) {
     DEBUG("Check \"", fp, "\"");
-    if (not check(nullptr, fp)) {
+    tree::Value::Ref root = parse(fp);
+    if (root == nullptr or not check(nullptr, fp, *root)) {
       ERROR(ERR_INVALID_MODEL(fp));
       return false;
     }
     DEBUG("Load \"", fp, "\"");
-    Ref xm = load(nullptr, fp);
+    Ref xm = load(nullptr, fp, *root);
     DEBUG("Flatten \"", fp, "\"");
     if (not xm->flattenModel()) {
       return false;
@@ -231,6 +298,8 @@ try {
       return false;
     }
   }
+  m_flattened = true;
+  MASTER.cacheModel(filePath(), *this);
   return true;
 } catch (std::runtime_error const& e) {
   ERROR(ERR_MODEL_LOOP_DETECTED(filePath()));
@@ -240,11 +309,23 @@ try {
 bool
 Model::validateModel()
 {
-  if (not MASTER.hasModel(filePath())) {
-    ERROR(ERR_INVALID_PACKAGE_PATH(filePath()));
+  if (m_validated) {
+    return true;
+  }
+  if (not MASTER.isCompiledModel(filePath())) {
+    if (not MASTER.hasModel(filePath())) {
+      ERROR(ERR_INVALID_PACKAGE_PATH(filePath()));
+      return false;
+    }
+    if (not m_body.validateModel()) {
+      return false;
+    }
+  } else if (not m_body.buildDependencyGraph()) {
     return false;
   }
-  return m_body.validateModel();
+  m_validated = true;
+  MASTER.cacheModel(filePath(), *this);
+  return true;
 }
 
 bool
@@ -272,20 +353,21 @@ Model::resolveInstance(tree::Object const& r, tree::Value const& v) const
 }
 
 void
-Model::display(Coach::Branch const& br) const
+Model::display(std::ostream& o, Coach::Branch const& br) const
 {
-  m_body.display(br);
+  m_body.display(o, br);
 }
 
 bool
-Model::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
+Model::explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const
 {
-  Coach::explain(p, i);
+  Coach::explain(o, p, i);
   if (i == p.end()) {
-    m_header.explain(p, i);
+    m_header.explain(o, p, i);
     return true;
   } else {
-    return m_body.explain(p, i);
+    return m_body.explain(o, p, i);
   }
 }
 
@@ -389,6 +471,20 @@ Model::headerGuard(std::string const& n) const
   return hdr;
 }
 
+void
+Model::collectPluginDependencies(std::set<std::string>& d) const
+{
+  for (auto& e : m_includes) {
+    e->collectPluginDependencies(d);
+  }
+  for (auto& e : m_templates) {
+    expandPluginDependencies(d, *e.second);
+  }
+  for (auto& e : m_body) {
+    expandPluginDependencies(d, *e.second);
+  }
+}
+
 void
 Model::collectModelFileDependencies(std::set<std::string>& d) const
 {
@@ -404,64 +500,108 @@ Model::collectModelFileDependencies(std::set<std::string>& d) const
   }
 }
 
-bool
-Model::check(const Object* o, std::string const& n)
+tree::Value::Ref
+Model::parse(std::string const& n)
 {
   tree::Value::Ref root;
+  if (s_sessionTrees != nullptr and s_sessionTrees->count(n) != 0) {
+    return s_sessionTrees->at(n);
+  }
+  if (MASTER.isCompiledModel(n)) {
+    ACE_LOG(Debug, "Use compiled model \"", n, "\"");
+    return MASTER.compiledModelFor(n);
+  }
   if (not MASTER.hasScannerByExtension(n)) {
     ACE_LOG(Error, "Missing scanner for file type \"", n, "\"");
-    return false;
+    return nullptr;
   }
+  tree::Arena::Scope scope;
   if (MASTER.isInlinedModel(n)) {
-    ACE_LOG(Debug, "Check inlined model \"", n, "\"");
+    ACE_LOG(Debug, "Parse inlined model \"", n, "\"");
     root =
       MASTER.scannerByExtension(n).parse(MASTER.modelSourceFor(n), 0, nullptr);
   } else if (MASTER.hasModel(n)) {
     fs::Path path = MASTER.modelPathFor(n);
-    ACE_LOG(Debug, "Check model \"", n, "\" @ PATH -> ", path);
+    ACE_LOG(Debug, "Parse model \"", n, "\" @ PATH -> ", path);
     root = MASTER.scannerByExtension(n).open(path.toString(), 0, nullptr);
   }
   if (root == nullptr) {
     ACE_LOG(Warning, "Model \"", n,
             "\" not found, either inline or in the search path");
+    return nullptr;
+  }
+  if (s_sessionTrees != nullptr) {
+    (*s_sessionTrees)[n] = root;
+  }
+  return root;
+}
+
+bool
+Model::check(const Object* o, std::string const& n)
+{
+  if (MASTER.hasCachedModel(n)) {
+    ACE_LOG(Debug, "Model \"", n, "\" already checked");
+    return true;
+  }
+  tree::Value::Ref root = parse(n);
+  if (root == nullptr) {
     return false;
   }
+  return check(o, n, *root);
+}
+
+bool
+Model::check(const Object* o, std::string const& n, tree::Value const& t)
+{
+  if (MASTER.isCompiledModel(n)) {
+    ACE_LOG(Debug, "Model \"", n, "\" is compiled");
+    return true;
+  }
+  ACE_LOG(Debug, "Check model \"", n, "\"");
   Model aModel(*fs::Path(n).rbegin());
   aModel.setParent(o);
-  if (not aModel.checkModel(*root)) {
-    return false;
-  }
-  return true;
+  return aModel.checkModel(t);
 }
 
 Model::Ref
 Model::load(Object* o, std::string const& n)
 {
-  tree::Value::Ref root;
-  if (MASTER.isInlinedModel(n)) {
-    ACE_LOG(Debug, "Load inlined model \"", n, "\"");
-    root =
-      MASTER.scannerByExtension(n).parse(MASTER.modelSourceFor(n), 0, nullptr);
-  } else if (MASTER.hasModel(n)) {
-    fs::Path path = MASTER.modelPathFor(n);
-    ACE_LOG(Debug, "Load model \"", n, "\" @ PATH -> ", path);
-    root = MASTER.scannerByExtension(n).open(path.toString(), 0, nullptr);
+  Model::Ref cached = MASTER.cachedModelFor(n);
+  if (cached != nullptr) {
+    ACE_LOG(Debug, "Load cached model \"", n, "\"");
+    cached->setParent(o);
+    return cached;
   }
+  tree::Value::Ref root = parse(n);
+  if (root == nullptr) {
+    return nullptr;
+  }
+  return load(o, n, *root);
+}
+
+Model::Ref
+Model::load(Object* o, std::string const& n, tree::Value const& t)
+{
+  ACE_LOG(Debug, "Load model \"", n, "\"");
   Model::Ref aModel(new Model(*fs::Path(n).rbegin()));
   aModel->setParent(o);
-  aModel->loadModel(*root);
+  aModel->loadModel(t);
   return aModel;
 }
 
 Model::Ref
 Model::load(std::string const& fn)
 {
-  model::Model::Ref mdl;
-  if (not model::Model::check(nullptr, fn)) {
-    ACE_LOG(Error, "Check model \"" + fn + "\" failed");
-    return nullptr;
+  Session session;
+  model::Model::Ref mdl = MASTER.cachedModelFor(fn);
+  if (mdl == nullptr) {
+    tree::Value::Ref root = parse(fn);
+    if (root == nullptr or not check(nullptr, fn, *root)) {
+      ACE_LOG(Error, "Check model \"" + fn + "\" failed");
+      return nullptr;
+    }
+    mdl = load(nullptr, fn, *root);
   }
-  mdl = model::Model::load(nullptr, fn);
   if (not mdl->flattenModel()) {
     ACE_LOG(Error, "Flatten model \"" + fn + "\" failed");
     return nullptr;
@@ -481,11 +621,15 @@ Model::validate(std::string const& cfgName, const int argc, char** const argv)
     ACE_LOG(Error, "Unsupported configuration file format: ", cfgName);
     return nullptr;
   }
-  svr = MASTER.scannerByExtension(cfgName).open(cfgName, argc, argv);
+  {
+    tree::Arena::Scope scope;
+    svr = MASTER.scannerByExtension(cfgName).open(cfgName, argc, argv);
+  }
   if (svr == nullptr) {
     ACE_LOG(Error, "Cannot open configuration file \"" + cfgName + "\"");
     return nullptr;
   }
+  probeInstance(*svr);
   if (not checkInstance(*svr)) {
     ACE_LOG(Error, "Check configuration \"" + cfgName + "\" failed");
     return nullptr;
@@ -502,6 +646,46 @@ Model::validate(std::string const& cfgName, const int argc, char** const argv)
   return svr;
 }
 
+bool
+Model::revalidate(tree::Value& v, std::vector<tree::Path> const& c)
+{
+  std::set<std::string> scope;
+  if (m_body.collectAffected(c, scope)) {
+    ACE_LOG(Debug, "Revalidate ", scope.size(), " options");
+    m_body.setScope(scope);
+  } else {
+    ACE_LOG(Debug, "Revalidate all options");
+  }
+  m_body.dropInjected(v, c);
+  bool result = false;
+  probeInstance(v);
+  if (not checkInstance(v)) {
+    ACE_LOG(Error, "Check configuration failed");
+  } else {
+    expandInstance(v);
+    if (not flattenInstance(v)) {
+      ACE_LOG(Error, "Flatten configuration failed");
+    } else if (not resolveInstance(v)) {
+      ACE_LOG(Error, "Resolve configuration failed");
+    } else {
+      result = true;
+    }
+  }
+  m_body.clearScope();
+  return result;
+}
+
+Model::Ref
+Model::clone() const
+{
+  Model::Ref mdl(new Model(*this));
+  for (auto& e : mdl->m_templates) {
+    e.second = e.second->clone(e.first);
+    e.second->setParent(&mdl->m_templates);
+  }
+  return mdl;
+}
+
 bool
 Model::isAnAncestor(Model const& m) const
 {
@@ -845,8 +1029,7 @@ Model::generateImplementationSource(std::ostream& o) const
     << "(ace::tree::Object const &" << (m_body.empty() ? "" : " r") << ") {";
   o << std::endl;
   for (auto& e : m_body) {
-    auto str = e.second->path(true).toString();
-    e.second->doBuildDefinition("\"" + str + "\"", o, 2);
+    e.second->doBuildDefinition("r.find(\"" + e.first + "\")", o, 2);
   }
   o << "}" << std::endl;
   o << std::endl;
@@ -937,9 +1120,15 @@ Model::resolveInstance(tree::Value const& v) const
 
 bool
 Model::explain(tree::Path const& p) const
+{
+  return explain(std::cout, p);
+}
+
+bool
+Model::explain(std::ostream& o, tree::Path const& p) const
 {
   tree::Path::const_iterator n(p.begin());
-  return explain(p, p.down(n));
+  return explain(o, p, p.down(n));
 }
 
 Header const&
@@ -1008,6 +1197,23 @@ Model::nullBuilder(tree::Value const& v)
   throw std::runtime_error("Default plugin NullBuilder should not be called");
 }
 
+void
+Model::probeInstance(tree::Value const& v) const
+{
+  BasicType::Probes probes;
+  m_body.collectProbes(v, probes);
+  if (common::Resolver::get().enabled() and not probes.hosts.empty()) {
+    ACE_LOG(Debug, "Resolve ", probes.hosts.size(), " host names");
+    common::Resolver::get().resolve(probes.hosts);
+  }
+  CONTEXT.probe().clear();
+  if (not probes.paths.empty()) {
+    CONTEXT.probe().probe(probes.paths);
+    ACE_LOG(Debug, "Probed ", CONTEXT.probe().probed(), " paths in ",
+            CONTEXT.probe().elapsed(), " ms");
+  }
+}
+
 std::string
 Model::normalizedName() const
 {
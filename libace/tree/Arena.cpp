@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/tree/Arena.h>
+#include <cstdint>
+
+namespace {
+
+const size_t CHUNK_SIZE = 64 * 1024;
+
+const ace::tree::Arena::Ref s_none;
+
+/*
+ * The scopes own their arena, the thread only points to the innermost one.
+ */
+static __thread ace::tree::Arena::Scope* s_scope = nullptr;
+
+}
+
+namespace ace { namespace tree {
+
+Arena::Scope::Scope() : m_arena(std::make_shared<Arena>()), m_previous(s_scope)
+{
+  s_scope = this;
+}
+
+Arena::Scope::~Scope()
+{
+  s_scope = m_previous;
+}
+
+Arena::Arena()
+  : m_chunks(), m_capacity(0), m_cursor(nullptr), m_limit(nullptr)
+{}
+
+/**
+ * Allocations are carved out of the current chunk. A new chunk is allocated
+ * when the current one is exhausted. Large allocations get their own chunk.
+ */
+
+void*
+Arena::allocate(const size_t size, const size_t align)
+{
+  auto mask = static_cast<uintptr_t>(align) - 1;
+  auto limit = reinterpret_cast<uintptr_t>(m_limit);
+  auto addr = (reinterpret_cast<uintptr_t>(m_cursor) + mask) & ~mask;
+  if (m_cursor == nullptr or addr + size > limit) {
+    size_t len = size + align > CHUNK_SIZE ? size + align : CHUNK_SIZE;
+    m_chunks.emplace_back(new char[len]);
+    m_capacity += len;
+    m_cursor = m_chunks.back().get();
+    m_limit = m_cursor + len;
+    addr = (reinterpret_cast<uintptr_t>(m_cursor) + mask) & ~mask;
+  }
+  m_cursor = reinterpret_cast<char*>(addr + size);
+  return reinterpret_cast<void*>(addr);
+}
+
+size_t
+Arena::capacity() const
+{
+  return m_capacity;
+}
+
+Arena::Ref const&
+Arena::current()
+{
+  return s_scope == nullptr ? s_none : s_scope->m_arena;
+}
+
+}}
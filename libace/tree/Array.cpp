@@ -21,6 +21,7 @@
  */
 
 #include <ace/common/Log.h>
+#include <ace/tree/Arena.h>
 #include <ace/tree/Array.h>
 #include <ace/tree/Object.h>
 #include <ace/tree/Primitive.h>
@@ -31,7 +32,9 @@
 
 namespace ace { namespace tree {
 
-Array::Array(std::string const& n) : Value(n, Type::Array), m_content() {}
+Array::Array(std::string const& n, Arena* a)
+  : Value(n, Type::Array), m_content(Arena::Storage<Value::Ref>(a))
+{}
 
 Array::Array(Array const& a) : Value(a), m_content()
 {
@@ -51,7 +54,12 @@ Array::clone() const
 Array::Ref
 Array::build(std::string const& n)
 {
-  return Ref(new Array(n));
+  Arena::Ref const& arena = Arena::current();
+  if (arena != nullptr) {
+    void* mem = arena->allocate(sizeof(Array), alignof(Array));
+    return Arena::own(new (mem) Array(n, arena.get()), arena);
+  }
+  return Ref(new Array(n, nullptr));
 }
 
 void
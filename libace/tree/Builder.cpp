@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/tree/Builder.h>
+#include <ace/common/Log.h>
+#include <ace/tree/Array.h>
+#include <ace/tree/Object.h>
+#include <ace/tree/Primitive.h>
+#include <string>
+#include <string_view>
+
+namespace {
+
+bool
+emit(ace::tree::Value const& v, std::string_view k, ace::tree::Handler& h)
+{
+  using namespace ace::tree;
+  switch (v.type()) {
+    case Value::Type::Object: {
+      Object const& o = static_cast<Object const&>(v);
+      if (not h.onObjectStart(k)) {
+        return false;
+      }
+      for (auto const& e : o) {
+        if (not emit(*e.second, e.first.str(), h)) {
+          return false;
+        }
+      }
+      return h.onEnd();
+    }
+    case Value::Type::Array: {
+      Array const& a = static_cast<Array const&>(v);
+      if (not h.onArrayStart(k)) {
+        return false;
+      }
+      for (auto const& e : a) {
+        if (not emit(*e, std::string_view(), h)) {
+          return false;
+        }
+      }
+      return h.onEnd();
+    }
+    case Value::Type::Boolean: {
+      Primitive const& p = static_cast<Primitive const&>(v);
+      return h.onBoolean(k, p.value<bool>());
+    }
+    case Value::Type::Integer: {
+      Primitive const& p = static_cast<Primitive const&>(v);
+      return h.onInteger(k, p.value<long>());
+    }
+    case Value::Type::Float: {
+      Primitive const& p = static_cast<Primitive const&>(v);
+      return h.onFloat(k, p.value<double>());
+    }
+    case Value::Type::String: {
+      Primitive const& p = static_cast<Primitive const&>(v);
+      return h.onString(k, p.value<std::string>());
+    }
+    default:
+      return true;
+  }
+}
+
+}
+
+namespace ace { namespace tree {
+
+Builder::Builder(const bool unique)
+  : m_unique(unique), m_stack(), m_root(nullptr)
+{}
+
+bool
+Builder::onObjectStart(std::string_view k)
+{
+  Value::Ref r = Object::build(name(k));
+  if (not add(r)) {
+    return false;
+  }
+  m_stack.push_back(r);
+  return true;
+}
+
+bool
+Builder::onArrayStart(std::string_view k)
+{
+  Value::Ref r = Array::build(name(k));
+  if (not add(r)) {
+    return false;
+  }
+  m_stack.push_back(r);
+  return true;
+}
+
+bool
+Builder::onEnd()
+{
+  if (m_stack.empty()) {
+    return false;
+  }
+  m_stack.pop_back();
+  return true;
+}
+
+bool
+Builder::onBoolean(std::string_view k, const bool v)
+{
+  return add(Primitive::build(name(k), v));
+}
+
+bool
+Builder::onInteger(std::string_view k, const long v)
+{
+  return add(Primitive::build(name(k), v));
+}
+
+bool
+Builder::onFloat(std::string_view k, const double v)
+{
+  return add(Primitive::build(name(k), v));
+}
+
+bool
+Builder::onString(std::string_view k, std::string_view v)
+{
+  return add(Primitive::build(name(k), std::string(v)));
+}
+
+Value::Ref
+Builder::value() const
+{
+  return m_stack.empty() ? m_root : nullptr;
+}
+
+bool
+Builder::emit(Value const& v, Handler& h)
+{
+  return ::emit(v, std::string_view(), h);
+}
+
+bool
+Builder::add(Value::Ref const& r)
+{
+  if (m_stack.empty()) {
+    if (m_root != nullptr) {
+      return false;
+    }
+    m_root = r;
+    return true;
+  }
+  Value& top = *m_stack.back();
+  switch (top.type()) {
+    case Value::Type::Object: {
+      Object& o = static_cast<Object&>(top);
+      if (m_unique and o.has(r->name())) {
+        ACE_LOG(Error, "duplicate object key: ", r->name());
+        return false;
+      }
+      o.put(r);
+      return true;
+    }
+    case Value::Type::Array:
+      static_cast<Array&>(top).push_back(r);
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::string
+Builder::name(std::string_view k) const
+{
+  if (not m_stack.empty() and m_stack.back()->type() == Value::Type::Array) {
+    return std::to_string(static_cast<Array const&>(*m_stack.back()).size());
+  }
+  return std::string(k);
+}
+
+}}
@@ -128,6 +128,12 @@ Item::root() const
 
 std::string const&
 Item::value() const
+{
+  return m_value.str();
+}
+
+common::Symbol const&
+Item::symbol() const
 {
   return m_value;
 }
@@ -194,9 +200,9 @@ Item::toString(const bool useBrackets) const
       break;
     case Item::Type::Named:
       if (useBrackets) {
-        o << "['" + m_value + "']";
+        o << "['" + m_value.str() + "']";
       } else {
-        o << (m_rec ? m_value : "." + m_value);
+        o << (m_rec ? m_value.str() : "." + m_value.str());
       }
       break;
     case Item::Type::Ranged:
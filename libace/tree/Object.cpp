@@ -21,32 +21,158 @@
  */
 
 #include <ace/tree/Object.h>
+#include <ace/tree/Arena.h>
 #include <ace/tree/Array.h>
 #include <ace/tree/Primitive.h>
 #include <ace/common/Log.h>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include <pthread.h>
+
+namespace {
+
+size_t
+hashOf(std::string const& k)
+{
+  return std::hash<std::string>()(k);
+}
+
+bool
+byKey(ace::tree::Object::Entry const& a, ace::tree::Object::Entry const& b)
+{
+  return a.first < b.first;
+}
+
+template<typename T>
+void
+insertSlot(T& slots, const size_t h, const size_t pos)
+{
+  size_t mask = slots.size() - 1;
+  size_t i = h & mask;
+  while (slots[i] != 0) {
+    i = (i + 1) & mask;
+  }
+  slots[i] = pos + 1;
+}
+
+/*
+ * Slots are removed with a backward shift, which moves up the following slots
+ * of the cluster that are not at their home position, so that no probe
+ * sequence is broken.
+ */
+template<typename T, typename C>
+void
+eraseSlot(T& slots, C const& content, const size_t h, const size_t pos)
+{
+  size_t mask = slots.size() - 1;
+  size_t i = h & mask;
+  while (slots[i] != pos + 1) {
+    i = (i + 1) & mask;
+  }
+  for (size_t j = (i + 1) & mask; slots[j] != 0; j = (j + 1) & mask) {
+    size_t k = content[slots[j] - 1].first.hash() & mask;
+    bool home = i <= j ? i < k and k <= j : i < k or k <= j;
+    if (not home) {
+      slots[i] = slots[j];
+      i = j;
+    }
+  }
+  slots[i] = 0;
+}
+
+/*
+ * Concurrent readers of an object may all try to sort it. The objects share a
+ * small set of locks to serialize the sort.
+ */
+struct Lock
+{
+  Lock() : mutex() { pthread_mutex_init(&mutex, nullptr); }
+  pthread_mutex_t mutex;
+};
+
+pthread_mutex_t&
+lockFor(const void* p)
+{
+  static Lock s_locks[64];
+  return s_locks[(reinterpret_cast<uintptr_t>(p) >> 6) % 64].mutex;
+}
+
+}
 
 namespace ace { namespace tree {
 
-Object::Object(std::string const& n) : Value(n, Type::Object), m_content() {}
+Object::const_iterator::const_iterator(Content::const_iterator const& c,
+                                       Content::const_iterator const& e)
+  : m_cur(c), m_end(e)
+{
+  skip();
+}
+
+Object::const_iterator&
+Object::const_iterator::operator++()
+{
+  ++m_cur;
+  skip();
+  return *this;
+}
 
-Object::Object(Object const& o) : Value(o), m_content()
+Object::const_iterator
+Object::const_iterator::operator++(int)
 {
-  for (auto const& e : o.m_content) {
+  const_iterator result = *this;
+  ++*this;
+  return result;
+}
+
+void
+Object::const_iterator::skip()
+{
+  while (m_cur != m_end and m_cur->second == nullptr) {
+    ++m_cur;
+  }
+}
+
+Object::Object(std::string const& n, Arena* a)
+  : Value(n, Type::Object)
+  , m_content(Arena::Storage<Entry>(a))
+  , m_slots(Arena::Storage<uint32_t>(a))
+  , m_sorted(0)
+  , m_ordered(true)
+  , m_holes(0)
+{}
+
+Object::Object(Object const& o)
+  : Value(o)
+  , m_content()
+  , m_slots()
+  , m_sorted(0)
+  , m_ordered(true)
+  , m_holes(0)
+{
+  m_content.reserve(o.size());
+  for (auto const& e : o) {
     auto n = e.second->clone();
     n->m_parent = this;
-    m_content[e.first] = n;
+    m_content.emplace_back(e.first, n);
   }
+  m_sorted = m_content.size();
+  reindex();
 }
 
 Object::Ref
 Object::build(std::string const& n)
 {
-  return Ref(new Object(n));
+  Arena::Ref const& arena = Arena::current();
+  if (arena != nullptr) {
+    void* mem = arena->allocate(sizeof(Object), alignof(Object));
+    return Arena::own(new (mem) Object(n, arena.get()), arena);
+  }
+  return Ref(new Object(n, nullptr));
 }
 
 Value::Ref
@@ -63,10 +189,11 @@ Object::merge(Value const& o)
   }
   Object const& obj = dynamic_cast<Object const&>(o);
   for (auto& e : obj) {
-    if (m_content.count(e.first) == 0) {
-      m_content.insert(e);
+    size_t pos = search(e.first);
+    if (pos == npos) {
+      assign(e.first, e.second);
     } else {
-      m_content[e.first]->merge(*e.second);
+      m_content[pos].second->merge(*e.second);
     }
   }
 }
@@ -74,7 +201,7 @@ Object::merge(Value const& o)
 bool
 Object::has(std::string const& k) const
 {
-  return m_content.find(k) != m_content.end();
+  return locate(k) != npos;
 }
 
 bool
@@ -86,13 +213,14 @@ Object::has(Path const& p, Path::const_iterator const& i) const
   size_t success = 0;
   switch ((*i)->type()) {
     case path::Item::Type::Named: {
-      if (m_content.count((*i)->value()) != 0) {
-        success += m_content.at((*i)->value())->has(p, p.down(i)) ? 1 : 0;
+      size_t pos = locate((*i)->symbol());
+      if (pos != npos) {
+        success += m_content[pos].second->has(p, p.down(i)) ? 1 : 0;
       }
     } break;
     case path::Item::Type::Any: {
-      if (not m_content.empty()) {
-        for (auto& e : m_content) {
+      if (size() != 0) {
+        for (auto& e : *this) {
           success += e.second->has(p, p.down(i)) ? 1 : 0;
         }
       } else {
@@ -103,7 +231,7 @@ Object::has(Path const& p, Path::const_iterator const& i) const
       return false;
   }
   if ((*i)->recursive()) {
-    for (auto& e : m_content) {
+    for (auto& e : *this) {
       success += e.second->has(p, i) ? 1 : 0;
     }
   }
@@ -113,22 +241,23 @@ Object::has(Path const& p, Path::const_iterator const& i) const
 size_t
 Object::size() const
 {
-  return m_content.size();
+  return m_content.size() - m_holes;
 }
 
 Value::Ref const&
 Object::at(std::string const& k) const
 {
-  if (not has(k)) {
+  size_t pos = locate(k);
+  if (pos == npos) {
     throw std::invalid_argument(k + ": no such key");
   }
-  return m_content.at(k);
+  return m_content[pos].second;
 }
 
 void
 Object::put(Value::Ref const& r)
 {
-  m_content[r->name()] = r;
+  assign(r->symbol(), r);
   r->m_parent = this;
 }
 
@@ -137,7 +266,7 @@ Object::put(std::string const& k, Value::Ref const& r)
 {
   r->setName(k);
   r->m_parent = this;
-  m_content[k] = r;
+  assign(r->symbol(), r);
 }
 
 bool
@@ -161,19 +290,31 @@ Object::operator[](std::string const& k) const
 Value&
 Object::get(std::string const& k)
 {
-  if (not has(k)) {
+  size_t pos = locate(k);
+  if (pos == npos) {
     throw std::invalid_argument(k + ": no such key");
   }
-  return *m_content.at(k);
+  return *m_content[pos].second;
 }
 
 Value const&
 Object::get(std::string const& k) const
 {
-  if (not has(k)) {
+  size_t pos = locate(k);
+  if (pos == npos) {
     throw std::invalid_argument(k + ": no such key");
   }
-  return *m_content.at(k);
+  return *m_content[pos].second;
+}
+
+const Value*
+Object::find(std::string const& k) const
+{
+  size_t pos = locate(k);
+  if (pos == npos) {
+    return nullptr;
+  }
+  return m_content[pos].second.get();
 }
 
 void
@@ -185,16 +326,17 @@ Object::get(Path const& p, Path::const_iterator const& i,
   }
   switch ((*i)->type()) {
     case path::Item::Type::Named: {
-      if (m_content.count((*i)->value()) != 0) {
+      size_t pos = locate((*i)->symbol());
+      if (pos != npos) {
         if (p.down(i) == p.end()) {
-          r.push_back(m_content.at((*i)->value()));
+          r.push_back(m_content[pos].second);
         } else {
-          m_content.at((*i)->value())->get(p, p.down(i), r);
+          m_content[pos].second->get(p, p.down(i), r);
         }
       }
     } break;
     case path::Item::Type::Any: {
-      for (auto& e : m_content) {
+      for (auto& e : *this) {
         if (p.down(i) == p.end()) {
           r.push_back(e.second);
         } else {
@@ -206,7 +348,7 @@ Object::get(Path const& p, Path::const_iterator const& i,
       break;
   }
   if ((*i)->recursive()) {
-    for (auto& e : m_content) {
+    for (auto& e : *this) {
       e.second->get(p, i, r);
     }
   }
@@ -221,16 +363,17 @@ Object::get(Path const& p, Path::const_iterator const& i,
   }
   switch ((*i)->type()) {
     case path::Item::Type::Named: {
-      if (m_content.count((*i)->value()) != 0) {
+      size_t pos = locate((*i)->symbol());
+      if (pos != npos) {
         if (p.down(i) == p.end()) {
-          r.push_back(m_content.at((*i)->value()));
+          r.push_back(m_content[pos].second);
         } else {
-          m_content.at((*i)->value())->get(p, p.down(i), r);
+          m_content[pos].second->get(p, p.down(i), r);
         }
       }
     } break;
     case path::Item::Type::Any: {
-      for (auto& e : m_content) {
+      for (auto& e : *this) {
         if (p.down(i) == p.end()) {
           r.push_back(e.second);
         } else {
@@ -242,7 +385,7 @@ Object::get(Path const& p, Path::const_iterator const& i,
       break;
   }
   if ((*i)->recursive()) {
-    for (auto& e : m_content) {
+    for (auto& e : *this) {
       e.second->get(p, i, r);
     }
   }
@@ -254,7 +397,7 @@ Object::erase(std::string const& k)
   if (not has(k)) {
     throw std::invalid_argument(k + ": no such key");
   }
-  m_content.erase(k);
+  remove(k);
 }
 
 void
@@ -265,19 +408,20 @@ Object::erase(Path const& p, Path::const_iterator const& i)
   }
   switch ((*i)->type()) {
     case path::Item::Type::Named: {
-      if (m_content.count((*i)->value()) != 0) {
+      size_t pos = locate((*i)->symbol());
+      if (pos != npos) {
         if (p.down(i) == p.end()) {
-          m_content.erase((*i)->value());
+          remove((*i)->value());
         } else {
-          m_content.at((*i)->value())->erase(p, p.down(i));
+          m_content[pos].second->erase(p, p.down(i));
         }
       }
     } break;
     case path::Item::Type::Any: {
       if (p.down(i) == p.end()) {
-        m_content.clear();
+        clear();
       } else {
-        for (auto& e : m_content) {
+        for (auto& e : *this) {
           e.second->erase(p, p.down(i));
         }
       }
@@ -286,7 +430,7 @@ Object::erase(Path const& p, Path::const_iterator const& i)
       break;
   }
   if ((*i)->recursive()) {
-    for (auto& e : m_content) {
+    for (auto& e : *this) {
       e.second->erase(p, i);
     }
   }
@@ -295,13 +439,15 @@ Object::erase(Path const& p, Path::const_iterator const& i)
 tree::Object::const_iterator
 Object::begin() const
 {
-  return m_content.begin();
+  normalize();
+  return const_iterator(m_content.begin(), m_content.end());
 }
 
 tree::Object::const_iterator
 Object::end() const
 {
-  return m_content.end();
+  normalize();
+  return const_iterator(m_content.end(), m_content.end());
 }
 
 Path
@@ -329,19 +475,19 @@ Object::put(Path const& p, Path::const_iterator const& i, Value::Ref const& r)
   }
   std::string const& id = (*i)->value();
   if (p.down(i) != p.end()) {
-    if (m_content.find(id) == m_content.end()) {
+    if (not has(id)) {
       tree::Object::Ref tmp = Object::build(id);
       put(tmp);
     }
-    Value::Ref vr = m_content[id];
+    Value::Ref vr = at(id);
     return vr->put(p, p.down(i), r);
   } else {
     if (r == nullptr) {
-      m_content.erase(id);
-    } else if (m_content.find(id) == m_content.end()) {
+      remove(id);
+    } else if (not has(id)) {
       put(id, r);
     } else {
-      Value::Ref vr = m_content[id];
+      Value::Ref vr = at(id);
       if (vr->type() == Value::Type::Array) {
         Array::Ref aref = std::static_pointer_cast<Array>(vr);
         aref->push_back(r);
@@ -356,4 +502,215 @@ Object::put(Path const& p, Path::const_iterator const& i, Value::Ref const& r)
   }
 }
 
+/*
+ * Lookups do not need the children to be sorted. The lock only keeps them from
+ * racing with a concurrent reader that is merging the unsorted children.
+ */
+
+size_t
+Object::locate(std::string const& k) const
+{
+  if (m_ordered.load(std::memory_order_acquire)) {
+    return search(k);
+  }
+  pthread_mutex_t& lock = lockFor(this);
+  pthread_mutex_lock(&lock);
+  size_t pos = search(k);
+  pthread_mutex_unlock(&lock);
+  return pos;
+}
+
+size_t
+Object::locate(common::Symbol const& k) const
+{
+  if (m_ordered.load(std::memory_order_acquire)) {
+    return search(k);
+  }
+  pthread_mutex_t& lock = lockFor(this);
+  pthread_mutex_lock(&lock);
+  size_t pos = search(k);
+  pthread_mutex_unlock(&lock);
+  return pos;
+}
+
+/*
+ * Holes are not indexed, and are skipped when the children are scanned.
+ */
+
+size_t
+Object::search(std::string const& k) const
+{
+  size_t h = hashOf(k);
+  if (m_slots.empty()) {
+    for (size_t pos = 0; pos < m_content.size(); pos += 1) {
+      auto const& e = m_content[pos];
+      if (e.second != nullptr and e.first.hash() == h and e.first == k) {
+        return pos;
+      }
+    }
+    return npos;
+  }
+  size_t mask = m_slots.size() - 1;
+  for (size_t i = h & mask; m_slots[i] != 0; i = (i + 1) & mask) {
+    size_t pos = m_slots[i] - 1;
+    if (m_content[pos].first.hash() == h and m_content[pos].first == k) {
+      return pos;
+    }
+  }
+  return npos;
+}
+
+size_t
+Object::search(common::Symbol const& k) const
+{
+  if (m_slots.empty()) {
+    for (size_t pos = 0; pos < m_content.size(); pos += 1) {
+      auto const& e = m_content[pos];
+      if (e.second != nullptr and e.first == k) {
+        return pos;
+      }
+    }
+    return npos;
+  }
+  size_t mask = m_slots.size() - 1;
+  for (size_t i = k.hash() & mask; m_slots[i] != 0; i = (i + 1) & mask) {
+    size_t pos = m_slots[i] - 1;
+    if (m_content[pos].first == k) {
+      return pos;
+    }
+  }
+  return npos;
+}
+
+/*
+ * The children are appended. The sorted prefix grows as long as they come in
+ * order. The index is updated in place as long as its load factor stays under
+ * one half, and rebuilt with twice the room otherwise.
+ */
+
+void
+Object::assign(common::Symbol const& k, Value::Ref const& r)
+{
+  size_t pos = search(k);
+  if (pos != npos) {
+    m_content[pos].second = r;
+    return;
+  }
+  bool ordered = m_sorted == m_content.size() and
+                 (m_content.empty() or m_content.back().first < k);
+  pos = m_content.size();
+  m_content.emplace_back(k, r);
+  if (ordered) {
+    m_sorted = m_content.size();
+  } else {
+    m_ordered.store(false, std::memory_order_relaxed);
+  }
+  if (m_content.size() <= IndexThreshold) {
+    return;
+  }
+  if (m_slots.size() >= 2 * m_content.size()) {
+    insertSlot(m_slots, k.hash(), pos);
+  } else {
+    reindex();
+  }
+}
+
+void
+Object::remove(std::string const& k)
+{
+  size_t pos = search(k);
+  if (pos == npos) {
+    return;
+  }
+  if (not m_slots.empty()) {
+    eraseSlot(m_slots, m_content, m_content[pos].first.hash(), pos);
+  }
+  m_content[pos].second = nullptr;
+  m_holes += 1;
+  if (2 * m_holes > m_content.size()) {
+    compact();
+  }
+}
+
+void
+Object::clear()
+{
+  m_content.clear();
+  m_slots.clear();
+  m_sorted = 0;
+  m_ordered.store(true, std::memory_order_relaxed);
+  m_holes = 0;
+}
+
+/*
+ * Merge the children appended out of order into the sorted ones. This happens
+ * on the first access that follows the insertions, possibly from concurrent
+ * readers.
+ */
+
+void
+Object::normalize() const
+{
+  if (m_ordered.load(std::memory_order_acquire)) {
+    return;
+  }
+  pthread_mutex_t& lock = lockFor(this);
+  pthread_mutex_lock(&lock);
+  if (not m_ordered.load(std::memory_order_relaxed)) {
+    auto mid = m_content.begin() + static_cast<ptrdiff_t>(m_sorted);
+    std::sort(mid, m_content.end(), byKey);
+    std::inplace_merge(m_content.begin(), mid, m_content.end(), byKey);
+    m_sorted = m_content.size();
+    reindex();
+    m_ordered.store(true, std::memory_order_release);
+  }
+  pthread_mutex_unlock(&lock);
+}
+
+/*
+ * Remove the holes, keeping the order of the children.
+ */
+
+void
+Object::compact()
+{
+  size_t sorted = 0;
+  size_t next = 0;
+  for (size_t pos = 0; pos < m_content.size(); pos += 1) {
+    if (m_content[pos].second == nullptr) {
+      continue;
+    }
+    if (pos < m_sorted) {
+      sorted += 1;
+    }
+    if (pos != next) {
+      m_content[next] = std::move(m_content[pos]);
+    }
+    next += 1;
+  }
+  m_content.resize(next);
+  m_sorted = sorted;
+  m_holes = 0;
+  reindex();
+}
+
+void
+Object::reindex() const
+{
+  m_slots.clear();
+  if (m_content.size() <= IndexThreshold) {
+    return;
+  }
+  size_t cap = 1;
+  while (cap < 4 * m_content.size()) {
+    cap <<= 1;
+  }
+  m_slots.assign(cap, 0);
+  for (size_t pos = 0; pos < m_content.size(); pos += 1) {
+    if (m_content[pos].second != nullptr) {
+      insertSlot(m_slots, m_content[pos].first.hash(), pos);
+    }
+  }
+}
+
 }}
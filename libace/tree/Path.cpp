@@ -24,15 +24,94 @@
 #include <ace/tree/Path.h>
 #include <ace/tree/Lexer.h>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <list>
+#include <pthread.h>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 namespace {
 
 using namespace ace::tree;
 using namespace ace::tree::path;
 
+/*
+ * Parsed path cache. The cache is split in shards selected by the hash of the
+ * source string, each holding a least-recently-used list of parsed paths.
+ */
+
+static const size_t CACHE_SHARDS = 8;
+static const size_t CACHE_CAPACITY = 4096;
+
+struct Shard
+{
+  using Entry = std::pair<std::string, Path>;
+  using List = std::list<Entry>;
+
+  Shard() : lock(), entries(), index() { pthread_mutex_init(&lock, nullptr); }
+
+  pthread_mutex_t lock;
+  List entries;
+  std::unordered_map<std::string_view, List::iterator> index;
+};
+
+struct Cache
+{
+  Cache() : shards(), capacity(CACHE_CAPACITY), hits(0), misses(0) {}
+
+  Shard& shardFor(std::string const& s)
+  {
+    return shards[std::hash<std::string>()(s) % CACHE_SHARDS];
+  }
+
+  Shard shards[CACHE_SHARDS];
+  std::atomic<size_t> capacity;
+  std::atomic<size_t> hits;
+  std::atomic<size_t> misses;
+};
+
+static Cache&
+cache()
+{
+  static Cache* s_cache = new Cache;
+  return *s_cache;
+}
+
+static bool
+lookup(Shard& sh, std::string const& s, Path& r)
+{
+  bool found = false;
+  pthread_mutex_lock(&sh.lock);
+  auto it = sh.index.find(s);
+  if (it != sh.index.end()) {
+    sh.entries.splice(sh.entries.begin(), sh.entries, it->second);
+    r = it->second->second;
+    found = true;
+  }
+  pthread_mutex_unlock(&sh.lock);
+  return found;
+}
+
+static void
+insert(Shard& sh, std::string const& s, Path const& p, const size_t cap)
+{
+  pthread_mutex_lock(&sh.lock);
+  if (sh.index.count(s) == 0) {
+    sh.entries.emplace_front(s, p);
+    sh.index[sh.entries.front().first] = sh.entries.begin();
+    while (sh.entries.size() > cap) {
+      sh.index.erase(sh.entries.back().first);
+      sh.entries.pop_back();
+    }
+  }
+  pthread_mutex_unlock(&sh.lock);
+}
+
 static bool
 match(Path const& a, Path const& b, Path::const_iterator const& i,
       Path::const_iterator const& j)
@@ -140,7 +219,56 @@ Path::build(Path const& p)
 Path
 Path::parse(std::string const& s)
 {
-  return path::Scan().parse(s);
+  Cache& c = cache();
+  size_t cap = c.capacity.load(std::memory_order_relaxed) / CACHE_SHARDS;
+  if (cap == 0) {
+    c.misses.fetch_add(1, std::memory_order_relaxed);
+    return path::Scan().parse(s);
+  }
+  Path result;
+  Shard& sh = c.shardFor(s);
+  if (lookup(sh, s, result)) {
+    c.hits.fetch_add(1, std::memory_order_relaxed);
+    return result;
+  }
+  c.misses.fetch_add(1, std::memory_order_relaxed);
+  result = path::Scan().parse(s);
+  insert(sh, s, result, cap);
+  return result;
+}
+
+Path::Statistics
+Path::cacheStatistics()
+{
+  Cache& c = cache();
+  Statistics result = { c.hits.load(), c.misses.load(), 0, c.capacity.load() };
+  for (auto& sh : c.shards) {
+    pthread_mutex_lock(&sh.lock);
+    result.size += sh.entries.size();
+    pthread_mutex_unlock(&sh.lock);
+  }
+  return result;
+}
+
+void
+Path::setCacheCapacity(const size_t cap)
+{
+  cache().capacity = cap;
+  clearCache();
+}
+
+void
+Path::clearCache()
+{
+  Cache& c = cache();
+  for (auto& sh : c.shards) {
+    pthread_mutex_lock(&sh.lock);
+    sh.index.clear();
+    sh.entries.clear();
+    pthread_mutex_unlock(&sh.lock);
+  }
+  c.hits = 0;
+  c.misses = 0;
 }
 
 Path&
@@ -21,84 +21,116 @@
  */
 
 #include <ace/tree/Primitive.h>
+#include <cstring>
 #include <string>
 
 namespace ace { namespace tree {
 
 template<>
-Primitive::Primitive(std::string const& n, bool const& v)
-  : Value(n, Type::Boolean), m_content(new TypedContent<bool>(v))
+Primitive::Primitive(Arena* a, std::string const& n, bool const& v)
+  : Value(n, Type::Boolean), m_bool(v)
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, char const& v)
-  : Value(n, Type::String)
-  , m_content(new TypedContent<std::string>(std::string(1, v)))
-{}
+Primitive::Primitive(Arena* a, std::string const& n, char const& v)
+  : Value(n, Type::String), m_text()
+{
+  assign(a, &v, 1);
+}
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned char const& v)
-  : Value(n, Type::String), m_content(new TypedContent<long>(v))
-{}
+Primitive::Primitive(Arena* a, std::string const& n, unsigned char const& v)
+  : Value(n, Type::String), m_text()
+{
+  std::string s = std::to_string(v);
+  assign(a, s.data(), s.length());
+}
 
 template<>
-Primitive::Primitive(std::string const& n, short const& v)
-  : Value(n, Type::Integer), m_content(new TypedContent<long>(v))
+Primitive::Primitive(Arena* a, std::string const& n, short const& v)
+  : Value(n, Type::Integer), m_long(static_cast<long>(v))
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned short const& v)
-  : Value(n, Type::Integer), m_content(new TypedContent<long>(v))
+Primitive::Primitive(Arena* a, std::string const& n, unsigned short const& v)
+  : Value(n, Type::Integer), m_long(static_cast<long>(v))
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, int const& v)
-  : Value(n, Type::Integer), m_content(new TypedContent<long>(v))
+Primitive::Primitive(Arena* a, std::string const& n, int const& v)
+  : Value(n, Type::Integer), m_long(static_cast<long>(v))
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned int const& v)
-  : Value(n, Type::Integer), m_content(new TypedContent<long>(v))
+Primitive::Primitive(Arena* a, std::string const& n, unsigned int const& v)
+  : Value(n, Type::Integer), m_long(static_cast<long>(v))
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, long const& v)
-  : Value(n, Type::Integer), m_content(new TypedContent<long>(v))
+Primitive::Primitive(Arena* a, std::string const& n, long const& v)
+  : Value(n, Type::Integer), m_long(v)
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, unsigned long const& v)
-  : Value(n, Type::Integer), m_content(new TypedContent<long>(v))
+Primitive::Primitive(Arena* a, std::string const& n, unsigned long const& v)
+  : Value(n, Type::Integer), m_long(static_cast<long>(v))
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, float const& v)
-  : Value(n, Type::Float), m_content(new TypedContent<double>(v))
+Primitive::Primitive(Arena* a, std::string const& n, float const& v)
+  : Value(n, Type::Float), m_double(v)
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, double const& v)
-  : Value(n, Type::Float), m_content(new TypedContent<double>(v))
+Primitive::Primitive(Arena* a, std::string const& n, double const& v)
+  : Value(n, Type::Float), m_double(v)
 {}
 
 template<>
-Primitive::Primitive(std::string const& n, char* const& v)
-  : Value(n, Type::String), m_content(new TypedContent<std::string>(v))
-{}
+Primitive::Primitive(Arena* a, std::string const& n, char* const& v)
+  : Value(n, Type::String), m_text()
+{
+  assign(a, v, strlen(v));
+}
 
 template<>
-Primitive::Primitive(std::string const& n, const char* const& v)
-  : Value(n, Type::String), m_content(new TypedContent<std::string>(v))
-{}
+Primitive::Primitive(Arena* a, std::string const& n, const char* const& v)
+  : Value(n, Type::String), m_text()
+{
+  assign(a, v, strlen(v));
+}
 
 template<>
-Primitive::Primitive(std::string const& n, std::string const& v)
-  : Value(n, Type::String), m_content(new TypedContent<std::string>(v))
-{}
+Primitive::Primitive(Arena* a, std::string const& n, std::string const& v)
+  : Value(n, Type::String), m_text()
+{
+  assign(a, v.data(), v.length());
+}
 
-Primitive::Primitive(Primitive const& p)
-  : Value(p), m_content(p.m_content->clone())
-{}
+Primitive::Primitive(Primitive const& p) : Value(p), m_text()
+{
+  switch (m_type) {
+    case Type::Boolean:
+      m_bool = p.m_bool;
+      break;
+    case Type::Integer:
+      m_long = p.m_long;
+      break;
+    case Type::Float:
+      m_double = p.m_double;
+      break;
+    case Type::String:
+      assign(nullptr, p.m_text.data, p.m_text.size);
+      break;
+    default:
+      break;
+  }
+}
+
+Primitive::~Primitive()
+{
+  release();
+}
 
 Value::Ref
 Primitive::clone() const
@@ -179,13 +211,52 @@ Primitive::is<std::string>() const
 void
 Primitive::stringify()
 {
+  if (m_type == Value::Type::String) {
+    return;
+  }
+  std::string s = value();
   m_type = Value::Type::String;
+  assign(nullptr, s.data(), s.length());
 }
 
 std::string
 Primitive::value() const
 {
-  return m_content->toString();
+  switch (m_type) {
+    case Type::Boolean:
+      return common::String::from<bool>(m_bool);
+    case Type::Integer:
+      return common::String::from<long>(m_long);
+    case Type::Float:
+      return common::String::from<double>(m_double);
+    default:
+      return std::string(m_text.data, m_text.size);
+  }
+}
+
+/**
+ * Strings are NUL-terminated. The storage of a primitive built in an arena is
+ * released with the arena, any other storage is released with the primitive.
+ */
+
+void
+Primitive::assign(Arena* a, const char* s, const size_t len)
+{
+  char* data = a != nullptr ? static_cast<char*>(a->allocate(len + 1, 1))
+                            : new char[len + 1];
+  memcpy(data, s, len);
+  data[len] = '\0';
+  m_text.data = data;
+  m_text.size = len;
+  m_text.heap = a == nullptr;
+}
+
+void
+Primitive::release()
+{
+  if (m_type == Value::Type::String and m_text.heap) {
+    delete[] m_text.data;
+  }
 }
 
 template<>
@@ -193,9 +264,9 @@ double
 Primitive::value() const
 {
   if (m_type == Value::Type::Float) {
-    return static_cast<TypedContent<double> const&>(*m_content).value();
+    return m_double;
   } else if (m_type == Value::Type::Integer) {
-    return static_cast<TypedContent<long> const&>(*m_content).value();
+    return static_cast<double>(m_long);
   } else {
     return 0.0;
   }
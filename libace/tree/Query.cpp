@@ -0,0 +1,279 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/tree/Query.h>
+#include <ace/tree/Array.h>
+#include <ace/tree/Object.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace ace::tree;
+
+/*
+ * Wide items may match any child of a value and prevent targeted lookups.
+ */
+static bool
+isWide(path::Item const& i)
+{
+  return i.recursive() or i.type() == path::Item::Type::Any;
+}
+
+static bool
+inRange(path::Item::Range const& r, const size_t size, const size_t idx)
+{
+  if (r.low >= size or r.high > size or r.steps == 0) {
+    return false;
+  }
+  return idx >= r.low and idx < r.high and (idx - r.low) % r.steps == 0;
+}
+
+static void
+insert(std::vector<size_t>& s, const size_t id)
+{
+  if (std::find(s.begin(), s.end(), id) == s.end()) {
+    s.push_back(id);
+  }
+}
+
+}
+
+namespace ace { namespace tree {
+
+Query::Query(Path const& p) : Query()
+{
+  add(p);
+}
+
+Query::Query(std::vector<Path> const& p) : Query()
+{
+  for (auto const& e : p) {
+    add(e);
+  }
+}
+
+size_t
+Query::add(Path const& p)
+{
+  size_t index = m_starts.size();
+  size_t start = npos;
+  if (p.begin() != p.end()) {
+    for (auto it = p.down(p.begin()); it != p.end(); it = p.down(it)) {
+      size_t id = m_states.size();
+      if (start == npos) {
+        start = id;
+      } else {
+        m_states.back().next = id;
+      }
+      m_states.push_back({ *it, index, npos });
+    }
+  }
+  m_starts.push_back(start);
+  m_globals.push_back(p.global());
+  return index;
+}
+
+size_t
+Query::size() const
+{
+  return m_starts.size();
+}
+
+void
+Query::run(Value& v, Callback const& cb) const
+{
+  run(static_cast<Value const&>(v), [&](const size_t k, Value const& w) {
+    cb(k, const_cast<Value&>(w));
+  });
+}
+
+void
+Query::run(Value const& v, ConstCallback const& cb) const
+{
+  const Value* root = &v;
+  while (root->parent() != nullptr) {
+    root = root->parent();
+  }
+  States global, local;
+  for (size_t k = 0; k < m_starts.size(); k += 1) {
+    if (m_starts[k] == npos) {
+      continue;
+    }
+    if (m_globals[k] or root == &v) {
+      global.push_back(m_starts[k]);
+    } else {
+      local.push_back(m_starts[k]);
+    }
+  }
+  if (not global.empty()) {
+    visit(*root, global, cb);
+  }
+  if (not local.empty()) {
+    visit(v, local, cb);
+  }
+}
+
+void
+Query::step(Value const& p, Value const& v, common::Symbol const& k,
+            const size_t idx, States const& s, States& r,
+            ConstCallback const& cb) const
+{
+  bool object = p.type() == Value::Type::Object;
+  for (auto id : s) {
+    State const& st = m_states[id];
+    path::Item const& item = *st.item;
+    bool match = false;
+    switch (item.type()) {
+      case path::Item::Type::Any: {
+        match = true;
+      } break;
+      case path::Item::Type::Named: {
+        match = object and k == item.symbol();
+      } break;
+      case path::Item::Type::Indexed: {
+        auto const& indexes = item.indexes();
+        match = not object and std::find(indexes.begin(), indexes.end(),
+                                         idx) != indexes.end();
+      } break;
+      case path::Item::Type::Ranged: {
+        auto const& array = static_cast<Array const&>(p);
+        match = not object and inRange(item.range(), array.size(), idx);
+      } break;
+      default:
+        break;
+    }
+    if (match) {
+      if (st.next == npos) {
+        cb(st.path, v);
+      } else {
+        insert(r, st.next);
+      }
+    }
+    if (item.recursive()) {
+      insert(r, id);
+    }
+  }
+}
+
+void
+Query::visit(Value const& v, States const& s, ConstCallback const& cb) const
+{
+  if (v.type() != Value::Type::Object and v.type() != Value::Type::Array) {
+    return;
+  }
+  bool wide = std::any_of(s.begin(), s.end(), [&](const size_t id) {
+    return isWide(*m_states[id].item);
+  });
+  /*
+   * Wide states match the children one by one.
+   */
+  if (wide) {
+    common::Symbol none;
+    States next;
+    if (v.type() == Value::Type::Object) {
+      for (auto const& e : static_cast<Object const&>(v)) {
+        next.clear();
+        step(v, *e.second, e.first, 0, s, next, cb);
+        if (not next.empty()) {
+          visit(*e.second, next, cb);
+        }
+      }
+    } else {
+      auto const& array = static_cast<Array const&>(v);
+      for (size_t i = 0; i < array.size(); i += 1) {
+        next.clear();
+        step(v, *array.at(i), none, i, s, next, cb);
+        if (not next.empty()) {
+          visit(*array.at(i), next, cb);
+        }
+      }
+    }
+    return;
+  }
+  /*
+   * Other states only look up the children they name, which are then visited
+   * in document order with the states that target them.
+   */
+  std::vector<std::pair<size_t, size_t>> targets;
+  if (v.type() == Value::Type::Object) {
+    auto const& object = static_cast<Object const&>(v);
+    object.normalize();
+    for (auto id : s) {
+      path::Item const& item = *m_states[id].item;
+      if (item.type() == path::Item::Type::Named) {
+        size_t pos = object.locate(item.symbol());
+        if (pos != Object::npos) {
+          targets.emplace_back(pos, id);
+        }
+      }
+    }
+  } else {
+    auto const& array = static_cast<Array const&>(v);
+    for (auto id : s) {
+      path::Item const& item = *m_states[id].item;
+      if (item.type() == path::Item::Type::Indexed) {
+        for (auto idx : item.indexes()) {
+          if (idx < array.size()) {
+            targets.emplace_back(idx, id);
+          }
+        }
+      } else if (item.type() == path::Item::Type::Ranged) {
+        auto const& r = item.range();
+        for (size_t idx = r.low; inRange(r, array.size(), idx);
+             idx += r.steps) {
+          targets.emplace_back(idx, id);
+        }
+      }
+    }
+  }
+  std::sort(targets.begin(), targets.end());
+  targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+  common::Symbol none;
+  States group, next;
+  for (size_t i = 0; i < targets.size(); i += 1) {
+    group.push_back(targets[i].second);
+    if (i + 1 < targets.size() and targets[i + 1].first == targets[i].first) {
+      continue;
+    }
+    size_t pos = targets[i].first;
+    next.clear();
+    if (v.type() == Value::Type::Object) {
+      auto const& e = static_cast<Object const&>(v).m_content[pos];
+      step(v, *e.second, e.first, pos, group, next, cb);
+      if (not next.empty()) {
+        visit(*e.second, next, cb);
+      }
+    } else {
+      auto const& e = static_cast<Array const&>(v).at(pos);
+      step(v, *e, none, pos, group, next, cb);
+      if (not next.empty()) {
+        visit(*e, next, cb);
+      }
+    }
+    group.clear();
+  }
+}
+
+}}
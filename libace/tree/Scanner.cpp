@@ -21,10 +21,18 @@
  */
 
 #include <ace/tree/Scanner.h>
+#include <ace/tree/Builder.h>
 #include <string>
 
 namespace ace { namespace tree {
 
+bool
+Scanner::scan(std::string const& fn, int argc, char** argv, Handler& h)
+{
+  Value::Ref v = open(fn, argc, argv);
+  return v != nullptr and Builder::emit(*v, h);
+}
+
 void
 Scanner::shift(std::string const& fn, int& argc, char**& argv)
 {
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/tree/Trigger.h>
+#include <string>
+#include <vector>
+
+namespace ace { namespace tree {
+
+constexpr size_t Trigger::npos;
+
+Trigger::Trigger() : m_nodes(1, Node{ {}, npos, {}, {} }), m_paths() {}
+
+size_t
+Trigger::add(Path const& p)
+{
+  size_t idx = m_paths.size();
+  m_paths.push_back(p);
+  if (p.begin() == p.end()) {
+    return idx;
+  }
+  size_t n = 0;
+  for (auto i = p.down(p.begin()); i != p.end(); i = p.down(i)) {
+    size_t next = npos;
+    if ((*i)->type() == path::Item::Type::Any) {
+      if (m_nodes[n].any == npos) {
+        m_nodes[n].any = m_nodes.size();
+        m_nodes.push_back(Node{ {}, npos, {}, {} });
+      }
+      next = m_nodes[n].any;
+    } else if ((*i)->type() == path::Item::Type::Named and
+               not(*i)->recursive()) {
+      auto it = m_nodes[n].named.find((*i)->value());
+      if (it == m_nodes[n].named.end()) {
+        next = m_nodes.size();
+        m_nodes[n].named[(*i)->value()] = next;
+        m_nodes.push_back(Node{ {}, npos, {}, {} });
+      } else {
+        next = it->second;
+      }
+    } else {
+      /*
+       * Other items are matched by Path::match() from this node.
+       */
+      m_nodes[n].partial.push_back(idx);
+      return idx;
+    }
+    n = next;
+  }
+  m_nodes[n].complete.push_back(idx);
+  return idx;
+}
+
+size_t
+Trigger::size() const
+{
+  return m_paths.size();
+}
+
+void
+Trigger::clear()
+{
+  m_nodes.assign(1, Node{ {}, npos, {}, {} });
+  m_paths.clear();
+}
+
+size_t
+Trigger::find(Path const& p) const
+{
+  if (p.begin() == p.end() or p.generative()) {
+    return npos;
+  }
+  size_t r = npos;
+  find(p, p.down(p.begin()), 0, r);
+  return r;
+}
+
+Path const&
+Trigger::at(const size_t i) const
+{
+  return m_paths.at(i);
+}
+
+void
+Trigger::find(Path const& p, Path::const_iterator const& i, const size_t n,
+              size_t& r) const
+{
+  Node const& node = m_nodes[n];
+  /*
+   * Triggers ending here match any path that reaches this node. The lists are
+   * sorted, so only their first element can improve the result.
+   */
+  if (not node.complete.empty() and node.complete.front() < r) {
+    r = node.complete.front();
+  }
+  for (auto idx : node.partial) {
+    if (idx >= r) {
+      break;
+    }
+    if (m_paths[idx].match(p)) {
+      r = idx;
+      break;
+    }
+  }
+  if (i == p.end()) {
+    return;
+  }
+  if ((*i)->type() == path::Item::Type::Named) {
+    auto it = node.named.find((*i)->value());
+    if (it != node.named.end()) {
+      find(p, p.down(i), it->second, r);
+    }
+  }
+  if (node.any != npos) {
+    find(p, p.down(i), node.any, r);
+  }
+}
+
+}}
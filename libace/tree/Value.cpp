@@ -221,6 +221,12 @@ Value::setName(std::string const& n)
 
 std::string const&
 Value::name() const
+{
+  return m_name.str();
+}
+
+common::Symbol const&
+Value::symbol() const
 {
   return m_name;
 }
@@ -269,12 +275,13 @@ Value::path() const
   if (m_parent != nullptr) {
     apath = m_parent->path();
   }
-  if (std::all_of(m_name.begin(), m_name.end(), ::isdigit)) {
-    size_t index = common::String::value<size_t>(m_name);
+  std::string const& n = m_name.str();
+  if (std::all_of(n.begin(), n.end(), ::isdigit)) {
+    size_t index = common::String::value<size_t>(n);
     apath.push(path::Item::build(path::Item::Type::Indexed,
                                  std::vector<size_t>{ index }));
   } else {
-    apath.push(path::Item::build(path::Item::Type::Named, m_name));
+    apath.push(path::Item::build(path::Item::Type::Named, n));
   }
   return apath;
 }
@@ -130,6 +130,14 @@ Class::resolveInstance(tree::Object const& r, tree::Value const& v) const
   return score == 0;
 }
 
+void
+Class::collectProbes(tree::Value const& v, Probes& p) const
+{
+  v.each([&](tree::Value const& w) {
+    modelAttribute().model().body().collectProbes(w, p);
+  });
+}
+
 bool
 Class::validateModel()
 {
@@ -161,19 +169,20 @@ Class::injectInherited(tree::Object const& r, Object const& o,
 }
 
 void
-Class::display(Coach::Branch const& br) const
+Class::display(std::ostream& o, Coach::Branch const& br) const
 {
-  Type::display(br);
-  modelAttribute().model().display(br);
+  Type::display(o, br);
+  modelAttribute().model().display(o, br);
 }
 
 bool
-Class::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
+Class::explain(std::ostream& o, tree::Path const& p,
+               tree::Path::const_iterator const& i) const
 {
   if (i == p.end()) {
-    return Type<void, FormatChecker<void>>::explain(p, i);
+    return Type<void, FormatChecker<void>>::explain(o, p, i);
   }
-  return modelAttribute().model().explain(p, i);
+  return modelAttribute().model().explain(o, p, i);
 }
 
 void
@@ -206,7 +215,7 @@ Class::doBuildDefinition(std::string const& s, std::string const& v,
   if (optional() and not multiple()) {
     o << s << " = ";
   }
-  o << "ace::tree::utils::parseObject<" << tn << ">(r, " + e + ", " + v << ");";
+  o << "ace::tree::utils::parseObject<" << tn << ">(" + e + ", " + v << ");";
   o << std::endl;
 }
 
@@ -140,7 +140,7 @@ Enum::doBuildDefinition(std::string const& s, std::string const& v,
     o << s << " = ";
   }
   o << "ace::tree::utils::parsePrimitive<std::string>";
-  o << "(r, " << e << ", " << declName() << ");" << std::endl;
+  o << "(" << e << ", " << declName() << ");" << std::endl;
   indent(o, l);
   o << v << " = " << typeName() << "Parse(" << declName() << ");";
   o << std::endl;
@@ -22,10 +22,9 @@
 
 #include <ace/types/File.h>
 #include <ace/common/String.h>
-#include <ace/filesystem/Directory.h>
-#include <ace/filesystem/File.h> // NOLINT
+#include <ace/engine/Context.h>
 #include <ace/filesystem/Node.h>
-#include <ace/filesystem/Utils.h>
+#include <ace/filesystem/Probe.h>
 #include <ace/tree/Checker.h>
 #include <functional>
 #include <iostream>
@@ -47,7 +46,7 @@ FileTypeCompare::operator()(std::string const& a, std::string const& b) const
     return true;
   }
   fs::Path path(a);
-  fs::Node::Type t = fs::Node::type(a);
+  fs::Node::Type t = CONTEXT.probe().result(a).type;
   if (t != fs::Node::Type::Unknown) {
     return fs::Node::toString(t) == b;
   } else if (path.isDirectory()) {
@@ -82,27 +81,25 @@ FileFormatChecker::checkFormat(std::string const& n, std::string const& b) const
 {
   File const& file = *dynamic_cast<const File*>(m_owner);
   int flags = file.fileModeAttribute().flags();
-  auto path = fs::Path(b);
-  switch (fs::Node::type(path)) {
+  fs::Probe::Result res = CONTEXT.probe().result(b);
+  switch (res.type) {
     case fs::Node::Type::Unknown: {
       if ((flags & O_CREAT) == 0) {
         ERROR_O(m_owner, "file \"", n, "\": ", ERR_FILE_NO_SUCH_FILE(b));
         return false;
       }
-      if (not fs::Utils::canSelfCreate(b)) {
+      if (not res.creatable) {
         ERROR_O(m_owner, "file \"", n, "\": ", ERR_FILE_CANNOT_BE_CREATED(b));
         return false;
       }
     } break;
     default: {
       std::string mode = file.fileModeAttribute().value();
-      if ((flags & O_RDONLY or flags & O_RDWR) and
-          not fs::Node::readable(path)) {
+      if ((flags & O_RDONLY or flags & O_RDWR) and not res.readable) {
         ERROR_O(m_owner, "file \"", n,
                 "\": ", ERR_FILE_CANNOT_OPEN_MODE(b, mode));
       }
-      if ((flags & O_WRONLY or flags & O_RDWR) and
-          not fs::Node::writeable(path)) {
+      if ((flags & O_WRONLY or flags & O_RDWR) and not res.writeable) {
         ERROR_O(m_owner, "file \"", n,
                 "\": ", ERR_FILE_CANNOT_OPEN_MODE(b, mode));
       }
@@ -137,6 +134,20 @@ File::validateModel()
   return score == 0;
 }
 
+void
+File::collectProbes(tree::Value const& v, Probes& p) const
+{
+  v.each([&](tree::Value const& w) {
+    if (w.type() != tree::Value::Type::String) {
+      return;
+    }
+    std::string s = static_cast<tree::Primitive const&>(w).value();
+    if (s != "auto") {
+      p.paths.insert(s);
+    }
+  });
+}
+
 void
 File::collectInterfaceIncludes(std::set<std::string>& i) const
 {
@@ -21,23 +21,40 @@
  */
 
 #include <ace/types/IPv4.h>
+#include <ace/common/Resolver.h>
 #include <ace/common/String.h>
-#include <ace/filesystem/Directory.h>
-#include <ace/filesystem/File.h>
-#include <ace/filesystem/Utils.h>
 #include <ace/tree/Checker.h>
-#include <cstdlib>
-#include <cstring>
+#include <cctype>
 #include <iostream>
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
-#include <netdb.h>
 
-#ifdef __OpenBSD__
-#include <sys/socket.h>
-#endif
+namespace {
+
+bool
+digit(const char c)
+{
+  return c >= '0' and c <= '9';
+}
+
+/*
+ * Parse a decimal number of at most 3 digits and at most m.
+ */
+bool
+number(std::string const& s, size_t& i, const unsigned m)
+{
+  unsigned v = 0;
+  size_t b = i;
+  while (i < s.length() and digit(s[i]) and i - b < 3) {
+    v = v * 10 + (s[i] - '0');
+    i += 1;
+  }
+  return i > b and v <= m and (i == s.length() or not digit(s[i]));
+}
+
+}
 
 namespace ace { namespace model {
 
@@ -54,7 +71,7 @@ IPv4FormatChecker::operator()(tree::Object const& r, tree::Value const& v) const
   int score = 0;
   v.each([&](tree::Value const& w) {
     tree::Primitive const& p = static_cast<tree::Primitive const&>(w);
-    if (p.value() != "auto" and not checkFormat(p.value())) {
+    if (p.value() != "auto" and not checkFormat(p.value(), true)) {
       ERROR_O(m_owner, ERR_IPv4_BAD_ADDRESS(p.value()));
       score += 1;
     }
@@ -63,14 +80,78 @@ IPv4FormatChecker::operator()(tree::Object const& r, tree::Value const& v) const
 }
 
 bool
-IPv4FormatChecker::checkFormat(std::string const& s)
+IPv4FormatChecker::checkFormat(std::string const& s, const bool p)
+{
+  if (isAddress(s, p)) {
+    return true;
+  }
+  if (not isHostName(s)) {
+    return false;
+  }
+  return not common::Resolver::get().enabled() or
+         common::Resolver::get().resolved(s);
+}
+
+bool
+IPv4FormatChecker::isAddress(std::string const& s, const bool p)
+{
+  size_t i = 0;
+  for (int n = 0; n < 4; n += 1) {
+    if (n > 0) {
+      if (i == s.length() or s[i] != '.') {
+        return false;
+      }
+      i += 1;
+    }
+    if (not number(s, i, 255)) {
+      return false;
+    }
+  }
+  if (p and i < s.length() and s[i] == '/') {
+    i += 1;
+    if (not number(s, i, 32)) {
+      return false;
+    }
+  }
+  return i == s.length();
+}
+
+/*
+ * Host names follow RFC 1123. The last label cannot be numeric, to tell them
+ * apart from malformed addresses.
+ */
+bool
+IPv4FormatChecker::isHostName(std::string const& s)
 {
-  struct addrinfo hints, *result = nullptr;
-  memset(&hints, 0, sizeof(hints));
-  hints.ai_family = AF_INET;
-  int r = getaddrinfo(s.c_str(), nullptr, &hints, &result);
-  freeaddrinfo(result);
-  return r == 0;
+  if (s.empty() or s.length() > 253) {
+    return false;
+  }
+  size_t len = 0;
+  bool numeric = true;
+  for (size_t i = 0; i <= s.length(); i += 1) {
+    if (i == s.length() or s[i] == '.') {
+      if (len == 0 or len > 63 or s[i - 1] == '-') {
+        return false;
+      }
+      if (i == s.length()) {
+        break;
+      }
+      len = 0;
+      numeric = true;
+      continue;
+    }
+    char c = s[i];
+    if (c == '-') {
+      if (len == 0) {
+        return false;
+      }
+    } else if (not digit(c) and not isalpha(static_cast<unsigned char>(c))) {
+      return false;
+    }
+    numeric = numeric and digit(c);
+    len += 1;
+  }
+  return not numeric;
 }
 
 // IPv4 class
@@ -79,6 +160,21 @@ IPv4::IPv4()
   : Type(BasicType::Kind::IPv4), EnumeratedType(BasicType::Kind::IPv4)
 {}
 
+void
+IPv4::collectProbes(tree::Value const& v, Probes& p) const
+{
+  v.each([&](tree::Value const& w) {
+    if (w.type() != tree::Value::Type::String) {
+      return;
+    }
+    std::string s = static_cast<tree::Primitive const&>(w).value();
+    if (s != "auto" and not IPv4FormatChecker::isAddress(s, true) and
+        IPv4FormatChecker::isHostName(s)) {
+      p.hosts.insert(s);
+    }
+  });
+}
+
 void
 IPv4::collectInterfaceIncludes(std::set<std::string>& i) const
 {
@@ -30,17 +30,65 @@
 #include <list>
 #include <map>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+namespace {
+
+/*
+ * Collect the triggers of a plugin child from its header without loading it.
+ * Malformed triggers are skipped here and reported when the child is loaded.
+ */
+void
+collectTriggers(ace::tree::Value const& t, std::list<ace::tree::Path>& r)
+{
+  using ace::tree::Value;
+  if (t.type() != Value::Type::Object or not t.has("header")) {
+    return;
+  }
+  Value const& hdr = t["header"];
+  if (hdr.type() != Value::Type::Object or not hdr.has("trigger") or
+      hdr["trigger"].type() != Value::Type::Array) {
+    return;
+  }
+  for (auto& ex : static_cast<ace::tree::Array const&>(hdr["trigger"])) {
+    if (ex->type() != Value::Type::String) {
+      continue;
+    }
+    try {
+      auto const& pri = static_cast<ace::tree::Primitive const&>(*ex);
+      auto path = ace::tree::Path::parse(pri.value<std::string>());
+      if (path.global()) {
+        r.push_back(path);
+      }
+    } catch (std::invalid_argument const& e) {
+    }
+  }
+}
+
+}
+
 namespace ace { namespace model {
 
+Plugin::Children::Children() : models(), loaded(), lock()
+{
+  pthread_mutex_init(&lock, nullptr);
+}
+
+Plugin::Children::~Children()
+{
+  pthread_mutex_destroy(&lock);
+}
+
 Plugin::Plugin()
   : Type(BasicType::Kind::Plugin, "?1")
   , m_model()
   , m_targetArity(Arity::Kind::One, 1, 1)
   , m_plugins()
   , m_instances()
+  , m_children(new Children())
+  , m_triggers()
 {
   m_attributes.define<ModelAttributeType>("model", false);
   m_attributes.define<ArityAttributeType>("target-arity", true);
@@ -49,23 +97,17 @@ Plugin::Plugin()
 bool
 Plugin::match(tree::Path const& path) const
 {
-  for (auto& e : m_plugins) {
-    if (e.first.match(path)) {
-      return true;
-    }
-  }
-  return false;
+  return m_triggers.find(path) != tree::Trigger::npos;
 }
 
 Class const&
 Plugin::getClassFor(tree::Path const& path) const
 {
-  for (auto& e : m_plugins) {
-    if (e.first.match(path)) {
-      return *e.second;
-    }
+  Class::Ref target = find(path);
+  if (target == nullptr) {
+    throw std::invalid_argument(path);
   }
-  throw std::invalid_argument(path);
+  return *target;
 }
 
 bool
@@ -112,6 +154,18 @@ Plugin::loadModel(tree::Value const& t)
     m_targetArity = std::static_pointer_cast<ArityAttributeType>(ar)->value();
   }
   for (auto& ch : MASTER.childrenForPath(n)) {
+    if (MASTER.lazyPlugins()) {
+      tree::Value::Ref root = Model::parse(ch);
+      std::list<tree::Path> triggers;
+      if (root != nullptr) {
+        collectTriggers(*root, triggers);
+      }
+      for (auto& tr : triggers) {
+        DEBUG("Register plugin model \"", ch, "\" for trigger \"", tr, "\"");
+        m_children->models[tr] = ch;
+      }
+      continue;
+    }
     Model::Ref child = Model::load(nullptr, ch);
     for (auto& tr : child->header().trigger()) {
       DEBUG("Build plugin model \"", ch, "\" for trigger \"", tr, "\"");
@@ -121,6 +175,7 @@ Plugin::loadModel(tree::Value const& t)
       }
     }
   }
+  index();
 }
 
 bool
@@ -182,7 +237,7 @@ Plugin::checkInstance(tree::Object const& r, tree::Value const& v) const
   if (not Type::checkInstance(r, v)) {
     return false;
   }
-  if (m_plugins.empty()) {
+  if (m_triggers.size() == 0) {
     ERROR(ERR_NO_PLUGIN_TRIGGERS);
     return false;
   }
@@ -193,24 +248,19 @@ Plugin::checkInstance(tree::Object const& r, tree::Value const& v) const
   int score = 0;
   tree::Object const& o = static_cast<tree::Object const&>(v);
   for (auto& e : o) {
-    bool matchFound = false;
-    Class::Ref target = nullptr;
-    for (auto& p : m_plugins) {
-      if (p.first.match(e.second->path())) {
-        target = p.second;
-        matchFound = true;
-        break;
-      }
-    }
-    if (not matchFound) {
+    auto path = e.second->path();
+    size_t idx = m_triggers.find(path);
+    Class::Ref target = find(path);
+    if (idx == tree::Trigger::npos) {
       ERROR(ERR_PLUGIN_NO_MATCH_FOUND(e.first));
       score += 1;
-    }
-    if (target != nullptr) {
-      if (not target->checkInstance(r, *e.second)) {
-        ERROR(ERR_FAILED_CHECKING_INSTANCE(e.first));
-        score += 1;
-      }
+    } else if (target == nullptr) {
+      auto const& name = m_children->models.at(m_triggers.at(idx));
+      ERROR(ERR_PLUGIN_NOT_LOADED(e.first, name));
+      score += 1;
+    } else if (not target->checkInstance(r, *e.second)) {
+      ERROR(ERR_FAILED_CHECKING_INSTANCE(e.first));
+      score += 1;
     }
   }
   return score == 0;
@@ -224,12 +274,11 @@ Plugin::expandInstance(tree::Object& r, tree::Value& v)
   for (auto& e : o) {
     auto path = e.second->path();
     if (m_instances.count(path) == 0) {
-      for (auto& p : m_plugins) {
-        if (p.first.match(path)) {
-          m_instances[path] =
-            std::static_pointer_cast<Class>(p.second->clone(e.first));
-          m_instances[path]->setParent(this);
-        }
+      Class::Ref target = find(path);
+      if (target != nullptr) {
+        m_instances[path] =
+          std::static_pointer_cast<Class>(target->clone(e.first));
+        m_instances[path]->setParent(this);
       }
     }
     m_instances[path]->expandInstance(r, *e.second);
@@ -271,61 +320,62 @@ Plugin::resolveInstance(tree::Object const& r, tree::Value const& v) const
 }
 
 void
-Plugin::display(Coach::Branch const& br) const
+Plugin::display(std::ostream& o, Coach::Branch const& br) const
 {
-  Type::display(br);
+  Type::display(o, br);
+  loadAll();
   size_t count = 0;
   for (auto& e : m_plugins) {
     Coach::Branch here;
     count += 1;
     here = br.push(count == m_plugins.size() ? Coach::Branch::Corner
                                              : Coach::Branch::Tee);
-    e.second->display(here);
+    e.second->display(o, here);
   }
 }
 
 bool
-Plugin::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
+Plugin::explain(std::ostream& o, tree::Path const& p,
+                tree::Path::const_iterator const& i) const
 {
-  Type::explain(p, i);
+  Type::explain(o, p, i);
   if (i == p.end()) {
-    std::cout << std::setw(13) << std::left << "available"
-              << ": [" << std::right;
+    o << std::setw(13) << std::left << "available" << ": [" << std::right;
     size_t cnt = 0;
-    for (auto& e : m_plugins) {
-      std::cout << std::endl;
-      indent(std::cout, 18);
-      std::cout << e.first;
+    for (size_t j = 0; j < m_triggers.size(); j += 1) {
+      o << std::endl;
+      indent(o, 18);
+      o << m_triggers.at(j);
       cnt += 1;
-      if (cnt < m_plugins.size()) {
-        std::cout << ",";
+      if (cnt < m_triggers.size()) {
+        o << ",";
       }
     }
     if (cnt != 0) {
-      std::cout << std::endl;
+      o << std::endl;
     }
-    indent(std::cout, cnt == 0 ? 1 : 16) << "]" << std::endl;
+    indent(o, cnt == 0 ? 1 : 16) << "]" << std::endl;
     return true;
   } else {
     switch ((*i)->type()) {
       case tree::path::Item::Type::Named: {
         if ((*i)->value() == "_") {
-          return m_model->explain(p, p.down(i));
+          return m_model->explain(o, p, p.down(i));
         } else {
-          for (auto& e : m_plugins) {
-            if (e.first.match(p)) {
-              return e.second->explain(p, p.down(i));
-            }
+          Class::Ref target = find(p);
+          if (target != nullptr) {
+            return target->explain(o, p, p.down(i));
           }
         }
       } break;
       case tree::path::Item::Type::Any: {
+        loadAll();
         if (p.down(i) != p.end()) {
           for (auto& e : m_plugins) {
-            e.second->explain(p, p.down(i));
+            e.second->explain(o, p, p.down(i));
           }
         } else {
-          ace::model::BasicType::explain(p, p.down(i));
+          ace::model::BasicType::explain(o, p, p.down(i));
           size_t maxSize = 0;
           for (auto& e : m_plugins) {
             if (e.first.toString().length() > maxSize) {
@@ -333,10 +383,10 @@ Plugin::explain(tree::Path const& p, tree::Path::const_iterator const& i) const
             }
           }
           for (auto& e : m_plugins) {
-            std::cout << std::setw(static_cast<int>(maxSize) + 2) << std::left
-                      << e.first << " : ";
-            std::cout << e.second->modelAttribute().model().filePath();
-            std::cout << std::right << std::endl;
+            o << std::setw(static_cast<int>(maxSize) + 2) << std::left
+              << e.first << " : ";
+            o << e.second->modelAttribute().model().filePath();
+            o << std::right << std::endl;
           }
         }
       }
@@ -356,6 +406,9 @@ Plugin::collectModelFileDependencies(std::set<std::string>& d) const
   for (auto& p : m_plugins) {
     p.second->collectModelFileDependencies(d);
   }
+  for (auto& e : m_children->models) {
+    d.insert(e.second);
+  }
 }
 
 void
@@ -378,6 +431,7 @@ Plugin::collectImplementationIncludes(std::set<std::string>& i) const
   i.insert("<map>");
   i.insert("<string>");
   i.insert("<vector>");
+  loadAll();
   for (auto& e : m_plugins) {
     i.insert(
       e.second->modelAttribute().model().implementationIncludeStatement(true));
@@ -391,15 +445,14 @@ Plugin::doBuildDefinition(std::string const& s, std::string const& v,
 {
   std::string const& n = modelAttribute().head();
   std::string const& tn = m_model->definitionType();
-  auto tmpPath = tempName();
+  auto tmpVal = tempName();
   auto tmpObj = tempName();
   auto tmpItem = tempName();
-  indent(o, l) << "auto " << tmpPath << " = ace::tree::Path::parse(" << e
-               << ");" << std::endl;
-  indent(o, l) << "if (r.has(" << tmpPath << ")) {" << std::endl;
+  indent(o, l) << "auto " << tmpVal << " = " << e << ";" << std::endl;
+  indent(o, l) << "if (" << tmpVal << " != nullptr) {" << std::endl;
   indent(o, l + 2) << "auto & " << tmpObj << " =" << std::endl;
   indent(o, l + 4) << "static_cast<ace::tree::Object const &>";
-  o << "(r.get(" << tmpPath << "));" << std::endl;
+  o << "(*" << tmpVal << ");" << std::endl;
   indent(o, l + 2) << "for (auto & " << tmpItem << " : " << tmpObj << ") {"
                    << std::endl;
   indent(o, l + 4) << "ace::tree::utils::parsePlugin<" << tn << ">"
@@ -537,10 +590,22 @@ Plugin::merge(BasicType const& b)
     ERROR(ERR_BASE_MODEL_MISMATCH);
     return false;
   }
+  pthread_mutex_lock(&m_children->lock);
   for (auto& e : pg.m_plugins) {
     e.second->setParent(this);
     m_plugins[e.first] = e.second;
+    m_children->models.erase(e.first);
+    m_children->loaded.erase(e.first);
+  }
+  for (auto& e : pg.m_children->models) {
+    if (pg.m_plugins.count(e.first) == 0) {
+      m_plugins.erase(e.first);
+      m_children->models[e.first] = e.second;
+      m_children->loaded.erase(e.first);
+    }
   }
+  pthread_mutex_unlock(&m_children->lock);
+  index();
   return true;
 }
 
@@ -746,4 +811,96 @@ Plugin::plugins() const
   return m_plugins;
 }
 
+Class::Ref
+Plugin::find(tree::Path const& path) const
+{
+  size_t idx = m_triggers.find(path);
+  if (idx == tree::Trigger::npos) {
+    return nullptr;
+  }
+  tree::Path const& trigger = m_triggers.at(idx);
+  auto it = m_plugins.find(trigger);
+  if (it != m_plugins.end()) {
+    return it->second;
+  }
+  return load(trigger);
+}
+
+/*
+ * Lazily registered children are loaded once and shared between the clones of
+ * the plugin. Each clone gets its own copy of the generated class. A failed
+ * load is remembered as well.
+ */
+Class::Ref
+Plugin::load(tree::Path const& trigger) const
+{
+  Class::Ref proto;
+  pthread_mutex_lock(&m_children->lock);
+  auto it = m_children->loaded.find(trigger);
+  if (it != m_children->loaded.end()) {
+    proto = it->second;
+  } else {
+    proto = buildChild(m_children->models.at(trigger));
+    m_children->loaded[trigger] = proto;
+  }
+  pthread_mutex_unlock(&m_children->lock);
+  if (proto == nullptr) {
+    return nullptr;
+  }
+  auto cref = std::static_pointer_cast<Class>(proto->clone(proto->name()));
+  cref->setParent(this);
+  m_plugins[trigger] = cref;
+  return cref;
+}
+
+Class::Ref
+Plugin::buildChild(std::string const& name) const
+{
+  DEBUG("Build plugin model \"", name, "\"");
+  Class::Ref cref = Class::build("_", this, name, m_targetArity);
+  if (cref == nullptr) {
+    return nullptr;
+  }
+  Model& mdl = cref->modelAttribute().model();
+  if (not mdl.flattenModel() or not mdl.validateModel()) {
+    return nullptr;
+  }
+  if (not mdl.isAnAncestor(*m_model)) {
+    ERROR(ERR_MODEL_NOT_AN_ANCESTOR(m_model->name(), cref->name()));
+    return nullptr;
+  }
+  return cref;
+}
+
+void
+Plugin::loadAll() const
+{
+  for (size_t i = 0; i < m_triggers.size(); i += 1) {
+    if (m_plugins.count(m_triggers.at(i)) == 0) {
+      load(m_triggers.at(i));
+    }
+  }
+}
+
+/*
+ * The triggers are indexed in the order of the plugin map, which is the order
+ * in which they are matched. Lazily registered triggers are merged in that
+ * order.
+ */
+void
+Plugin::index()
+{
+  std::set<tree::Path> triggers;
+  for (auto& e : m_plugins) {
+    triggers.insert(e.first);
+  }
+  for (auto& e : m_children->models) {
+    triggers.insert(e.first);
+  }
+  m_triggers.clear();
+  for (auto& e : triggers) {
+    m_triggers.add(e);
+  }
+}
+
 }}
@@ -210,20 +210,20 @@ Selector::resolveInstance(tree::Object const& r, tree::Value const& v) const
 }
 
 void
-Selector::display(Coach::Branch const& br) const
+Selector::display(std::ostream& o, Coach::Branch const& br) const
 {
-  Type::display(br);
+  Type::display(o, br);
   const Model* model = static_cast<const Model*>(owner());
   std::string const& n = templateAttribute().head();
-  return model->templates().get(n).display(br.push(Coach::Branch::Corner));
+  return model->templates().get(n).display(o, br.push(Coach::Branch::Corner));
 }
 
 bool
-Selector::explain(tree::Path const& p,
+Selector::explain(std::ostream& o, tree::Path const& p,
                   tree::Path::const_iterator const& i) const
 {
   if (i == p.end()) {
-    return EnumeratedType::explain(p, i);
+    return EnumeratedType::explain(o, p, i);
   }
   const Model* model = static_cast<const Model*>(owner());
   switch ((*i)->type()) {
@@ -231,18 +231,18 @@ Selector::explain(tree::Path const& p,
       if (hasEitherAttribute()) {
         for (auto& e : eitherAttribute().values()) {
           if (e == (*i)->value()) {
-            return m_types.at(e)->explain(p, p.down(i));
+            return m_types.at(e)->explain(o, p, p.down(i));
           }
         }
       } else {
         std::string const& n = templateAttribute().head();
-        return model->templates().get(n).explain(p, p.down(i));
+        return model->templates().get(n).explain(o, p, p.down(i));
       }
       break;
     }
     case tree::path::Item::Type::Any: {
       std::string const& n = templateAttribute().head();
-      return model->templates().get(n).explain(p, p.down(i));
+      return model->templates().get(n).explain(o, p, p.down(i));
     }
     default:
       break;
@@ -279,42 +279,32 @@ Selector::doBuildDefinition(std::string const& s, std::string const& v,
   const Model* m = static_cast<const Model*>(owner());
   std::string const& n = templateAttribute().head();
   std::string topHas = optional() and not multiple() ? s : tempName();
-  auto tmpPath = tempName();
+  auto tmpVal = tempName();
   auto tmpObj = tempName();
   auto tmpIdx = tempName();
-  auto tmpTgtPath = tempName();
-  std::string path(e);
-  if (*--path.end() == '"') {
-    path.erase(--path.end());
-    path = path + ".\" + ";
-  } else {
-    path = path + " + \".\" + ";
-  }
   BasicType const& bt = m->templates().get(n);
-  indent(o, l) << "auto " << tmpPath << " = ace::tree::Path::parse(" << e
-               << ");" << std::endl;
+  indent(o, l) << "auto " << tmpVal << " = " << e << ";" << std::endl;
   indent(o, l) << (optional() and not multiple() ? "" : "auto ") << topHas
-               << " = r.has(" << tmpPath << ");" << std::endl;
+               << " = " << tmpVal << " != nullptr;" << std::endl;
   indent(o, l) << "if (" << topHas << ") {" << std::endl;
   indent(o, l + 2) << "auto const & " << tmpObj << " =" << std::endl;
-  indent(o, l + 4) << "static_cast<ace::tree::Object const &>(r.get(" << tmpPath
-                   << "));";
+  indent(o, l + 4) << "static_cast<ace::tree::Object const &>(*" << tmpVal
+                   << ");";
   o << std::endl;
   indent(o, l + 2) << "for (auto & " << tmpIdx << " : " << tmpObj << ") {"
                    << std::endl;
-  indent(o, l + 4) << "auto " << tmpTgtPath << " = " << path << tmpIdx
-                   << ".first;" << std::endl;
+  std::string item = tmpIdx + ".second.get()";
   if (not bt.multiple() and bt.optional()) {
     auto tmpHas = tempName();
-    auto tmpVal = tempName();
+    auto tmpElm = tempName();
     indent(o, l + 4) << "bool " << tmpHas << ";" << std::endl;
-    indent(o, l + 4) << bt.typeName() << " " << tmpVal << ";" << std::endl;
-    bt.doBuildDefinition(tmpHas, tmpVal, tmpTgtPath, o, l + 4);
+    indent(o, l + 4) << bt.typeName() << " " << tmpElm << ";" << std::endl;
+    bt.doBuildDefinition(tmpHas, tmpElm, item, o, l + 4);
     indent(o, l + 4) << "if (" << tmpHas << ") ";
-    o << v + "[" + tmpIdx + ".first] = " << tmpVal << ";";
+    o << v + "[" + tmpIdx + ".first] = " << tmpElm << ";";
     o << std::endl;
   } else {
-    bt.doBuildDefinition(s, v + "[" + tmpIdx + ".first]", tmpTgtPath, o, l + 4);
+    bt.doBuildDefinition(s, v + "[" + tmpIdx + ".first]", item, o, l + 4);
   }
   indent(o, l + 2) << "}" << std::endl;
   indent(o, l) << "}" << std::endl;
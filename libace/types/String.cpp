@@ -75,7 +75,7 @@ String::loadModel(tree::Value const& t)
   if (m_attributes.has("match")) {
     auto const& a =
       static_cast<MatchAttributeType const&>(*m_attributes["match"]);
-    m_match = a.head();
+    m_match = common::Regex::Pattern(a.head());
   }
 }
 
@@ -92,8 +92,7 @@ String::checkInstance(tree::Object const& r, tree::Value const& v) const
       ERROR(ERR_STR_LEN_OUTSIDE_OF_CONSTRAINT);
       score += 1;
     }
-    if (not m_match.empty() and
-        not common::Regex::match(s.value<std::string>(), m_match)) {
+    if (not m_match.empty() and not m_match.match(s.value<std::string>())) {
       ERROR(ERR_STR_DOES_NOT_MATCH_CONSTRAINT);
       score += 1;
     }
@@ -23,9 +23,8 @@
 #include <ace/types/URI.h>
 #include <ace/types/IPv4.h>
 #include <ace/common/String.h>
-#include <ace/filesystem/Directory.h>
-#include <ace/filesystem/File.h>
-#include <ace/filesystem/Utils.h>
+#include <ace/engine/Context.h>
+#include <ace/filesystem/Probe.h>
 #include <ace/tree/Checker.h>
 #include <functional>
 #include <iostream>
@@ -45,8 +44,7 @@ checkFileFormat(std::string const& n, std::string const& b)
     ACE_LOG(Error, "uri \"", n, "\": ", ERR_FILE_URI_PATH_NOT_A_FILE(b));
     return false;
   }
-  ace::fs::File file(nodePath);
-  if (file.isValid()) {
+  if (CONTEXT.probe().result(b).openable) {
     return true;
   }
   ACE_LOG(Error, "uri \"", n, "\": ", ERR_FILE_URI_FILE_NOT_FOUND(b));
@@ -181,6 +179,38 @@ URI::validateModel()
   return score == 0;
 }
 
+void
+URI::collectProbes(tree::Value const& v, Probes& p) const
+{
+  v.each([&](tree::Value const& w) {
+    if (w.type() != tree::Value::Type::String) {
+      return;
+    }
+    std::string s = static_cast<tree::Primitive const&>(w).value();
+    size_t markerPos = s.find("://");
+    if (markerPos == std::string::npos) {
+      return;
+    }
+    std::string value = s.substr(markerPos + 3);
+    switch (parseScheme(s.substr(0, markerPos))) {
+      case Scheme::File: {
+        if (not fs::Path(value).isDirectory()) {
+          p.paths.insert(value);
+        }
+      } break;
+      case Scheme::IPv4: {
+        std::string host = value.substr(0, value.find(':'));
+        if (not IPv4FormatChecker::isAddress(host) and
+            IPv4FormatChecker::isHostName(host)) {
+          p.hosts.insert(host);
+        }
+      } break;
+      default:
+        break;
+    }
+  });
+}
+
 void
 URI::collectInterfaceIncludes(std::set<std::string>& i) const
 {
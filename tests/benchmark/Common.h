@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/common/Log.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_COMMON_H_
+#define BENCHMARK_COMMON_H_
+
+namespace ace { namespace bench {
+
+using Function = std::function<void()>;
+
+struct Case
+{
+  std::string group;
+  std::string name;
+  Function body;
+};
+
+inline std::vector<Case>&
+cases()
+{
+  static std::vector<Case> s_cases;
+  return s_cases;
+}
+
+inline std::map<std::string, Function>&
+setups()
+{
+  static std::map<std::string, Function> s_setups;
+  return s_setups;
+}
+
+inline bool
+add(const char* g, const char* n, Function const& f)
+{
+  cases().push_back({ g, n, f });
+  return true;
+}
+
+inline bool
+setup(const char* g, Function const& f)
+{
+  setups()[g] = f;
+  return true;
+}
+
+/**
+ * @brief Prevent the compiler from optimizing away a computed value
+ */
+template<typename T>
+inline void
+keep(T const& v)
+{
+  asm volatile("" : : "r,m"(v) : "memory");
+}
+
+}}
+
+/**
+ * @brief Declare a benchmark case. The body is executed once per iteration.
+ */
+#define BENCHMARK(__g, __n)                                                    \
+  static void __g##_##__n##_body();                                            \
+  static const bool __g##_##__n##_registered =                                 \
+    ace::bench::add(#__g, #__n, __g##_##__n##_body);                           \
+  static void __g##_##__n##_body()
+
+/**
+ * @brief Declare the setup of a benchmark group. It is executed, untimed,
+ * before each case of the group.
+ */
+#define BENCHMARK_SETUP(__g)                                                   \
+  static void __g##_setup();                                                   \
+  static const bool __g##_setup_registered =                                   \
+    ace::bench::setup(#__g, __g##_setup);                                      \
+  static void __g##_setup()
+
+#endif // BENCHMARK_COMMON_H_
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/engine/Master.h>
+#include <ace/tree/Scanner.h>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace {
+
+const size_t WIDE = 100000;
+
+/*
+ * Generated documents of about 1 MB and 100 MB, made of service records. The
+ * large one is only built when one of its cases runs. The cases only use the
+ * scanner interface, so they also run against the former jansson scanner.
+ */
+
+std::string
+buildDocument(const size_t size)
+{
+  std::ostringstream oss;
+  oss << "{\n  \"services\": [";
+  for (size_t i = 0; static_cast<size_t>(oss.tellp()) < size; i += 1) {
+    oss << (i == 0 ? "\n" : ",\n") << "    {\n"
+        << "      \"name\": \"service-" << i << "\",\n"
+        << "      \"port\": " << 1024 + i % 60000 << ",\n"
+        << "      \"ratio\": " << static_cast<double>(i % 100) / 8 << ",\n"
+        << "      \"enabled\": " << (i % 2 == 0 ? "true" : "false") << ",\n"
+        << "      \"tags\": [ \"tier-" << i % 4 << "\", \"zone\\u00e9\" ]\n"
+        << "    }";
+  }
+  oss << "\n  ]\n}\n";
+  return oss.str();
+}
+
+/*
+ * Generated document made of a single object with keys in reverse order, that
+ * the scanner checks for duplicates as it builds it.
+ */
+
+std::string const&
+wideDocument()
+{
+  static std::string s_document;
+  if (s_document.empty()) {
+    std::ostringstream oss;
+    oss << "{";
+    for (size_t i = WIDE; i > 0; i -= 1) {
+      oss << (i == WIDE ? "\n" : ",\n") << "  \"key-" << i << "\": " << i;
+    }
+    oss << "\n}\n";
+    s_document = oss.str();
+  }
+  return s_document;
+}
+
+std::string const&
+document(const size_t size)
+{
+  static std::map<size_t, std::string> s_documents;
+  if (s_documents.count(size) == 0) {
+    s_documents[size] = buildDocument(size);
+  }
+  return s_documents.at(size);
+}
+
+ace::tree::Value::Ref
+tree(const size_t size)
+{
+  static std::map<size_t, ace::tree::Value::Ref> s_trees;
+  if (s_trees.count(size) == 0) {
+    s_trees[size] = MASTER.scannerByName("json").parse(document(size), 0,
+                                                       nullptr);
+  }
+  return s_trees.at(size);
+}
+
+void
+parse(const size_t size)
+{
+  auto v = MASTER.scannerByName("json").parse(document(size), 0, nullptr);
+  ace::bench::keep(v);
+}
+
+void
+dump(const size_t size)
+{
+  std::ostringstream oss;
+  MASTER.scannerByName("json").dump(*tree(size),
+                                    ace::tree::Scanner::Format::Compact, oss);
+  ace::bench::keep(oss.tellp());
+}
+
+const size_t SMALL = 1 << 20;
+const size_t LARGE = 100 << 20;
+
+}
+
+BENCHMARK(Json, Parse1MB)
+{
+  parse(SMALL);
+}
+
+BENCHMARK(Json, Dump1MB)
+{
+  dump(SMALL);
+}
+
+BENCHMARK(Json, Parse100MB)
+{
+  parse(LARGE);
+}
+
+BENCHMARK(Json, Dump100MB)
+{
+  dump(LARGE);
+}
+
+BENCHMARK(Json, ParseWideObject)
+{
+  auto v = MASTER.scannerByName("json").parse(wideDocument(), 0, nullptr);
+  ace::bench::keep(v);
+}
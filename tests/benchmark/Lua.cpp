@@ -20,16 +20,40 @@
  * SOFTWARE.
  */
 
-#pragma once
-
+#include "Common.h"
+#include <ace/engine/Master.h>
 #include <ace/tree/Scanner.h>
 #include <string>
-#include <jansson.h>
 
-namespace ace { namespace jsonfmt { namespace Array {
+namespace {
+
+/*
+ * A small configuration, as found in large batches of service descriptions.
+ * The cases are skipped when the Lua format plugin is not installed.
+ */
 
-tree::Value::Ref build(std::string const& name, json_t* const ary);
+const char* CONFIG = R"(
+config = {
+  name = 'service',
+  port = 8080,
+  ratio = 0.5,
+  enabled = true,
+  tags = { 'tier-1', 'zone-a' },
+  limits = { cpu = 2, memory = 4096 }
+}
+)";
 
-json_t* dump(tree::Value const& v);
+}
 
-}}}
+/**
+ * @brief Parse a small Lua configuration.
+ */
+BENCHMARK(Lua, ParseSmall)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  char* argv[] = { const_cast<char*>("bench") };
+  auto v = MASTER.scannerByName("lua").parse(CONFIG, 1, argv);
+  ace::bench::keep(v);
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/engine/Master.h>
+#include <ace/model/Model.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+namespace {
+
+/*
+ * A model directory holding a few thousand files, looked up by name.
+ */
+
+ace::fs::Path s_directory;
+std::vector<ace::fs::Path> s_names;
+
+}
+
+BENCHMARK_SETUP(Model)
+{
+  MASTER.reset();
+  ace::fs::Path mdlPath =
+    ace::fs::Directory().path() / ace::fs::Path("model/");
+  MASTER.addModelDirectory(mdlPath);
+}
+
+/**
+ * @brief Reference load path: the check and load phases each parse the model
+ * sources they need.
+ */
+BENCHMARK(Model, LoadTwoPass)
+{
+  MASTER.clearModelCache();
+  if (not ace::model::Model::check(nullptr, "Service.json")) {
+    return;
+  }
+  auto mdl = ace::model::Model::load(nullptr, "Service.json");
+  mdl->flattenModel();
+  mdl->validateModel();
+  ace::bench::keep(mdl);
+}
+
+/**
+ * @brief Default load path: each model source is parsed once.
+ */
+BENCHMARK(Model, LoadSinglePass)
+{
+  MASTER.clearModelCache();
+  auto mdl = ace::model::Model::load("Service.json");
+  ace::bench::keep(mdl);
+}
+
+/**
+ * @brief Cached load path: the model graph is cloned from the master cache.
+ */
+BENCHMARK(Model, LoadCached)
+{
+  auto mdl = ace::model::Model::load("Service.json");
+  ace::bench::keep(mdl);
+}
+
+BENCHMARK_SETUP(ModelPath)
+{
+  if (s_directory.empty()) {
+    char tmpl[] = "/tmp/ace-bench-XXXXXX";
+    if (mkdtemp(tmpl) == nullptr) {
+      return;
+    }
+    s_directory = ace::fs::Path(tmpl, true);
+    for (long i = 0; i < 4096; i += 1) {
+      std::string name = "Model" + std::to_string(i) + ".json";
+      std::ofstream((s_directory / ace::fs::Path(name)).toString());
+      if (i % 16 == 0) {
+        s_names.push_back(ace::fs::Path(name));
+      }
+    }
+  }
+  MASTER.reset();
+  MASTER.addModelDirectory(s_directory);
+}
+
+/**
+ * @brief Look up model files by reading the model directory each time.
+ */
+BENCHMARK(ModelPath, ScanDirectory)
+{
+  ace::fs::Directory dir(s_directory);
+  size_t n = 0;
+  for (auto& p : s_names) {
+    n += dir.has(p) ? 1 : 0;
+  }
+  ace::bench::keep(n);
+}
+
+/**
+ * @brief Look up model files through the model directory index.
+ */
+BENCHMARK(ModelPath, Indexed)
+{
+  size_t n = 0;
+  for (auto& p : s_names) {
+    n += MASTER.modelPathFor(p).empty() ? 0 : 1;
+  }
+  ace::bench::keep(n);
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/engine/Master.h>
+#include <ace/model/Model.h>
+#include <ace/tree/Object.h>
+#include <ace/types/Plugin.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*
+ * A plugin option with a few hundred children, each with its own trigger, and
+ * the paths of the instances of all of them.
+ */
+
+const size_t CHILDREN = 512;
+
+const char* HEADER = R"(
+    "author": { "name": "John Doe", "email": "jdoe@acme.com" },
+    "version": "1.0",
+    "doc": "Benchmark model")";
+
+std::vector<std::string> s_sources;
+ace::model::Model::Ref s_model;
+std::vector<ace::tree::Path> s_paths;
+
+ace::model::Plugin const&
+plugin()
+{
+  return dynamic_cast<ace::model::Plugin const&>(s_model->body().get("var0"));
+}
+
+}
+
+BENCHMARK_SETUP(Plugin)
+{
+  if (s_model != nullptr) {
+    return;
+  }
+  MASTER.reset();
+  s_sources.reserve(CHILDREN + 2);
+  s_sources.push_back(std::string("{ \"header\": {") + HEADER +
+                      " }, \"body\": { } }");
+  MASTER.addInlinedModel("Base.json", s_sources.back());
+  for (size_t i = 0; i < CHILDREN; i += 1) {
+    s_sources.push_back(std::string("{ \"header\": {") + HEADER +
+                        ", \"include\": [ \"Base.json\" ]" +
+                        ", \"trigger\": [ \"$.*.service" + std::to_string(i) +
+                        "\" ] }, \"body\": { } }");
+    MASTER.addInlinedModel("Child" + std::to_string(i) + ".json",
+                           s_sources.back());
+  }
+  s_sources.push_back(std::string("{ \"header\": {") + HEADER +
+                      " }, \"body\": { \"var0\": { \"kind\": \"plugin\", " +
+                      "\"arity\": \"1\", \"model\": \"Base.json\", " +
+                      "\"doc\": \"plugin\" } } }");
+  MASTER.addInlinedModel("Host.json", s_sources.back());
+  s_model = ace::model::Model::load("Host.json");
+  if (s_model == nullptr) {
+    return;
+  }
+  auto config = ace::tree::Object::build();
+  auto var0 = ace::tree::Object::build("var0");
+  config->put(var0);
+  for (size_t i = 0; i < CHILDREN; i += 1) {
+    auto svc = ace::tree::Object::build("service" + std::to_string(i));
+    var0->put(svc);
+    s_paths.push_back(svc->path());
+  }
+}
+
+/**
+ * @brief Dispatch each instance by matching the triggers one after the other.
+ */
+BENCHMARK(Plugin, DispatchLinear)
+{
+  size_t n = 0;
+  for (auto& p : s_paths) {
+    for (auto& e : plugin().plugins()) {
+      if (e.first.match(p)) {
+        n += 1;
+        break;
+      }
+    }
+  }
+  ace::bench::keep(n);
+}
+
+/**
+ * @brief Dispatch each instance through the trigger index.
+ */
+BENCHMARK(Plugin, DispatchIndexed)
+{
+  size_t n = 0;
+  for (auto& p : s_paths) {
+    n += plugin().match(p) ? 1 : 0;
+  }
+  ace::bench::keep(n);
+}
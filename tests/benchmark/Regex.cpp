@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/common/Regex.h>
+#include <re2/re2.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*
+ * Values checked against the pattern of a constrained string, and rewritten by
+ * a hook. The compile cases reproduce the former implementation.
+ */
+
+const std::string PATTERN = "([a-z]+)-([0-9]+)\\.example\\.com";
+const std::string REWRITE = "\\2.\\1";
+
+std::vector<std::string> s_values;
+
+}
+
+BENCHMARK_SETUP(Regex)
+{
+  s_values.clear();
+  for (long i = 0; i < 256; i += 1) {
+    s_values.push_back("host-" + std::to_string(i) + ".example.com");
+  }
+}
+
+/**
+ * @brief Match values, compiling the pattern for each of them.
+ */
+BENCHMARK(Regex, MatchCompile)
+{
+  size_t n = 0;
+  for (auto& v : s_values) {
+    n += RE2::FullMatch(v, PATTERN) ? 1 : 0;
+  }
+  ace::bench::keep(n);
+}
+
+/**
+ * @brief Match values with a compiled pattern.
+ */
+BENCHMARK(Regex, MatchCompiled)
+{
+  size_t n = 0;
+  ace::common::Regex::Pattern p(PATTERN);
+  for (auto& v : s_values) {
+    n += p.match(v) ? 1 : 0;
+  }
+  ace::bench::keep(n);
+}
+
+/**
+ * @brief Rewrite values through the cache of compiled patterns.
+ */
+BENCHMARK(Regex, ExpandCached)
+{
+  std::string r;
+  for (auto& v : s_values) {
+    ace::common::Regex::expand(v, PATTERN, REWRITE, r);
+  }
+  ace::bench::keep(r);
+}
+
+/**
+ * @brief Rewrite values with a compiled pattern and rewrite template.
+ */
+BENCHMARK(Regex, ExpandCompiled)
+{
+  std::string r;
+  ace::common::Regex::Pattern p(PATTERN);
+  ace::common::Regex::Rewrite w(REWRITE);
+  for (auto& v : s_values) {
+    p.expand(v, w, r);
+  }
+  ace::bench::keep(r);
+}
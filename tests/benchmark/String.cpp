@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/common/String.h>
+#include <ace/tree/Utils.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*
+ * Primitive values as they appear in INI and SEXP files and in command line
+ * overrides. The stream cases reproduce the former implementation.
+ */
+
+std::vector<std::string> s_values;
+
+template<typename T>
+bool
+streamIs(std::string const& s)
+{
+  T r;
+  std::istringstream iss(s);
+  iss >> std::boolalpha >> r;
+  return (iss.rdstate() & (std::istream::failbit | std::istream::badbit)) == 0;
+}
+
+template<typename T>
+T
+streamValue(std::string const& s)
+{
+  T r = T();
+  std::istringstream iss(s);
+  iss >> std::boolalpha >> r;
+  return r;
+}
+
+template<typename T>
+void
+classify(bool (*is)(std::string const&))
+{
+  size_t n = 0;
+  for (auto& v : s_values) {
+    n += is(v) ? 1 : 0;
+  }
+  ace::bench::keep(n);
+}
+
+template<typename T>
+void
+convert(T (*value)(std::string const&))
+{
+  T sum = T();
+  for (auto& v : s_values) {
+    sum += value(v);
+  }
+  ace::bench::keep(sum);
+}
+
+}
+
+BENCHMARK_SETUP(String)
+{
+  s_values.clear();
+  for (long i = 0; i < 64; i += 1) {
+    s_values.push_back(std::to_string(i * 7919 - 4096));
+    s_values.push_back(std::to_string(static_cast<double>(i) / 8));
+    s_values.push_back(std::to_string(i) + "e-" + std::to_string(i % 300));
+    s_values.push_back(i % 2 == 0 ? "true" : "false");
+    s_values.push_back("option_" + std::to_string(i));
+  }
+}
+
+/**
+ * @brief Classify integers with a string stream.
+ */
+BENCHMARK(String, IsLongStream)
+{
+  classify<long>(streamIs<long>);
+}
+
+/**
+ * @brief Classify integers.
+ */
+BENCHMARK(String, IsLong)
+{
+  classify<long>(ace::common::String::is<long>);
+}
+
+/**
+ * @brief Classify real numbers with a string stream.
+ */
+BENCHMARK(String, IsDoubleStream)
+{
+  classify<double>(streamIs<double>);
+}
+
+/**
+ * @brief Classify real numbers.
+ */
+BENCHMARK(String, IsDouble)
+{
+  classify<double>(ace::common::String::is<double>);
+}
+
+/**
+ * @brief Classify booleans with a string stream.
+ */
+BENCHMARK(String, IsBoolStream)
+{
+  classify<bool>(streamIs<bool>);
+}
+
+/**
+ * @brief Classify booleans.
+ */
+BENCHMARK(String, IsBool)
+{
+  classify<bool>(ace::common::String::is<bool>);
+}
+
+/**
+ * @brief Convert integers with a string stream.
+ */
+BENCHMARK(String, ValueLongStream)
+{
+  convert<long>(streamValue<long>);
+}
+
+/**
+ * @brief Convert integers.
+ */
+BENCHMARK(String, ValueLong)
+{
+  convert<long>(ace::common::String::value<long>);
+}
+
+/**
+ * @brief Convert real numbers with a string stream.
+ */
+BENCHMARK(String, ValueDoubleStream)
+{
+  convert<double>(streamValue<double>);
+}
+
+/**
+ * @brief Convert real numbers.
+ */
+BENCHMARK(String, ValueDouble)
+{
+  convert<double>(ace::common::String::value<double>);
+}
+
+/**
+ * @brief Build the primitives of command line overrides.
+ */
+BENCHMARK(String, BuildPrimitive)
+{
+  for (auto& v : s_values) {
+    ace::bench::keep(ace::tree::utils::buildPrimitiveOrArray("v", v));
+  }
+}
@@ -0,0 +1,290 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/tree/Arena.h>
+#include <ace/tree/Array.h>
+#include <ace/tree/Object.h>
+#include <ace/tree/Primitive.h>
+#include <ace/tree/Query.h>
+#include <ace/tree/Utils.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+ace::tree::Object::Ref s_object;
+std::vector<std::string> s_keys;
+std::vector<std::string> s_paths;
+
+/*
+ * Object lookups, compared against the ordered map previously used to hold the
+ * children of an object. The small set mimics a typical configuration section
+ * and the large one a generated table.
+ */
+
+struct Lookup
+{
+  ace::tree::Object::Ref object;
+  std::map<std::string, ace::tree::Value::Ref> map;
+  std::vector<std::string> keys;
+};
+
+Lookup s_small;
+Lookup s_large;
+
+/*
+ * Path evaluation over a document, using recursive and wildcard items.
+ */
+
+ace::tree::Value::Ref s_document;
+std::vector<ace::tree::Path> s_queries;
+ace::tree::Query s_query;
+
+void
+buildLookup(Lookup& l, const long n)
+{
+  l.object = ace::tree::Object::build();
+  l.map.clear();
+  l.keys.clear();
+  for (long i = 0; i < n; i += 1) {
+    std::string key = "section.option_" + std::to_string(i * 7919 % n);
+    auto v = ace::tree::Primitive::build(key, i);
+    l.object->put(v);
+    l.map[key] = v;
+    l.keys.push_back(key);
+  }
+}
+
+template<typename T>
+void
+lookupIn(T const& c, std::vector<std::string> const& keys)
+{
+  size_t found = 0;
+  for (size_t r = 0; r < 16; r += 1) {
+    for (auto& k : keys) {
+      found += c.find(k) != nullptr ? 1 : 0;
+    }
+  }
+  ace::bench::keep(found);
+}
+
+struct MapFinder
+{
+  std::map<std::string, ace::tree::Value::Ref> const& map;
+
+  const ace::tree::Value* find(std::string const& k) const
+  {
+    auto it = map.find(k);
+    return it == map.end() ? nullptr : it->second.get();
+  }
+};
+
+ace::tree::Value::Ref
+buildDocument()
+{
+  auto root = ace::tree::Object::build();
+  for (size_t i = 0; i < s_keys.size(); i += 1) {
+    auto entry = ace::tree::Object::build(s_keys[i]);
+    entry->put(ace::tree::Primitive::build("name", s_keys[i]));
+    entry->put(ace::tree::Primitive::build("value", static_cast<long>(i)));
+    entry->put(ace::tree::Primitive::build("ratio", 0.5));
+    auto list = ace::tree::Array::build("list");
+    for (long j = 0; j < 8; j += 1) {
+      list->push_back(ace::tree::Primitive::build("", j));
+    }
+    entry->put(list);
+    root->put(entry);
+  }
+  return root;
+}
+
+}
+
+BENCHMARK_SETUP(Tree)
+{
+  s_object = ace::tree::Object::build();
+  s_keys.clear();
+  s_paths.clear();
+  for (long i = 0; i < 64; i += 1) {
+    std::string key = "option_" + std::to_string(i);
+    s_object->put(ace::tree::Primitive::build(key, i));
+    s_keys.push_back(key);
+    s_paths.push_back("$." + key);
+  }
+  buildLookup(s_small, 8);
+  buildLookup(s_large, 512);
+  s_document = buildDocument();
+  s_queries.clear();
+  s_query = ace::tree::Query();
+  for (auto const& p : { "$..name", "$..value", "$.*.ratio", "$..list[0:8:2]",
+                         "$.option_7.list[*]", "$..missing" }) {
+    s_queries.push_back(ace::tree::Path::parse(p));
+    s_query.add(s_queries.back());
+  }
+}
+
+/**
+ * @brief Accessors of older generated code: parse the path, then walk it twice.
+ */
+BENCHMARK(Tree, AccessByPath)
+{
+  long sum = 0;
+  for (auto& p : s_paths) {
+    long v = 0;
+    ace::tree::utils::parsePrimitive<long>(*s_object, p, v);
+    sum += v;
+  }
+  ace::bench::keep(sum);
+}
+
+/**
+ * @brief Accessors of generated code: one direct lookup per option.
+ */
+BENCHMARK(Tree, AccessByKey)
+{
+  long sum = 0;
+  for (auto& k : s_keys) {
+    long v = 0;
+    ace::tree::utils::parsePrimitive<long>(s_object->find(k), v);
+    sum += v;
+  }
+  ace::bench::keep(sum);
+}
+
+/**
+ * @brief Parse the paths of a configuration with the path cache disabled.
+ */
+BENCHMARK(Tree, ParsePathUncached)
+{
+  ace::tree::Path::setCacheCapacity(0);
+  for (auto& p : s_paths) {
+    ace::bench::keep(ace::tree::Path::parse(p));
+  }
+  ace::tree::Path::setCacheCapacity(4096);
+}
+
+/**
+ * @brief Parse the paths of a configuration through the path cache.
+ */
+BENCHMARK(Tree, ParsePathCached)
+{
+  for (auto& p : s_paths) {
+    ace::bench::keep(ace::tree::Path::parse(p));
+  }
+}
+
+/**
+ * @brief Evaluate each path of a set with has() then get().
+ */
+BENCHMARK(Tree, EvaluatePaths)
+{
+  size_t count = 0;
+  ace::tree::Value const& doc = *s_document;
+  for (auto const& p : s_queries) {
+    if (doc.has(p)) {
+      doc.get(p, [&](ace::tree::Value const& v) { count += 1; });
+    }
+  }
+  ace::bench::keep(count);
+}
+
+/**
+ * @brief Evaluate a set of paths in a single pass with a compiled query.
+ */
+BENCHMARK(Tree, EvaluateQuery)
+{
+  size_t count = 0;
+  ace::tree::Value const& doc = *s_document;
+  s_query.run(doc, [&](const size_t k, ace::tree::Value const& v) {
+    count += 1;
+  });
+  ace::bench::keep(count);
+}
+
+/**
+ * @brief Build and release a document on the heap.
+ */
+BENCHMARK(Tree, BuildOnHeap)
+{
+  ace::bench::keep(buildDocument());
+}
+
+/**
+ * @brief Build and release a document in an arena.
+ */
+BENCHMARK(Tree, BuildInArena)
+{
+  ace::tree::Arena::Scope scope;
+  ace::bench::keep(buildDocument());
+}
+
+/**
+ * @brief Look up every key of a small section in an ordered map.
+ */
+BENCHMARK(Tree, LookupSmallMap)
+{
+  lookupIn(MapFinder{ s_small.map }, s_small.keys);
+}
+
+/**
+ * @brief Look up every key of a small section in an object.
+ */
+BENCHMARK(Tree, LookupSmallObject)
+{
+  lookupIn(*s_small.object, s_small.keys);
+}
+
+/**
+ * @brief Look up every key of a large table in an ordered map.
+ */
+BENCHMARK(Tree, LookupLargeMap)
+{
+  lookupIn(MapFinder{ s_large.map }, s_large.keys);
+}
+
+/**
+ * @brief Look up every key of a large table in an object.
+ */
+BENCHMARK(Tree, LookupLargeObject)
+{
+  lookupIn(*s_large.object, s_large.keys);
+}
+
+/**
+ * @brief Build a large table with unsorted keys, then erase half of it.
+ */
+BENCHMARK(Tree, BuildLargeUnsorted)
+{
+  const long n = 8192;
+  auto object = ace::tree::Object::build();
+  for (long i = 0; i < n; i += 1) {
+    std::string key = "option_" + std::to_string(i * 7919 % n);
+    object->put(ace::tree::Primitive::build(key, i));
+  }
+  ace::bench::keep(object->size());
+  for (long i = 0; i < n; i += 2) {
+    object->erase("option_" + std::to_string(i));
+  }
+  ace::bench::keep(object->size());
+}
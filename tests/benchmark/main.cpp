@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+int
+main(int argc, char* argv[])
+{
+  /**
+   * Only log errors unless told otherwise
+   */
+  ace::common::Log::Level l = ace::common::Log::Error;
+  const char* ll = getenv("ACE_LOG_LEVEL");
+  if (ll != nullptr) {
+    l = ace::common::Log::parseLogLevel(ll);
+  }
+  ace::common::Log::get().setLogLevel(l);
+  /**
+   * Get the iteration count and the case filter
+   */
+  size_t iterations = 100;
+  const char* it = getenv("ACE_BENCH_ITERATIONS");
+  if (it != nullptr) {
+    iterations = std::strtoul(it, nullptr, 10);
+  }
+  std::string filter = argc > 1 ? argv[1] : "";
+  /**
+   * Run the cases
+   */
+  std::cout << std::setw(40) << std::left << "case" << std::right
+            << std::setw(12) << "iterations" << std::setw(16) << "ns/op"
+            << std::endl;
+  for (auto& c : ace::bench::cases()) {
+    std::string name = c.group + "." + c.name;
+    if (not filter.empty() and name.find(filter) == std::string::npos) {
+      continue;
+    }
+    auto setup = ace::bench::setups().find(c.group);
+    if (setup != ace::bench::setups().end()) {
+      setup->second();
+    }
+    c.body();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i += 1) {
+      c.body();
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto delta =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    std::cout << std::setw(40) << std::left << name << std::right
+              << std::setw(12) << iterations << std::setw(16)
+              << (iterations == 0 ? 0 : delta.count() / iterations)
+              << std::endl;
+  }
+  return 0;
+}
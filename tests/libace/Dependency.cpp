@@ -21,8 +21,13 @@
  */
 
 #include "Common.h"
+#include <ace/engine/Context.h>
 #include <ace/engine/Master.h>
+#include <ace/model/Image.h>
 #include <ace/model/Model.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 class Dependency : public ::testing::Test
 {
@@ -545,3 +550,138 @@ TEST_F(Dependency, Fail_RecursivePlugin_Missing)
                            const_cast<char**>(&prgnam));
   ASSERT_EQ(svr.get(), nullptr);
 }
+
+TEST_F(Dependency, Pass_Chain_All)
+{
+  WRITE_HEADER;
+  auto res = ace::model::Model::load("20_Chain.json");
+  auto svr =
+    res->validate("dependency/20_Chain.lua", 1, const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_TRUE(svr->has("t2"));
+  ASSERT_TRUE(svr->has("t1"));
+  ASSERT_TRUE(svr->has("t0"));
+}
+
+class DependencyImage : public Dependency
+{
+protected:
+  void TearDown() override
+  {
+    std::remove("20_Chain.aci");
+    SetUpTestCase();
+  }
+};
+
+TEST_F(DependencyImage, Pass_Chain_Image)
+{
+  WRITE_HEADER;
+  auto res0 = ace::model::Model::load("20_Chain.json");
+  ASSERT_NE(res0.get(), nullptr);
+  std::ofstream ofs("20_Chain.aci", std::ios::binary);
+  ASSERT_TRUE(ace::model::Image::write(*res0, ofs));
+  ofs.close();
+  MASTER.reset();
+  std::string name;
+  ASSERT_TRUE(ace::model::Image::load("20_Chain.aci", name));
+  auto res1 = ace::model::Model::load(name);
+  ASSERT_NE(res1.get(), nullptr);
+  auto svr =
+    res1->validate("dependency/20_Chain.lua", 1, const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_TRUE(svr->has("t2"));
+  ASSERT_TRUE(svr->has("t1"));
+  ASSERT_TRUE(svr->has("t0"));
+}
+
+TEST_F(Dependency, Fail_DisableCycle)
+{
+  WRITE_HEADER;
+  auto res = ace::model::Model::load("21_DisableCycle.json");
+  ASSERT_EQ(res.get(), nullptr);
+}
+
+TEST_F(Dependency, Revalidate)
+{
+  WRITE_HEADER;
+  auto res = ace::model::Model::load("22_Revalidate.json");
+  auto svr = res->validate("dependency/22_Revalidate.lua", 1,
+                           const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_TRUE(svr->has("t0"));
+  ace::tree::Object& obj = static_cast<ace::tree::Object&>(*svr);
+  obj.put(ace::tree::Primitive::build("u", 42));
+  obj.erase("t1");
+  std::vector<ace::tree::Path> changes = { ace::tree::Path::parse("$.t2") };
+  res = ace::model::Model::load("22_Revalidate.json");
+  ASSERT_TRUE(res->revalidate(*svr, changes));
+  ASSERT_TRUE(svr->has("t1"));
+  changes.push_back(ace::tree::Path::parse("$.u"));
+  res = ace::model::Model::load("22_Revalidate.json");
+  ASSERT_FALSE(res->revalidate(*svr, changes));
+}
+
+TEST_F(Dependency, Revalidate_DropDefaulted)
+{
+  WRITE_HEADER;
+  ace::engine::Context context;
+  ace::engine::Context::Scope scope(context);
+  auto res = ace::model::Model::load("22_Revalidate.json");
+  auto svr = res->validate("dependency/22_Revalidate.lua", 1,
+                           const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_TRUE(svr->has("t1"));
+  ASSERT_TRUE(svr->has("t0"));
+  ace::tree::Object& obj = static_cast<ace::tree::Object&>(*svr);
+  obj.erase("t2");
+  std::vector<ace::tree::Path> changes = { ace::tree::Path::parse("$.t2") };
+  res = ace::model::Model::load("22_Revalidate.json");
+  ASSERT_TRUE(res->revalidate(*svr, changes));
+  ASSERT_FALSE(svr->has("t1"));
+  ASSERT_FALSE(svr->has("t0"));
+}
+
+TEST_F(Dependency, Revalidate_DisabledDefaulted)
+{
+  WRITE_HEADER;
+  ace::engine::Context context;
+  ace::engine::Context::Scope scope(context);
+  auto res = ace::model::Model::load("23_RevalidateDisable.json");
+  auto svr = res->validate("dependency/23_RevalidateDisable.lua", 1,
+                           const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_TRUE(svr->has("t1"));
+  ace::tree::Object& obj = static_cast<ace::tree::Object&>(*svr);
+  obj.put(ace::tree::Primitive::build("t0", "off"));
+  std::vector<ace::tree::Path> changes = { ace::tree::Path::parse("$.t0") };
+  res = ace::model::Model::load("23_RevalidateDisable.json");
+  ASSERT_TRUE(res->revalidate(*svr, changes));
+  ASSERT_FALSE(svr->has("t1"));
+  std::ostringstream oss;
+  context.summarize(oss, ace::engine::Context::Option::Defaulted);
+  ASSERT_EQ(oss.str().find("t1"), std::string::npos);
+}
+
+TEST_F(Dependency, Revalidate_DisabledObject)
+{
+  WRITE_HEADER;
+  ace::engine::Context context;
+  ace::engine::Context::Scope scope(context);
+  auto res = ace::model::Model::load("24_RevalidateObject.json");
+  auto svr = res->validate("dependency/24_RevalidateObject.lua", 1,
+                           const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_TRUE(svr->has(ace::tree::Path::parse("$.t1.var0")));
+  std::ostringstream before;
+  context.summarize(before, ace::engine::Context::Option::Defaulted);
+  ASSERT_NE(before.str().find("$.t1 "), std::string::npos);
+  ace::tree::Object& obj = static_cast<ace::tree::Object&>(*svr);
+  obj.put(ace::tree::Primitive::build("t0", "off"));
+  std::vector<ace::tree::Path> changes = { ace::tree::Path::parse("$.t0") };
+  res = ace::model::Model::load("24_RevalidateObject.json");
+  ASSERT_TRUE(res->revalidate(*svr, changes));
+  ASSERT_FALSE(svr->has("t1"));
+  std::ostringstream after;
+  context.summarize(after, ace::engine::Context::Option::Defaulted);
+  ASSERT_EQ(after.str().find("t1"), std::string::npos);
+}
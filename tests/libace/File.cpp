@@ -23,6 +23,7 @@
 #include "Common.h"
 #include <ace/engine/Master.h>
 #include <ace/model/Model.h>
+#include <ace/filesystem/Probe.h>
 
 class File : public ::testing::Test
 {
@@ -80,3 +81,20 @@ TEST_F(File, Pass_Ok2_DirAlreadyExists)
                            const_cast<char**>(&prgnam));
   ASSERT_NE(svr.get(), nullptr);
 }
+
+TEST_F(File, Probe)
+{
+  ace::fs::Probe probe;
+  probe.probe({ "/", "/tmp/", "/__ace_missing__/file" });
+  ASSERT_EQ(probe.probed(), 3);
+  auto root = probe.result("/");
+  ASSERT_EQ(root.type, ace::fs::Node::Type::Directory);
+  ASSERT_TRUE(root.openable);
+  auto missing = probe.result("/__ace_missing__/file");
+  ASSERT_EQ(missing.type, ace::fs::Node::Type::Unknown);
+  ASSERT_EQ(probe.probed(), 3);
+  probe.result("/tmp");
+  ASSERT_EQ(probe.probed(), 4);
+  probe.clear();
+  ASSERT_EQ(probe.probed(), 0);
+}
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/engine/Master.h>
+#include <ace/tree/Primitive.h>
+#include <cstdlib>
+#include <string>
+
+/*
+ * The sandbox of the LUA scanner. The cases are skipped when the LUA format
+ * plugin is not installed.
+ */
+class Lua : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    unsetenv("ACE_LUA_INSTRUCTION_LIMIT");
+    unsetenv("ACE_LUA_MEMORY_LIMIT");
+  }
+
+  static ace::tree::Value::Ref parse(std::string const& s)
+  {
+    char* argv[] = { const_cast<char*>(prgnam) };
+    return MASTER.scannerByName("lua").parse(s, 1, argv);
+  }
+
+  static const char* prgnam;
+};
+
+const char* Lua::prgnam = "tests";
+
+TEST_F(Lua, Fail_BlockedIo)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  ASSERT_NE(parse("config = { a = 1 }"), nullptr);
+  ASSERT_EQ(parse("config = { a = io.open('/dev/null') }"), nullptr);
+  ASSERT_EQ(parse("config = { a = os.execute('true') }"), nullptr);
+}
+
+TEST_F(Lua, Fail_BlockedRequire)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  ASSERT_EQ(parse("local m = require('os') config = {}"), nullptr);
+  ASSERT_EQ(parse("local f = load('return 1') config = {}"), nullptr);
+}
+
+TEST_F(Lua, Fail_MemoryLimit)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  setenv("ACE_LUA_MEMORY_LIMIT", "1000000", 1);
+  ASSERT_EQ(parse("local t = {} for i = 1, 1e7 do t[i] = i end config = {}"),
+            nullptr);
+  ASSERT_NE(parse("local t = {} for i = 1, 1e3 do t[i] = i end config = {}"),
+            nullptr);
+}
+
+TEST_F(Lua, Fail_InstructionLimit)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  setenv("ACE_LUA_INSTRUCTION_LIMIT", "100000", 1);
+  ASSERT_EQ(parse("while true do end config = {}"), nullptr);
+  ASSERT_NE(parse("local ok = pcall(error, 'e') config = { ok = ok }"),
+            nullptr);
+}
+
+TEST_F(Lua, Fail_InstructionLimitCaught)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  setenv("ACE_LUA_INSTRUCTION_LIMIT", "100000", 1);
+  ASSERT_EQ(parse("while true do pcall(function() while true do end end) end"),
+            nullptr);
+  ASSERT_EQ(parse("while true do xpcall(function() while true do end end, "
+                  "function(e) return e end) end"),
+            nullptr);
+  ASSERT_EQ(parse("while true do coroutine.resume(coroutine.create("
+                  "function() while true do end end)) end"),
+            nullptr);
+}
+
+TEST_F(Lua, Pass_YieldAcrossPcall)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  std::string src = "local co = coroutine.create(function()"
+                    "  local ok, v = pcall(coroutine.yield, 1) "
+                    "  return ok and v == 2 "
+                    "end) "
+                    "local _, a = coroutine.resume(co) "
+                    "local _, b = coroutine.resume(co, 2) "
+                    "config = { ok = a == 1 and b }";
+  ASSERT_NE(parse("config = {} "
+                  "coroutine.wrap(function() pcall(coroutine.yield) end)()"),
+            nullptr);
+  auto ok = [&src]() {
+    auto res = parse(src);
+    return res != nullptr and
+           static_cast<ace::tree::Primitive const&>(res->get("ok"))
+             .value<bool>();
+  };
+  ASSERT_TRUE(ok());
+  setenv("ACE_LUA_INSTRUCTION_LIMIT", "100000", 1);
+  ASSERT_TRUE(ok());
+}
+
+TEST_F(Lua, Pass_Isolation)
+{
+  if (not MASTER.hasScannerByName("lua")) {
+    return;
+  }
+  ASSERT_NE(parse("leak = 1 string.leak = 1 config = {}"), nullptr);
+  auto res = parse("config = { leak = leak ~= nil or string.leak ~= nil }");
+  ASSERT_NE(res, nullptr);
+  auto const& p = static_cast<ace::tree::Primitive const&>(res->get("leak"));
+  ASSERT_FALSE(p.value<bool>());
+}
@@ -21,8 +21,15 @@
  */
 
 #include "Common.h"
+#include <ace/engine/Context.h>
 #include <ace/engine/Master.h>
+#include <ace/model/Image.h>
 #include <ace/model/Model.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
 
 class Model : public ::testing::Test
 {
@@ -148,3 +155,119 @@ TEST_F(Model, Pass_Ok_All)
   auto svr = res->validate("model/01_Ok.lua", 1, const_cast<char**>(&prgnam));
   ASSERT_NE(svr.get(), nullptr);
 }
+
+TEST_F(Model, Pass_SingleParse)
+{
+  WRITE_HEADER;
+  auto root = ace::model::Model::parse("01_Ok.json");
+  ASSERT_NE(root.get(), nullptr);
+  ASSERT_TRUE(ace::model::Model::check(nullptr, "01_Ok.json", *root));
+  auto res = ace::model::Model::load(nullptr, "01_Ok.json", *root);
+  ASSERT_NE(res.get(), nullptr);
+  ASSERT_TRUE(res->flattenModel());
+  ASSERT_TRUE(res->validateModel());
+}
+
+TEST_F(Model, Fail_ParseMissing)
+{
+  WRITE_HEADER;
+  auto root = ace::model::Model::parse("00_Missing.json");
+  ASSERT_EQ(root.get(), nullptr);
+}
+
+TEST_F(Model, Pass_Cached)
+{
+  WRITE_HEADER;
+  auto res0 = ace::model::Model::load("01_Ok.json");
+  ASSERT_NE(res0.get(), nullptr);
+  ASSERT_TRUE(MASTER.hasCachedModel("01_Ok.json"));
+  auto res1 = ace::model::Model::load("01_Ok.json");
+  ASSERT_NE(res1.get(), nullptr);
+  ASSERT_NE(res0.get(), res1.get());
+  auto svr = res1->validate("model/01_Ok.lua", 1, const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  MASTER.clearModelCache();
+  ASSERT_FALSE(MASTER.hasCachedModel("01_Ok.json"));
+}
+
+/**
+ * Loading an image registers compiled models in the master. The fixture gives
+ * the image tests a pristine master and restores the model directories of the
+ * suite afterwards, even when a test fails midway.
+ */
+
+class ModelImage : public Model
+{
+protected:
+  void SetUp() override
+  {
+    MASTER.reset();
+    SetUpTestCase();
+  }
+
+  void TearDown() override
+  {
+    std::remove("01_Ok.aci");
+    MASTER.reset();
+    SetUpTestCase();
+  }
+};
+
+TEST_F(ModelImage, Pass_Image)
+{
+  WRITE_HEADER;
+  auto res0 = ace::model::Model::load("01_Ok.json");
+  ASSERT_NE(res0.get(), nullptr);
+  std::ofstream ofs("01_Ok.aci", std::ios::binary);
+  ASSERT_TRUE(ace::model::Image::write(*res0, ofs));
+  ofs.close();
+  MASTER.reset();
+  ASSERT_FALSE(MASTER.hasModel("01_Ok.json"));
+  std::string name;
+  ASSERT_TRUE(ace::model::Image::isImage("01_Ok.aci"));
+  ASSERT_TRUE(ace::model::Image::load("01_Ok.aci", name));
+  ASSERT_EQ(name, "01_Ok.json");
+  ASSERT_TRUE(MASTER.isCompiledModel("01_Ok.json"));
+  auto res1 = ace::model::Model::load(name);
+  ASSERT_NE(res1.get(), nullptr);
+  auto svr = res1->validate("model/01_Ok.lua", 1, const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+}
+
+TEST_F(ModelImage, Fail_ImageTruncated)
+{
+  WRITE_HEADER;
+  std::ofstream ofs("00_Truncated.aci", std::ios::binary);
+  ofs << "ACEI";
+  ofs.close();
+  std::string name;
+  ASSERT_FALSE(ace::model::Image::load("00_Truncated.aci", name));
+  std::remove("00_Truncated.aci");
+}
+
+TEST_F(Model, Pass_ConcurrentValidate)
+{
+  WRITE_HEADER;
+  ASSERT_NE(ace::model::Model::load("01_Ok.json").get(), nullptr);
+  std::atomic<int> valid(0);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 4; i += 1) {
+    workers.emplace_back([&valid]() {
+      auto mdl = ace::model::Model::load("01_Ok.json");
+      if (mdl == nullptr) {
+        return;
+      }
+      ace::engine::Context context;
+      ace::engine::Context::Scope scope(context);
+      auto svr =
+        mdl->validate("model/01_Ok.lua", 1, const_cast<char**>(&prgnam));
+      if (svr != nullptr and &CONTEXT == &context) {
+        valid += 1;
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  ASSERT_EQ(valid, 4);
+}
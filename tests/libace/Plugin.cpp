@@ -23,6 +23,7 @@
 #include "Common.h"
 #include <ace/engine/Master.h>
 #include <ace/model/Model.h>
+#include <ace/types/Plugin.h>
 
 class Plugin : public ::testing::Test
 {
@@ -213,3 +214,70 @@ TEST_F(PluginWithPreload, Pass_Ok_Derived)
     res->validate("plugin/01_DerivedOk.lua", 1, const_cast<char**>(&prgnam));
   ASSERT_NE(svr.get(), nullptr);
 }
+
+class PluginLazy : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    MASTER.reset();
+    MASTER.setLazyPlugins(true);
+    ace::fs::Path incPath =
+      ace::fs::Directory().path() / ace::fs::Path("plugin/");
+    MASTER.addModelDirectory(incPath);
+    incPath = ace::fs::Directory().path() / ace::fs::Path("includes/");
+    MASTER.addModelDirectory(incPath);
+  }
+
+  static void TearDownTestCase() { MASTER.setLazyPlugins(false); }
+
+  static ace::model::Plugin const& plugin(ace::model::Model const& m)
+  {
+    return dynamic_cast<ace::model::Plugin const&>(m.body().get("var0"));
+  }
+
+protected:
+  static const char* prgnam;
+};
+
+const char* PluginLazy::prgnam = "tests";
+
+TEST_F(PluginLazy, Pass_Ok)
+{
+  WRITE_HEADER;
+  auto plf = ace::model::Model::load("../includes/DerivedTrigger.json");
+  ASSERT_NE(plf.get(), nullptr);
+  auto plg = ace::model::Model::load("../includes/Trigger.json");
+  ASSERT_NE(plg.get(), nullptr);
+  auto res = ace::model::Model::load("01_Ok.json");
+  ASSERT_NE(res.get(), nullptr);
+  ASSERT_TRUE(plugin(*res).plugins().empty());
+}
+
+TEST_F(PluginLazy, Pass_Ok_All)
+{
+  WRITE_HEADER;
+  auto res = ace::model::Model::load("01_Ok.json");
+  auto svr = res->validate("plugin/01_Ok.lua", 1, const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_EQ(plugin(*res).plugins().size(), 1);
+}
+
+TEST_F(PluginLazy, Pass_Ok_Derived)
+{
+  WRITE_HEADER;
+  auto res = ace::model::Model::load("01_Ok.json");
+  auto svr =
+    res->validate("plugin/01_DerivedOk.lua", 1, const_cast<char**>(&prgnam));
+  ASSERT_NE(svr.get(), nullptr);
+  ASSERT_EQ(plugin(*res).plugins().size(), 2);
+}
+
+TEST_F(PluginLazy, Fail_Ok_BadTargetArity)
+{
+  WRITE_HEADER;
+  auto res = ace::model::Model::load("01_Ok.json");
+  auto svr = res->validate("plugin/01_BadTargetArity.lua", 1,
+                           const_cast<char**>(&prgnam));
+  ASSERT_EQ(svr.get(), nullptr);
+}
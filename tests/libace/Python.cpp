@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "Common.h"
+#include <ace/engine/Master.h>
+#include <ace/tree/Array.h>
+#include <ace/tree/Primitive.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * The embedded interpreter of the Python scanner. The cases are skipped when
+ * the Python format plugin is not installed.
+ */
+class Python : public ::testing::Test
+{
+protected:
+  static bool run(std::string const& dir)
+  {
+    std::string fn = "python/" + dir + "/config.py";
+    char* argv[] = { const_cast<char*>(prgnam), const_cast<char*>("--"),
+                     const_cast<char*>(dir.c_str()) };
+    auto v = MASTER.scannerByName("python").open(fn, 3, argv);
+    if (v == nullptr) {
+      return false;
+    }
+    auto const& args = static_cast<ace::tree::Array const&>(v->get("argv"));
+    auto const& helper =
+      static_cast<ace::tree::Primitive const&>(v->get("helper"));
+    auto const& path = static_cast<ace::tree::Primitive const&>(v->get("path"));
+    return args.size() == 1 and
+           static_cast<ace::tree::Primitive const&>(*args.at(0))
+               .value<std::string>() == dir and
+           helper.value<std::string>() == dir and
+           path.value<std::string>() == "python/" + dir + "/";
+  }
+
+  static const char* prgnam;
+};
+
+const char* Python::prgnam = "tests";
+
+TEST_F(Python, Pass_Isolation)
+{
+  if (not MASTER.hasScannerByName("python")) {
+    return;
+  }
+  ASSERT_TRUE(run("a"));
+  ASSERT_TRUE(run("b"));
+  ASSERT_TRUE(run("a"));
+}
+
+TEST_F(Python, Pass_ConcurrentIsolation)
+{
+  if (not MASTER.hasScannerByName("python")) {
+    return;
+  }
+  std::vector<int> results(8, 0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); i += 1) {
+    threads.emplace_back([i, &results] {
+      for (int n = 0; n < 4; n += 1) {
+        results[i] += run(i % 2 == 0 ? "a" : "b") ? 1 : 0;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto r : results) {
+    ASSERT_EQ(r, 4);
+  }
+}
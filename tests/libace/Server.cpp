@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+#include <ace/engine/Master.h>
+#include <ace/engine/Server.h>
+#include <ace/model/Model.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+class Server : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    MASTER.reset();
+    ace::fs::Path incPath =
+      ace::fs::Directory().path() / ace::fs::Path("model/");
+    MASTER.addModelDirectory(incPath);
+  }
+
+protected:
+  static int connectTo(std::string const& path)
+  {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof(addr)) != 0) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  static std::string request(int fd, std::string const& req)
+  {
+    std::string rep;
+    if (not ace::engine::Server::writeFrame(fd, req) or
+        not ace::engine::Server::readFrame(fd, rep)) {
+      return "";
+    }
+    return rep;
+  }
+
+  static const char* sockPath;
+};
+
+const char* Server::sockPath = "tests.sock";
+
+TEST_F(Server, Pass_RoundTrip)
+{
+  WRITE_HEADER;
+  std::ofstream ofs("00_Server.lua");
+  ofs << "cfg = { }" << std::endl;
+  ofs.close();
+  std::set<std::string> models = { "01_Ok.json", "00_BadDoc.json" };
+  ace::engine::Server server("tests", models);
+  ASSERT_TRUE(server.listen(sockPath));
+  std::thread runner(&ace::engine::Server::run, &server);
+  std::string ok, ko, exp, unk, bad;
+  int fd = connectTo(sockPath);
+  if (fd >= 0) {
+    ok = request(fd, "validate\n01_Ok.json\nmodel/01_Ok.lua");
+    ko = request(fd, "validate\n01_Ok.json\n00_Server.lua");
+    exp = request(fd, "explain\n01_Ok.json\n$");
+    unk = request(fd, "validate\n00_Unknown.json\nmodel/01_Ok.lua");
+    bad = request(fd, "explain\n00_BadDoc.json\n$");
+  }
+  /**
+   * The connection is still open: stopping the server must shut it down.
+   */
+  server.stop();
+  runner.join();
+  std::remove("00_Server.lua");
+  ASSERT_GE(fd, 0);
+  close(fd);
+  ASSERT_EQ(ok.substr(0, 3), "OK\n");
+  ASSERT_EQ(ko.substr(0, 6), "ERROR\n");
+  ASSERT_NE(ko.find("no \"config\" dictionary"), std::string::npos);
+  ASSERT_EQ(exp.substr(0, 3), "OK\n");
+  ASSERT_NE(exp.find("Ok model"), std::string::npos);
+  ASSERT_EQ(unk, "ERROR\nUnknown model: 00_Unknown.json");
+  ASSERT_EQ(bad.substr(0, 36), "ERROR\nInvalid model: 00_BadDoc.json\n");
+  ASSERT_NE(bad.find("Documentation one-liner cannot be empty"),
+            std::string::npos);
+}
+
+TEST_F(Server, Pass_StaleSocket)
+{
+  WRITE_HEADER;
+  {
+    ace::engine::Server server("tests", {});
+    ASSERT_TRUE(server.listen(sockPath));
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, sockPath, sizeof(addr.sun_path) - 1);
+  ASSERT_EQ(bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)),
+            0);
+  close(fd);
+  ace::engine::Server server("tests", {});
+  ASSERT_TRUE(server.listen(sockPath));
+}
+
+TEST_F(Server, Fail_NotASocket)
+{
+  WRITE_HEADER;
+  std::ofstream ofs(sockPath);
+  ofs << "data" << std::endl;
+  ofs.close();
+  ace::engine::Server server("tests", {});
+  ASSERT_FALSE(server.listen(sockPath));
+  struct stat st;
+  ASSERT_EQ(lstat(sockPath, &st), 0);
+  ASSERT_TRUE(S_ISREG(st.st_mode));
+  std::remove(sockPath);
+}
@@ -21,8 +21,10 @@
  */
 
 #include "Common.h"
+#include <ace/common/String.h>
 #include <ace/engine/Master.h>
 #include <ace/model/Model.h>
+#include <limits>
 
 class String : public ::testing::Test
 {
@@ -116,3 +118,44 @@ TEST_F(String, Pass_Constrained_NoMatch)
     res->validate("string/02_NoMatch.json", 1, const_cast<char**>(&prgnam));
   ASSERT_EQ(svr.get(), nullptr);
 }
+
+TEST_F(String, Conversions)
+{
+  namespace S = ace::common::String;
+  ASSERT_TRUE(S::is<long>("+42"));
+  ASSERT_FALSE(S::is<long>("-42x"));
+  ASSERT_FALSE(S::is<long>("+-42"));
+  ASSERT_FALSE(S::is<long>("99999999999999999999"));
+  ASSERT_EQ(S::value<long>("  -42"), -42);
+  ASSERT_EQ(S::value<long>("12-3"), 12);
+  ASSERT_EQ(S::value<long>("abc"), 0);
+  ASSERT_EQ(S::value<long>("99999999999999999999"),
+            std::numeric_limits<long>::max());
+  ASSERT_TRUE(S::is<long>("-9223372036854775808"));
+  ASSERT_TRUE(S::is<long>("9223372036854775807"));
+  ASSERT_FALSE(S::is<long>("-9223372036854775809"));
+  ASSERT_FALSE(S::is<long>("9223372036854775808"));
+  ASSERT_EQ(S::value<long>("-9223372036854775808"),
+            std::numeric_limits<long>::min());
+  ASSERT_EQ(S::value<long>("9223372036854775807"),
+            std::numeric_limits<long>::max());
+  ASSERT_EQ(S::value<long>("-9223372036854775809"),
+            std::numeric_limits<long>::min());
+  ASSERT_EQ(S::value<unsigned long>("-1"),
+            std::numeric_limits<unsigned long>::max());
+  ASSERT_TRUE(S::is<double>("1.5"));
+  ASSERT_TRUE(S::is<double>("+1e3"));
+  ASSERT_TRUE(S::is<double>("1e-400"));
+  ASSERT_FALSE(S::is<double>("1e400"));
+  ASSERT_FALSE(S::is<double>("1e"));
+  ASSERT_FALSE(S::is<double>("42"));
+  ASSERT_FALSE(S::is<double>("1.2.3"));
+  ASSERT_FALSE(S::is<double>("1e2E3"));
+  ASSERT_EQ(S::value<double>(" -.5e1"), -5.0);
+  ASSERT_EQ(S::value<double>("1e-400"), 0.0);
+  ASSERT_TRUE(S::is<bool>("true"));
+  ASSERT_TRUE(S::is<bool>(" false"));
+  ASSERT_FALSE(S::is<bool>("tru"));
+  ASSERT_TRUE(S::value<bool>("true"));
+  ASSERT_FALSE(S::value<bool>("1"));
+}
@@ -21,11 +21,18 @@
  */
 
 #include "Common.h"
+#include <ace/common/Symbol.h>
+#include <ace/engine/Master.h>
+#include <ace/tree/Arena.h>
+#include <ace/tree/Builder.h>
 #include <ace/tree/Array.h>
 #include <ace/tree/Object.h>
 #include <ace/tree/Primitive.h>
+#include <ace/tree/Query.h>
 #include <ace/tree/Value.h>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 class Tree : public ::testing::Test
@@ -176,3 +183,318 @@ TEST_F(Tree, UnsignedShort)
   auto ref = ace::tree::Primitive::build("hello", val);
   ASSERT_TRUE(ref->is<uint16_t>());
 }
+
+TEST_F(Tree, Query)
+{
+  auto root = ace::tree::Object::build("");
+  auto obj = ace::tree::Object::build("var0");
+  obj->put(ace::tree::Primitive::build("var0", 1L));
+  obj->put(ace::tree::Primitive::build("var1", 2L));
+  root->put(obj);
+  auto array = ace::tree::Array::build("var1");
+  for (long i = 0; i < 4; i += 1) {
+    auto item = ace::tree::Object::build("");
+    item->put(ace::tree::Primitive::build("var0", i));
+    array->push_back(item);
+  }
+  root->put(array);
+  std::vector<std::string> paths = { "$..var0",     "$.var1[1,3].var0",
+                                     "$.var1[0:4:2]", "$.var0.*",
+                                     "$.var2",      "$..var1..var0" };
+  ace::tree::Query query;
+  for (auto const& p : paths) {
+    query.add(ace::tree::Path::parse(p));
+  }
+  ASSERT_EQ(query.size(), paths.size());
+  std::vector<size_t> counts(paths.size(), 0);
+  query.run(static_cast<ace::tree::Value const&>(*root),
+            [&](const size_t k, ace::tree::Value const& v) { counts[k] += 1; });
+  for (size_t k = 0; k < paths.size(); k += 1) {
+    ASSERT_EQ(counts[k], get(root, paths[k]));
+  }
+  ASSERT_EQ(counts[0], 6);
+  ASSERT_EQ(counts[1], 2);
+  ASSERT_EQ(counts[2], 2);
+  ASSERT_EQ(counts[3], 2);
+  ASSERT_EQ(counts[4], 0);
+  ASSERT_EQ(counts[5], 4);
+}
+
+TEST_F(Tree, PathCache)
+{
+  ace::tree::Path::clearCache();
+  auto a = ace::tree::Path::parse("$.a.b[0]..c");
+  auto b = ace::tree::Path::parse("$.a.b[0]..c");
+  ASSERT_EQ(a, b);
+  auto stats = ace::tree::Path::cacheStatistics();
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(stats.size, 1);
+  ace::tree::Path::setCacheCapacity(64);
+  for (long i = 0; i < 1024; i += 1) {
+    ace::tree::Path::parse("$.var" + std::to_string(i));
+  }
+  ASSERT_LE(ace::tree::Path::cacheStatistics().size, 64);
+  ace::tree::Path::setCacheCapacity(0);
+  ace::tree::Path::parse("$.a");
+  ace::tree::Path::parse("$.a");
+  stats = ace::tree::Path::cacheStatistics();
+  ASSERT_EQ(stats.hits, 0);
+  ASSERT_EQ(stats.size, 0);
+  ace::tree::Path::setCacheCapacity(4096);
+}
+
+TEST_F(Tree, ObjectFind)
+{
+  auto root = ace::tree::Object::build("");
+  root->put(ace::tree::Primitive::build("var0", 3.14));
+  ASSERT_NE(root->find("var0"), nullptr);
+  ASSERT_EQ(root->find("var0"), &root->get("var0"));
+  ASSERT_EQ(root->find("var1"), nullptr);
+}
+
+TEST_F(Tree, ObjectIndex)
+{
+  auto root = ace::tree::Object::build("");
+  for (long i = 255; i >= 0; i -= 1) {
+    std::string key = "var" + std::to_string(i);
+    root->put(ace::tree::Primitive::build(key, i));
+  }
+  root->put(ace::tree::Primitive::build("var0", -1L));
+  ASSERT_EQ(root->size(), 256);
+  std::string last;
+  for (auto const& e : *root) {
+    ASSERT_LT(last, e.first);
+    last = e.first;
+  }
+  for (long i = 1; i < 256; i += 1) {
+    std::string key = "var" + std::to_string(i);
+    auto const* p = static_cast<const ace::tree::Primitive*>(root->find(key));
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(p->value<long>(), i);
+  }
+  auto const& p = static_cast<ace::tree::Primitive const&>(root->get("var0"));
+  ASSERT_EQ(p.value<long>(), -1);
+  for (long i = 0; i < 250; i += 1) {
+    root->erase("var" + std::to_string(i));
+  }
+  ASSERT_EQ(root->size(), 6);
+  ASSERT_FALSE(root->has("var0"));
+  ASSERT_TRUE(root->has("var255"));
+  auto copy = std::static_pointer_cast<ace::tree::Object>(root->clone());
+  ASSERT_TRUE(copy->has("var250"));
+  ASSERT_EQ(copy->find("var249"), nullptr);
+}
+
+TEST_F(Tree, ObjectUnsorted)
+{
+  std::vector<long> keys;
+  for (long i = 0; i < 20000; i += 1) {
+    keys.push_back((i * 7919) % 20000);
+  }
+  ace::tree::Builder builder(true);
+  ASSERT_TRUE(builder.onObjectStart(""));
+  for (auto i : keys) {
+    ASSERT_TRUE(builder.onInteger("var" + std::to_string(i), i));
+  }
+  ASSERT_FALSE(builder.onInteger("var0", 0));
+  ASSERT_TRUE(builder.onEnd());
+  auto root = std::static_pointer_cast<ace::tree::Object>(builder.value());
+  ASSERT_NE(root, nullptr);
+  ASSERT_EQ(root->size(), 20000);
+  for (auto i : keys) {
+    auto const* p = root->find("var" + std::to_string(i));
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(static_cast<const ace::tree::Primitive*>(p)->value<long>(), i);
+  }
+  std::string last;
+  size_t count = 0;
+  for (auto const& e : *root) {
+    ASSERT_LT(last, e.first);
+    last = e.first;
+    count += 1;
+  }
+  ASSERT_EQ(count, 20000);
+}
+
+TEST_F(Tree, Symbol)
+{
+  std::vector<std::thread> workers;
+  std::vector<ace::common::Symbol> symbols(4);
+  for (size_t i = 0; i < symbols.size(); i += 1) {
+    workers.emplace_back([&symbols, i]() {
+      for (long j = 0; j < 1024; j += 1) {
+        ace::common::Symbol tmp("symbol" + std::to_string(j));
+      }
+      symbols[i] = ace::common::Symbol("symbol512");
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  size_t count = ace::common::Symbol::count();
+  for (auto const& s : symbols) {
+    ASSERT_EQ(s, symbols[0]);
+    ASSERT_EQ(s, "symbol512");
+    ASSERT_EQ(s.hash(), std::hash<std::string>()("symbol512"));
+  }
+  ASSERT_NE(symbols[0], ace::common::Symbol("symbol513"));
+  ASSERT_EQ(ace::common::Symbol::count(), count);
+  auto root = ace::tree::Object::build("");
+  root->put(ace::tree::Primitive::build("symbol512", 1L));
+  ASSERT_EQ(root->begin()->first, symbols[0]);
+  ASSERT_EQ(get(root, "$.symbol512"), 1);
+}
+
+TEST_F(Tree, SymbolRelease)
+{
+  size_t count = ace::common::Symbol::count();
+  {
+    auto root = ace::tree::Object::build("");
+    for (long i = 0; i < 1024; i += 1) {
+      root->put(ace::tree::Primitive::build("key" + std::to_string(i), i));
+    }
+    auto copy = root->clone();
+    ASSERT_EQ(ace::common::Symbol::count(), count + 1024);
+  }
+  ASSERT_EQ(ace::common::Symbol::count(), count);
+}
+
+TEST_F(Tree, Arena)
+{
+  ace::tree::Object::Ref root;
+  std::weak_ptr<ace::tree::Arena> arena;
+  {
+    ace::tree::Arena::Scope scope;
+    arena = ace::tree::Arena::current();
+    root = ace::tree::Object::build("");
+    auto array = ace::tree::Array::build("var1");
+    for (long i = 0; i < 1024; i += 1) {
+      array->push_back(ace::tree::Primitive::build("", i));
+    }
+    root->put(ace::tree::Primitive::build("var0", "hello"));
+    root->put(array);
+    root->put(ace::tree::Primitive::build("var2", std::string(256, 'x')));
+    ASSERT_GT(arena.lock()->capacity(), 0);
+  }
+  ASSERT_EQ(ace::tree::Arena::current(), nullptr);
+  ASSERT_FALSE(arena.expired());
+  auto const& p = static_cast<ace::tree::Primitive const&>(root->get("var0"));
+  ASSERT_EQ(p.value<std::string>(), "hello");
+  ASSERT_EQ(get(root, "$.var1[*]"), 1024);
+  auto copy = root->clone();
+  root.reset();
+  ASSERT_TRUE(arena.expired());
+  ASSERT_EQ(get(copy, "$.var1[*]"), 1024);
+  auto const& s = static_cast<ace::tree::Primitive const&>(copy->get("var2"));
+  ASSERT_EQ(s.value<std::string>(), std::string(256, 'x'));
+}
+
+TEST_F(Tree, PrimitiveStringify)
+{
+  auto ref = ace::tree::Primitive::build("", 42L);
+  auto copy = std::static_pointer_cast<ace::tree::Primitive>(ref->clone());
+  ASSERT_EQ(copy->value<long>(), 42);
+  ref->stringify();
+  ASSERT_TRUE(ref->is<std::string>());
+  ASSERT_EQ(ref->value<std::string>(), "42");
+}
+
+TEST_F(Tree, Builder)
+{
+  auto root = ace::tree::Object::build("");
+  root->put(ace::tree::Primitive::build("var0", 3.14));
+  root->put(ace::tree::Primitive::build("var1", "hello"));
+  auto array = ace::tree::Array::build("var2");
+  for (int i = 0; i < 4; i += 1) {
+    auto ini = ace::tree::Object::build("");
+    ini->put(ace::tree::Primitive::build("var0", 42L));
+    ini->put(ace::tree::Primitive::build("var1", true));
+    array->push_back(ini);
+  }
+  root->put(array);
+  ace::tree::Builder builder;
+  ASSERT_TRUE(ace::tree::Builder::emit(*root, builder));
+  auto copy = builder.value();
+  ASSERT_NE(copy, nullptr);
+  ASSERT_TRUE(copy->isObject());
+  ASSERT_EQ(get(copy, "$.var0"), 1);
+  ASSERT_EQ(get(copy, "$.var2[*]"), 4);
+  ASSERT_EQ(get(copy, "$.var2[3].var0"), 1);
+  auto const& p = static_cast<ace::tree::Primitive const&>(copy->get("var1"));
+  ASSERT_EQ(p.value<std::string>(), "hello");
+  ace::tree::Builder partial;
+  ASSERT_TRUE(partial.onObjectStart(""));
+  ASSERT_TRUE(partial.onInteger("var0", 1));
+  ASSERT_EQ(partial.value(), nullptr);
+  ASSERT_TRUE(partial.onEnd());
+  ASSERT_NE(partial.value(), nullptr);
+  ASSERT_FALSE(partial.onEnd());
+}
+
+TEST_F(Tree, JsonScanner)
+{
+  auto& scn = MASTER.scannerByName("json");
+  std::string doc = R"({ "a": "caf\u00e9\n", "b": [ 1, 2.5, true ], "c": {} })";
+  auto root = scn.parse(doc, 0, nullptr);
+  ASSERT_NE(root, nullptr);
+  auto const& a = static_cast<ace::tree::Primitive const&>(root->get("a"));
+  ASSERT_EQ(a.value<std::string>(), "caf\xc3\xa9\n");
+  ASSERT_EQ(get(root, "$.b[*]"), 3);
+  std::ostringstream oss;
+  scn.dump(*root, ace::tree::Scanner::Format::Compact, oss);
+  ASSERT_EQ(oss.str(),
+            R"({"a":"café\n","b":[1,2.5,true],"c":{}})");
+  ASSERT_EQ(scn.parse(R"({ "a": 1, "a": 2 })", 0, nullptr), nullptr);
+  ASSERT_EQ(scn.parse(R"({ "a": [ 1, 2 })", 0, nullptr), nullptr);
+  ASSERT_EQ(scn.parse(R"([ 1, 2 ])", 0, nullptr), nullptr);
+}
+
+TEST_F(Tree, JsonScannerWideObject)
+{
+  auto& scn = MASTER.scannerByName("json");
+  std::ostringstream oss;
+  oss << "{";
+  for (long i = 20000; i > 0; i -= 1) {
+    oss << (i == 20000 ? " " : ", ") << "\"k" << i << "\": " << i;
+  }
+  oss << " }";
+  auto root = scn.parse(oss.str(), 0, nullptr);
+  ASSERT_NE(root, nullptr);
+  ASSERT_EQ(get(root, "$.*"), 20000);
+  auto const& p = static_cast<ace::tree::Primitive const&>(root->get("k1234"));
+  ASSERT_EQ(p.value<long>(), 1234);
+  std::string dup = oss.str();
+  dup.replace(dup.size() - 1, 1, ", \"k7\": 0 }");
+  ASSERT_EQ(scn.parse(dup, 0, nullptr), nullptr);
+}
+
+TEST_F(Tree, YamlScannerAliases)
+{
+  if (not MASTER.hasScannerByName("yaml")) {
+    return;
+  }
+  auto& scn = MASTER.scannerByName("yaml");
+  std::string doc = "base: &base\n"
+                    "  name: common\n"
+                    "  list: &list [ 1, 2, &three 3 ]\n"
+                    "  nested: { deep: &deep { v: 4 } }\n"
+                    "copy: *base\n"
+                    "list: *list\n"
+                    "three: *three\n"
+                    "deeps: [ *deep, *deep ]\n"
+                    "text: &text hello\n"
+                    "again: *text\n";
+  auto root = scn.parse(doc, 0, nullptr);
+  ASSERT_NE(root, nullptr);
+  ASSERT_EQ(get(root, "$.copy.name"), 1);
+  ASSERT_EQ(get(root, "$.copy.list[*]"), 3);
+  ASSERT_EQ(get(root, "$.copy.nested.deep.v"), 1);
+  ASSERT_EQ(get(root, "$.list[*]"), 3);
+  ASSERT_EQ(get(root, "$.deeps[*].v"), 2);
+  auto const& t = static_cast<ace::tree::Primitive const&>(root->get("three"));
+  ASSERT_EQ(t.value<long>(), 3);
+  auto const& a = static_cast<ace::tree::Primitive const&>(root->get("again"));
+  ASSERT_EQ(a.value<std::string>(), "hello");
+  ASSERT_EQ(scn.parse("a: *missing\n", 0, nullptr), nullptr);
+}
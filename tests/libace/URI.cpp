@@ -23,6 +23,7 @@
 #include "Common.h"
 #include <ace/engine/Master.h>
 #include <ace/model/Model.h>
+#include <ace/types/IPv4.h>
 
 class URI : public ::testing::Test
 {
@@ -75,3 +76,26 @@ TEST_F(URI, Pass_Ok_All)
   auto svr = res->validate("uri/01_Ok.lua", 1, const_cast<char**>(&prgnam));
   ASSERT_NE(svr.get(), nullptr);
 }
+
+TEST_F(URI, IPv4Format)
+{
+  using Checker = ace::model::IPv4FormatChecker;
+  ASSERT_TRUE(Checker::isAddress("192.168.1.254"));
+  ASSERT_TRUE(Checker::isAddress("0.0.0.0"));
+  ASSERT_TRUE(Checker::isAddress("10.0.0.0/8", true));
+  ASSERT_FALSE(Checker::isAddress("10.0.0.0/8"));
+  ASSERT_FALSE(Checker::isAddress("10.0.0.0/33", true));
+  ASSERT_FALSE(Checker::isAddress("256.0.0.1"));
+  ASSERT_FALSE(Checker::isAddress("1.2.3"));
+  ASSERT_FALSE(Checker::isAddress("1.2.3.4."));
+  ASSERT_FALSE(Checker::isAddress("1.2.3.1234"));
+  ASSERT_TRUE(Checker::isHostName("www.google.com"));
+  ASSERT_TRUE(Checker::isHostName("localhost"));
+  ASSERT_FALSE(Checker::isHostName("1.2.3.300"));
+  ASSERT_FALSE(Checker::isHostName("-bad.com"));
+  ASSERT_FALSE(Checker::isHostName("bad-.com"));
+  ASSERT_FALSE(Checker::isHostName("bad..com"));
+  ASSERT_FALSE(Checker::isHostName("bad_name.com"));
+  ASSERT_TRUE(Checker::checkFormat("www.google.com"));
+  ASSERT_FALSE(Checker::checkFormat("300.1.1.1"));
+}
@@ -0,0 +1,3 @@
+config = {
+  t3 = 3
+}
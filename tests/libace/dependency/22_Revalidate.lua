@@ -0,0 +1,4 @@
+config = {
+  t2 = 2,
+  u = 1
+}
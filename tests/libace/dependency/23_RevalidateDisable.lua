@@ -0,0 +1,3 @@
+config = {
+  t0 = "on"
+}
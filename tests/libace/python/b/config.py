@@ -0,0 +1,13 @@
+import sys
+import time
+
+import helper
+
+# Hand the GIL over to the other configurations before reading the state.
+time.sleep(0.01)
+
+config = {
+    "argv": sys.argv[1:],
+    "helper": helper.NAME,
+    "path": sys.path[0],
+}
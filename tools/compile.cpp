@@ -23,6 +23,7 @@
 #include <ace/common/Arguments.h>
 #include <ace/common/Log.h>
 #include <ace/engine/Master.h>
+#include <ace/model/Image.h>
 #include <ace/model/Model.h>
 #include <tclap/CmdLine.h>
 #include <cassert>
@@ -51,6 +52,7 @@ try {
   VA<std::string> genA("o", "output", "Output directory", false, "", "string",
                        cmd);
   SA depA("D", "deps", "Generate dependencies", cmd);
+  SA binA("b", "binary", "Generate a binary model image", cmd);
   VA<std::string> dphA("F", "depfile", "Dependency file", false, "", "string",
                        cmd);
   UA<std::string> mdlA("model", "Model file name", true, "string", cmd);
@@ -115,6 +117,18 @@ try {
     }
     mdl->generateInterface(oPath);
     mdl->generateImplementation(oPath);
+    if (binA.isSet()) {
+      std::vector<std::string> elems;
+      ace::common::String::split(m, '/', elems);
+      std::string name = elems.rbegin()->substr(0, elems.rbegin()->find('.'));
+      name += std::string(".") + ace::model::Image::Extension;
+      ace::fs::Path imgPath = oPath / name;
+      std::ofstream img(imgPath.toString(), std::ios::binary);
+      if (img.fail() or not ace::model::Image::write(*mdl, img)) {
+        ACE_LOG(Error, "Cannot write model image \"", imgPath, "\"");
+        return -1;
+      }
+    }
     if (depA.isSet()) {
       std::set<std::string> deps;
       mdl->collectModelFileDependencies(deps);
@@ -24,6 +24,7 @@
 #include <ace/common/Log.h>
 #include <ace/engine/Master.h>
 #include <ace/filesystem/Path.h>
+#include <ace/model/Image.h>
 #include <ace/model/Model.h>
 #include <tclap/CmdLine.h>
 #include <iostream>
@@ -62,7 +63,12 @@ try {
   std::vector<ace::model::Model::Ref> models(mdlPath.getValue().size());
   ace::model::Model::Ref mdl;
   for (auto& m : mdlPath.getValue()) {
-    mdl = ace::model::Model::load(m);
+    std::string name = m;
+    if (ace::model::Image::isImage(m) and
+        not ace::model::Image::load(m, name)) {
+      return -1;
+    }
+    mdl = ace::model::Model::load(name);
     if (mdl == nullptr) {
       return -1;
     }
@@ -72,7 +78,7 @@ try {
   // Explain the model
 
   if (!optPath.isSet()) {
-    mdl->display(ace::model::Coach::Branch::Root);
+    mdl->display(std::cout, ace::model::Coach::Branch::Root);
   } else {
     ace::tree::Path path = ace::tree::Path::parse(optPath.getValue());
     if (!mdl->explain(path)) {
@@ -21,8 +21,13 @@
  */
 
 #include <ace/common/Log.h>
+#include <ace/engine/Master.h>
 #include <ace/tree/Path.h>
+#include <ace/tree/Query.h>
 #include <tclap/CmdLine.h>
+#include <iostream>
+#include <string>
+#include <vector>
 
 using SA = TCLAP::SwitchArg;
 template<typename T>
@@ -110,11 +115,38 @@ match(std::vector<std::string> const& paths)
   }
 }
 
+void
+query(std::vector<std::string> const& paths, std::string const& cfg, int argc,
+      char* argv[])
+{
+  if (not MASTER.hasScannerByExtension(cfg)) {
+    ACE_LOG(Error, "Unsupported configuration file format: ", cfg);
+    return;
+  }
+  auto root = MASTER.scannerByExtension(cfg).open(cfg, argc, argv);
+  if (root == nullptr) {
+    ACE_LOG(Error, "Cannot open configuration file \"", cfg, "\"");
+    return;
+  }
+  /**
+   * Evaluate all the paths in a single pass
+   */
+  Query q;
+  for (auto const& s : paths) {
+    q.add(Path::parse(s));
+  }
+  q.run(static_cast<Value const&>(*root), [&](const size_t k, Value const& v) {
+    std::cout << paths[k] << " -> " << v.path() << std::endl;
+  });
+}
+
 int
 main(int argc, char* argv[])
 try {
   TCLAP::CmdLine cmd("Advanced Configuration Path Checker", ' ', ACE_VERSION);
   SA cmpA("m", "match", "Match two paths", cmd);
+  VA<std::string> cfgA("c", "config", "Evaluate the paths on a configuration",
+                       false, "", "file", cmd);
   UA<std::string> pthA("path", "JSONPath", true, "string", cmd);
   cmd.parse(argc, argv);
   /**
@@ -127,6 +159,8 @@ try {
    */
   if (cmpA.isSet()) {
     match(pthA.getValue());
+  } else if (cfgA.isSet()) {
+    query(pthA.getValue(), cfgA.getValue(), argc, argv);
   } else {
     parse(pthA.getValue());
   }
@@ -22,13 +22,21 @@
 
 #include <ace/common/Arguments.h>
 #include <ace/common/Log.h>
+#include <ace/common/Resolver.h>
+#include <ace/engine/Context.h>
 #include <ace/engine/Master.h>
+#include <ace/model/Image.h>
 #include <ace/model/Model.h>
 #include <tclap/CmdLine.h>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 template<typename T>
@@ -39,6 +47,61 @@ template<typename T>
 using VA = TCLAP::ValueArg<T>;
 using SA = TCLAP::SwitchArg;
 
+namespace {
+
+struct Result
+{
+  bool valid = false;
+  size_t unexpected = 0;
+  double elapsed = 0.0;
+  std::string errors;
+};
+
+/**
+ * Validate a batch of configuration files on a pool of workers. Each worker
+ * validates its files on a private copy of the model and within its own
+ * validation context. The errors reported for a file are kept with its result.
+ */
+std::vector<Result>
+validateBatch(ace::model::Model const& mdl,
+              std::vector<std::string> const& cfgs, const size_t jobs,
+              const bool strict, int argc, char** argv)
+{
+  std::vector<Result> results(cfgs.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < cfgs.size(); i = next++) {
+      auto start = std::chrono::steady_clock::now();
+      ace::engine::Context context;
+      ace::engine::Context::Scope scope(context);
+      ace::common::Log::Capture capture;
+      ace::model::Model::Ref copy = mdl.clone();
+      auto const& cfgName = cfgs[i];
+      if (not MASTER.hasScannerByExtension(cfgName)) {
+        ACE_LOG(Error, "Unsupported configuration file format: ", cfgName);
+      } else if (copy->validate(cfgName, argc, argv) != nullptr) {
+        results[i].unexpected = context.unexpected().size();
+        results[i].valid = not strict or context.unexpected().empty();
+      }
+      std::chrono::duration<double, std::milli> delta =
+        std::chrono::steady_clock::now() - start;
+      results[i].elapsed = delta.count();
+      results[i].errors = capture.str();
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t i = 1; i < jobs and i < cfgs.size(); i += 1) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : pool) {
+    t.join();
+  }
+  return results;
+}
+
+}
+
 int
 main(int argc, char* argv[])
 try {
@@ -52,8 +115,16 @@ try {
   SA unexArg("x", "show-unexpected", "Show unexpected values (garbage)", cmd);
   SA verbArg("v", "verbose", "Show summary", cmd);
   SA stctArg("s", "strict", "Strict mode", cmd);
+  SA rslvArg("r", "resolve", "Resolve host names", cmd);
+  VA<long> tmoArg("t", "resolve-timeout", "Host name resolution timeout (ms)",
+                  false, 1000, "milliseconds", cmd);
+  SA lazyArg("l", "lazy-plugins", "Load plugin models on first use", cmd);
   VA<std::string> cfgPath("c", "config", "Configuration file", false, "",
                           "string", cmd);
+  MA<std::string> batchPath("b", "batch", "Configuration file (batch mode)",
+                            false, "string", cmd);
+  VA<size_t> jobsArg("j", "jobs", "Number of batch workers", false,
+                     std::thread::hardware_concurrency(), "unsigned", cmd);
   UA<std::string> mdlPath("models", "Model files", true, "string", cmd);
   cmd.parse(argc, nargv);
 
@@ -62,13 +133,21 @@ try {
   for (auto& p : libPath.getValue()) {
     MASTER.addModelDirectory(ace::fs::Path(p, true));
   }
+  ace::common::Resolver::get().setEnabled(rslvArg.isSet());
+  ace::common::Resolver::get().setTimeout(tmoArg.getValue());
+  MASTER.setLazyPlugins(lazyArg.isSet());
 
   // Load the models
 
   std::vector<ace::model::Model::Ref> models(mdlPath.getValue().size());
   ace::model::Model::Ref mdl;
   for (auto& m : mdlPath.getValue()) {
-    mdl = ace::model::Model::load(m);
+    std::string name = m;
+    if (ace::model::Image::isImage(m) and
+        not ace::model::Image::load(m, name)) {
+      return -1;
+    }
+    mdl = ace::model::Model::load(name);
     if (mdl == nullptr) {
       return -1;
     }
@@ -90,21 +169,21 @@ try {
       ACE_LOG(Error, "Invalid configuration file \"" + cfgName + "\"");
       return -1;
     }
-    if (stctArg.isSet() && !MASTER.unexpected().empty()) {
+    if (stctArg.isSet() && !CONTEXT.unexpected().empty()) {
       ACE_LOG(Error, "Strict checks failed");
       return -1;
     }
 
-    int filters = ace::engine::Master::Option::Relevant;
+    int filters = ace::engine::Context::Option::Relevant;
     if (optArg.isSet()) {
-      filters |= ace::engine::Master::Option::Undefined;
+      filters |= ace::engine::Context::Option::Undefined;
     }
     if (unexArg.isSet()) {
-      filters |= ace::engine::Master::Option::Unexpected;
+      filters |= ace::engine::Context::Option::Unexpected;
     }
 
     if (verbArg.isSet()) {
-      MASTER.summarize(std::cout, filters);
+      CONTEXT.summarize(std::cout, filters);
     }
     ACE_LOG(Warning, "*** Configuration file is VALID ***");
 
@@ -126,6 +205,39 @@ try {
     }
   }
 
+  // validate the batch of configuration files
+
+  if (batchPath.isSet()) {
+    auto const& cfgs = batchPath.getValue();
+    size_t jobs = jobsArg.getValue() == 0 ? 1 : jobsArg.getValue();
+    auto start = std::chrono::steady_clock::now();
+    auto results = validateBatch(*mdl, cfgs, jobs, stctArg.isSet(), argc, argv);
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    size_t valid = 0;
+    for (size_t i = 0; i < cfgs.size(); i += 1) {
+      auto const& r = results[i];
+      std::cout << (r.valid ? "VALID   " : "INVALID ") << cfgs[i] << " ("
+                << std::fixed << std::setprecision(3) << r.elapsed << " ms";
+      if (r.unexpected > 0) {
+        std::cout << ", " << r.unexpected << " unexpected";
+      }
+      std::cout << ")" << std::endl;
+      std::istringstream errors(r.errors);
+      for (std::string line; std::getline(errors, line);) {
+        std::cout << "  " << line << std::endl;
+      }
+      valid += r.valid ? 1 : 0;
+    }
+    std::cout << "[Summary] " << cfgs.size() << " files, " << valid
+              << " valid, " << cfgs.size() - valid << " invalid, " << jobs
+              << " workers, " << std::fixed << std::setprecision(3)
+              << elapsed.count() << " s" << std::endl;
+    if (valid != cfgs.size()) {
+      return -1;
+    }
+  }
+
   // Free the normalized arguments resource
 
   for (int i = 0; i < argc; i += 1) {
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2016 Xavier R. Guerin
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ace/common/Arguments.h>
+#include <ace/common/Log.h>
+#include <ace/engine/Master.h>
+#include <ace/engine/Server.h>
+#include <ace/model/Image.h>
+#include <ace/model/Model.h>
+#include <tclap/CmdLine.h>
+#include <csignal>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+template<typename T>
+using UA = TCLAP::UnlabeledMultiArg<T>;
+template<typename T>
+using MA = TCLAP::MultiArg<T>;
+template<typename T>
+using VA = TCLAP::ValueArg<T>;
+using SA = TCLAP::SwitchArg;
+
+namespace {
+
+ace::engine::Server* s_server = nullptr;
+
+void
+stop(int sig)
+{
+  if (s_server != nullptr) {
+    s_server->stop();
+  }
+}
+
+}
+
+int
+main(int argc, char* argv[])
+try {
+  char** nargv = ace::common::Arguments::normalize(argc, argv);
+  TCLAP::CmdLine cmd("Advanced Configuration Validation Daemon", ' ',
+                     ACE_VERSION);
+  MA<std::string> libPath("I", "include", "Model include path", false, "string",
+                          cmd);
+  VA<std::string> sockPath("S", "socket", "Socket path", false,
+                           "ace-validated.sock", "string", cmd);
+  SA lazyArg("l", "lazy-plugins", "Load plugin models on first use", cmd);
+  UA<std::string> mdlPath("models", "Model files", true, "string", cmd);
+  cmd.parse(argc, nargv);
+
+  // Update parameters
+
+  for (auto& p : libPath.getValue()) {
+    MASTER.addModelDirectory(ace::fs::Path(p, true));
+  }
+  MASTER.setLazyPlugins(lazyArg.isSet());
+
+  // Load the models
+
+  std::set<std::string> models;
+  for (auto& m : mdlPath.getValue()) {
+    std::string name = m;
+    if (ace::model::Image::isImage(m) and
+        not ace::model::Image::load(m, name)) {
+      return -1;
+    }
+    if (ace::model::Model::load(name) == nullptr) {
+      return -1;
+    }
+    models.insert(name);
+  }
+  ACE_LOG(Warning, "*** Models are VALID ***");
+
+  // Open the socket
+
+  ace::engine::Server server(argv[0], models);
+  std::string const& sp = sockPath.getValue();
+  if (not server.listen(sp)) {
+    return -1;
+  }
+
+  // Serve the requests
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = stop;
+  s_server = &server;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+  ACE_LOG(Warning, "*** Listening on \"", sp, "\" ***");
+  server.run();
+  signal(SIGINT, SIG_DFL);
+  signal(SIGTERM, SIG_DFL);
+  s_server = nullptr;
+
+  // Free the normalized arguments resource
+
+  for (int i = 0; i < argc; i += 1) {
+    free(nargv[i]);
+  }
+  free(nargv);
+
+  return 0;
+} catch (TCLAP::ArgException const& e) {
+  ACE_LOG(Error, e.error(), " for argument ", e.argId());
+  return -1;
+} catch (std::invalid_argument const& e) {
+  ACE_LOG(Error, "Invalid argument: ", e.what());
+  return -1;
+} catch (std::runtime_error const& e) {
+  ACE_LOG(Error, "Runtime error: ", e.what());
+  return -1;
+}